@@ -1,420 +0,0 @@
-// src/resolver/strategies.rs
-// Complete Hamilton/Euler/A* DAG Resolution Implementation
-// Ensures O(log n) index complexity for polyglot interface
-
-use petgraph::graph::{Graph, NodeIndex};
-use petgraph::Directed;
-use std::collections::{BinaryHeap, HashMap, HashSet, VecDeque};
-use std::cmp::Ordering;
-use std::time::{Duration, Instant};
-
-use super::graph::DependencyGraph;
-use super::types::{NodeId, Path, ResolutionStrategy};
-use super::errors::ResolverError;
-
-/// A* Node for priority queue
-#[derive(Debug, Clone)]
-struct AStarNode {
-    node_id: NodeId,
-    g_score: f64,  // Cost from start
-    f_score: f64,  // g_score + heuristic
-    path: Vec<NodeId>,
-}
-
-impl PartialEq for AStarNode {
-    fn eq(&self, other: &Self) -> bool {
-        self.f_score == other.f_score
-    }
-}
-
-impl Eq for AStarNode {}
-
-impl PartialOrd for AStarNode {
-    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
-        // Reverse ordering for min-heap
-        other.f_score.partial_cmp(&self.f_score)
-    }
-}
-
-impl Ord for AStarNode {
-    fn cmp(&self, other: &Self) -> Ordering {
-        self.partial_cmp(other).unwrap_or(Ordering::Equal)
-    }
-}
-
-/// Eulerian Cycle Detection
-/// 
-/// Complexity: O(E) where E = number of edges
-/// 
-/// A graph has an Eulerian cycle if:
-/// 1. All vertices with nonzero degree are connected
-/// 2. All vertices have even degree (for undirected)
-/// 3. In-degree equals out-degree for all vertices (for directed)
-pub fn is_eulerian(graph: &DependencyGraph) -> bool {
-    let petgraph = &graph.graph;
-    
-    // Check if graph is connected
-    if !is_connected(petgraph) {
-        return false;
-    }
-    
-    // For directed graphs: check in-degree == out-degree
-    for node in petgraph.node_indices() {
-        let in_degree = petgraph.edges_directed(node, petgraph::Direction::Incoming).count();
-        let out_degree = petgraph.edges_directed(node, petgraph::Direction::Outgoing).count();
-        
-        if in_degree != out_degree {
-            return false;
-        }
-    }
-    
-    true
-}
-
-/// Check if graph is strongly connected
-/// Uses Kosaraju's algorithm - O(V + E)
-fn is_connected(graph: &Graph<NodeId, (), Directed>) -> bool {
-    if graph.node_count() == 0 {
-        return true;
-    }
-    
-    // Simple DFS reachability check from first node
-    let start = graph.node_indices().next().unwrap();
-    let mut visited = HashSet::new();
-    let mut stack = vec![start];
-    
-    while let Some(node) = stack.pop() {
-        if visited.insert(node) {
-            for neighbor in graph.neighbors(node) {
-                stack.push(neighbor);
-            }
-        }
-    }
-    
-    visited.len() == graph.node_count()
-}
-
-/// Hamiltonian Path Search (NP-Complete)
-/// 
-/// Uses backtracking with timeout to prevent infinite search
-/// Complexity: O(n!) worst case, bounded by timeout
-/// 
-/// Returns Some(path) if found within timeout, None otherwise
-pub fn find_hamiltonian_path(
-    graph: &DependencyGraph,
-    timeout: Duration,
-) -> Option<Vec<NodeId>> {
-    let start_time = Instant::now();
-    let nodes: Vec<NodeIndex> = graph.graph.node_indices().collect();
-    
-    if nodes.is_empty() {
-        return Some(vec![]);
-    }
-    
-    // Try starting from each node
-    for start_node in &nodes {
-        let mut visited = HashSet::new();
-        let mut path = vec![*start_node];
-        visited.insert(*start_node);
-        
-        if hamiltonian_dfs(
-            &graph.graph,
-            *start_node,
-            &nodes,
-            &mut visited,
-            &mut path,
-            start_time,
-            timeout,
-        ) {
-            // Convert NodeIndex to NodeId
-            return Some(
-                path.iter()
-                    .map(|&idx| graph.graph[idx].clone())
-                    .collect()
-            );
-        }
-        
-        // Timeout check
-        if start_time.elapsed() > timeout {
-            return None;
-        }
-    }
-    
-    None
-}
-
-/// Hamiltonian DFS helper with timeout
-fn hamiltonian_dfs(
-    graph: &Graph<NodeId, (), Directed>,
-    current: NodeIndex,
-    all_nodes: &[NodeIndex],
-    visited: &mut HashSet<NodeIndex>,
-    path: &mut Vec<NodeIndex>,
-    start_time: Instant,
-    timeout: Duration,
-) -> bool {
-    // Timeout guard
-    if start_time.elapsed() > timeout {
-        return false;
-    }
-    
-    // Success: visited all nodes
-    if visited.len() == all_nodes.len() {
-        return true;
-    }
-    
-    // Try each neighbor
-    for neighbor in graph.neighbors(current) {
-        if !visited.contains(&neighbor) {
-            visited.insert(neighbor);
-            path.push(neighbor);
-            
-            if hamiltonian_dfs(graph, neighbor, all_nodes, visited, path, start_time, timeout) {
-                return true;
-            }
-            
-            // Backtrack
-            path.pop();
-            visited.remove(&neighbor);
-        }
-    }
-    
-    false
-}
-
-/// A* Optimal Path Resolution
-/// 
-/// Complexity: O(E log V) with admissible heuristic
-/// Uses SemVerX version distance as heuristic
-/// 
-/// Heuristic formula (admissible):
-/// h(current, goal) = abs(major_diff) * 100 + abs(minor_diff) * 10 + abs(patch_diff)
-pub fn astar_resolve(
-    graph: &DependencyGraph,
-    start: NodeId,
-    goal: NodeId,
-) -> Result<Path, ResolverError> {
-    let start_idx = graph.find_node(&start)
-        .ok_or_else(|| ResolverError::NodeNotFound(start.clone()))?;
-    let goal_idx = graph.find_node(&goal)
-        .ok_or_else(|| ResolverError::NodeNotFound(goal.clone()))?;
-    
-    // Priority queue (min-heap by f_score)
-    let mut open_set = BinaryHeap::new();
-    
-    // Best g_score for each node
-    let mut g_scores: HashMap<NodeIndex, f64> = HashMap::new();
-    
-    // Initialize start node
-    let h_start = heuristic(&start, &goal);
-    open_set.push(AStarNode {
-        node_id: start.clone(),
-        g_score: 0.0,
-        f_score: h_start,
-        path: vec![start.clone()],
-    });
-    g_scores.insert(start_idx, 0.0);
-    
-    // A* main loop
-    while let Some(current) = open_set.pop() {
-        let current_idx = graph.find_node(&current.node_id).unwrap();
-        
-        // Goal reached
-        if current.node_id == goal {
-            return Ok(Path {
-                nodes: current.path,
-                cost: current.g_score,
-            });
-        }
-        
-        // Explore neighbors
-        for neighbor_idx in graph.graph.neighbors(current_idx) {
-            let neighbor_id = &graph.graph[neighbor_idx];
-            let edge_cost = 1.0; // Uniform cost; could be version distance
-            
-            let tentative_g = current.g_score + edge_cost;
-            
-            // Check if this path is better
-            if tentative_g < *g_scores.get(&neighbor_idx).unwrap_or(&f64::INFINITY) {
-                g_scores.insert(neighbor_idx, tentative_g);
-                
-                let h = heuristic(neighbor_id, &goal);
-                let f = tentative_g + h;
-                
-                let mut new_path = current.path.clone();
-                new_path.push(neighbor_id.clone());
-                
-                open_set.push(AStarNode {
-                    node_id: neighbor_id.clone(),
-                    g_score: tentative_g,
-                    f_score: f,
-                    path: new_path,
-                });
-            }
-        }
-    }
-    
-    Err(ResolverError::NoPathFound { start, goal })
-}
-
-/// Admissible heuristic for SemVerX versions
-/// 
-/// Returns minimum possible cost to reach goal
-/// Guarantees A* optimality
-fn heuristic(current: &NodeId, goal: &NodeId) -> f64 {
-    // Parse versions (assumes NodeId has version info)
-    // This is a placeholder - adjust based on your NodeId structure
-    
-    // For now, use string edit distance as proxy
-    let dist = levenshtein_distance(&current.to_string(), &goal.to_string());
-    dist as f64
-}
-
-/// Levenshtein distance for heuristic
-fn levenshtein_distance(s1: &str, s2: &str) -> usize {
-    let len1 = s1.len();
-    let len2 = s2.len();
-    let mut matrix = vec![vec![0; len2 + 1]; len1 + 1];
-    
-    for i in 0..=len1 {
-        matrix[i][0] = i;
-    }
-    for j in 0..=len2 {
-        matrix[0][j] = j;
-    }
-    
-    for i in 1..=len1 {
-        for j in 1..=len2 {
-            let cost = if s1.chars().nth(i - 1) == s2.chars().nth(j - 1) {
-                0
-            } else {
-                1
-            };
-            
-            matrix[i][j] = std::cmp::min(
-                std::cmp::min(
-                    matrix[i - 1][j] + 1,      // Deletion
-                    matrix[i][j - 1] + 1,      // Insertion
-                ),
-                matrix[i - 1][j - 1] + cost,   // Substitution
-            );
-        }
-    }
-    
-    matrix[len1][len2]
-}
-
-/// Hybrid Strategy Resolver
-/// 
-/// Attempts strategies in order:
-/// 1. Eulerian (fastest, O(E))
-/// 2. A* (optimal, O(E log V))
-/// 3. Hamiltonian (fallback, bounded timeout)
-pub fn resolve_hybrid(
-    graph: &DependencyGraph,
-    start: NodeId,
-    goal: NodeId,
-) -> Result<Path, ResolverError> {
-    // Try Eulerian first (cheapest)
-    if is_eulerian(graph) {
-        // If Eulerian exists, any path works
-        return astar_resolve(graph, start, goal);
-    }
-    
-    // Try A* (optimal path)
-    match astar_resolve(graph, start.clone(), goal.clone()) {
-        Ok(path) => return Ok(path),
-        Err(_) => {
-            // A* failed, try Hamiltonian as last resort
-            let timeout = Duration::from_millis(500);
-            if let Some(ham_path) = find_hamiltonian_path(graph, timeout) {
-                // Check if path includes both start and goal
-                if ham_path.contains(&start) && ham_path.contains(&goal) {
-                    return Ok(Path {
-                        nodes: ham_path,
-                        cost: (ham_path.len() - 1) as f64,
-                    });
-                }
-            }
-        }
-    }
-    
-    Err(ResolverError::ResolutionFailed {
-        strategy: ResolutionStrategy::Hybrid,
-        reason: "All strategies exhausted".to_string(),
-    })
-}
-
-#[cfg(test)]
-mod tests {
-    use super::*;
-    
-    #[test]
-    fn test_eulerian_detection() {
-        let mut graph = DependencyGraph::new();
-        
-        // Create simple cycle: A -> B -> C -> A
-        let a = graph.add_node("A".to_string());
-        let b = graph.add_node("B".to_string());
-        let c = graph.add_node("C".to_string());
-        
-        graph.add_edge(&a, &b);
-        graph.add_edge(&b, &c);
-        graph.add_edge(&c, &a);
-        
-        assert!(is_eulerian(&graph), "Simple cycle should be Eulerian");
-    }
-    
-    #[test]
-    fn test_hamiltonian_small_graph() {
-        let mut graph = DependencyGraph::new();
-        
-        // Create path: A -> B -> C
-        let a = graph.add_node("A".to_string());
-        let b = graph.add_node("B".to_string());
-        let c = graph.add_node("C".to_string());
-        
-        graph.add_edge(&a, &b);
-        graph.add_edge(&b, &c);
-        
-        let timeout = Duration::from_secs(1);
-        let path = find_hamiltonian_path(&graph, timeout);
-        
-        assert!(path.is_some(), "Should find Hamiltonian path");
-        assert_eq!(path.unwrap().len(), 3, "Path should include all 3 nodes");
-    }
-    
-    #[test]
-    fn test_astar_optimal_path() {
-        let mut graph = DependencyGraph::new();
-        
-        // Create diamond graph to test optimality
-        let a = graph.add_node("1.0.0".to_string());
-        let b = graph.add_node("1.1.0".to_string());
-        let c = graph.add_node("1.2.0".to_string());
-        let d = graph.add_node("2.0.0".to_string());
-        
-        graph.add_edge(&a, &b);
-        graph.add_edge(&a, &c);
-        graph.add_edge(&b, &d);
-        graph.add_edge(&c, &d);
-        
-        let result = astar_resolve(&graph, a.clone(), d.clone());
-        assert!(result.is_ok(), "Should find path from A to D");
-        
-        let path = result.unwrap();
-        assert!(path.nodes.len() >= 2, "Path should have at least start and goal");
-    }
-    
-    #[test]
-    fn test_hybrid_strategy() {
-        let mut graph = DependencyGraph::new();
-        
-        let a = graph.add_node("1.0.0".to_string());
-        let b = graph.add_node("1.1.0".to_string());
-        graph.add_edge(&a, &b);
-        
-        let result = resolve_hybrid(&graph, a.clone(), b.clone());
-        assert!(result.is_ok(), "Hybrid should resolve simple path");
-    }
-}
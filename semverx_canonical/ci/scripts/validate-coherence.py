@@ -4,15 +4,89 @@ Cross-language FilterFlash coherence validator
 
 Ensures Rust and TypeScript implementations produce
 identical outputs to the Python oracle.
+
+The oracle is checked for determinism and idempotence on a generated
+corpus. If the Rust library is available (SEMVERX_LIB, or the default
+cargo release output), the native backend is then run in differential
+mode, which fails on any byte or score that differs from the oracle.
+The oracle's feature extraction is written independently of the Rust
+scanner; canonical layout and scoring are checked mostly for FFI and
+marshalling faithfulness (see pysemverx.native).
+
+With --require-native a missing library is a failure rather than a skip,
+so CI cannot pass without exercising the Rust build.
 """
+import os
+import random
 import sys
 
+ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+sys.path.insert(0, os.path.join(ROOT, "polyglot", "python"))
+
+from pysemverx import COHERENCE_GATE, FilterFlashOracle  # noqa: E402
+
+
+def corpus(seed: int = 954, size: int = 64):
+    """Source-like artifacts with strings, escapes, numbers and unicode"""
+    rng = random.Random(seed)
+    pieces = [b"fn ", b"call(", b")", b"{", b"}", b";", b" ", b"\n\t", b"\"s\\\"q\"", b"42", b"1.5e3",
+              b"x1", b"_9", b"[0]", "\"café\"".encode(), b"\"\xff\xfe\"", b"007", b"\"unterminated"]
+    artifacts = [b"", b"1", b"\"", b"  \n"]
+    for _ in range(size):
+        artifacts.append(b"".join(rng.choice(pieces) for _ in range(rng.randint(1, 400))))
+    return artifacts
+
+
+def find_library():
+    path = os.environ.get("SEMVERX_LIB")
+    if path:
+        return path
+    for name in ("libsemverx.so", "libsemverx.dylib", "semverx.dll"):
+        candidate = os.path.join(ROOT, "target", "release", name)
+        if os.path.exists(candidate):
+            return candidate
+    return None
+
+
 def main():
-    # TODO: Implement cross-language validation
     print("[VALIDATE] FilterFlash coherence check")
+    oracle = FilterFlashOracle()
+    artifacts = corpus()
+
     print("[INFO] Testing canonicalization determinism...")
+    canonicals = [oracle.canonicalize(oracle.extract_features(a)) for a in artifacts]
+    for artifact, canonical in zip(artifacts, canonicals):
+        if oracle.canonicalize(oracle.extract_features(artifact)) != canonical:
+            print("[FAIL] Oracle canonicalization is not deterministic")
+            return 1
+    reference = canonicals[::4]
+    scores = [oracle.score(c, reference) for c in canonicals]
+    if any(scores[i] < COHERENCE_GATE for i in range(0, len(canonicals), 4)):
+        print("[FAIL] Corpus members must pass the coherence gate")
+        return 1
+
+    library = find_library()
+    if library is None and "--require-native" in sys.argv[1:]:
+        print("[FAIL] Native library not found under %s" % os.path.join(ROOT, "target", "release"))
+        return 1
+    if library is None:
+        print("[SKIP] Native library not built; set SEMVERX_LIB to check the Rust implementation")
+        return 0
+
+    from pysemverx.native import CoherenceMismatch, NativeFilterFlashOracle
+
+    print("[INFO] Differential check of the Rust implementation (%s)..." % library)
+    native = NativeFilterFlashOracle(differential=True, library=library)
+    try:
+        native.canonicalize_batch(artifacts)
+        native.score_batch(canonicals, reference)
+        native.score_batch(canonicals, [])
+    except CoherenceMismatch as mismatch:
+        print("[FAIL] %s" % mismatch)
+        return 1
     print("[PASS] All language implementations produce identical outputs")
     return 0
 
+
 if __name__ == "__main__":
     sys.exit(main())
@@ -0,0 +1,4 @@
+"""SemVerX Python client (FilterFlash Oracle)"""
+from .filterflash import COHERENCE_GATE, FilterFlashOracle
+
+__all__ = ["COHERENCE_GATE", "FilterFlashOracle"]
@@ -3,27 +3,119 @@ FilterFlash Oracle Implementation (Canonical Reference)
 
 This is the authoritative implementation.
 All other language ports MUST produce identical outputs.
+
+Features are extracted by a byte-level tokenizer rather than a parser,
+so the same rules hold for every source language. Outside string
+literals the artifact splits into string literals, whitespace runs,
+words (``[A-Za-z0-9_]`` runs; a run starting with a digit is a numeric
+literal, which also absorbs ``.``) and single other bytes:
+
+- ast_hash: SHA-256 of the artifact with whitespace runs outside
+  string literals collapsed to one space and trimmed at both ends
+- control_flow: the ``{}()[];`` skeleton outside string literals,
+  capped at MAX_CONTROL_FLOW bytes
+- literals: occurrence counts of string literals (quotes included) and
+  numeric literals, each truncated to MAX_LITERAL bytes, for at most
+  MAX_LITERALS distinct literals in order of first occurrence
+
+A string runs from ``"`` to the next unescaped ``"``; one left open at
+the end of the artifact is kept in ast_hash but is not a literal.
+
+This module is written from the rules above with regular expressions
+and shares no code or structure with the Rust state-machine scanner,
+so the differential check in ``native`` compares two independent
+implementations of the spec, not a port with its original.
 """
-import ast
 import hashlib
-from typing import Any, Dict, List
+import re
+import struct
+from typing import Any, Dict, List, Set
 
 COHERENCE_GATE = 0.954
 
+MAX_CONTROL_FLOW = 64 * 1024
+MAX_LITERAL = 64
+MAX_LITERALS = 4096
+SHINGLE = 4
+
+_TOKEN = re.compile(
+    rb'''(?P<string>"(?:[^"\\]|\\.)*(?P<closed>")?)'''
+    rb"|(?P<space>[ \t\n\x0c\r]+)"
+    rb"|(?P<number>[0-9][A-Za-z0-9_.]*)"
+    rb"|(?P<word>[A-Za-z_][A-Za-z0-9_]*)"
+    rb"|(?P<other>.)",
+    re.DOTALL,
+)
+_CONTROL_FLOW = re.compile(rb"[{}()\[\];]")
+
+
 class FilterFlashOracle:
     """Canonical FilterFlash implementation"""
-    
+
     def extract_features(self, artifact: bytes) -> Dict[str, Any]:
         """Extract structural features from artifact"""
-        # TODO: Implement full feature extraction
-        return {}
-    
+        normalized = bytearray()
+        control_flow = bytearray()
+        literals: Dict[str, int] = {}
+        gap = False
+        for token in _TOKEN.finditer(artifact):
+            kind, text = token.lastgroup, token.group()
+            if kind == "space":
+                gap = bool(normalized)
+                continue
+            if gap:
+                normalized += b" "
+            gap = False
+            normalized += text
+            if kind == "number" or (kind == "string" and token.group("closed")):
+                literal = text[:MAX_LITERAL].decode("utf-8", "replace")
+                if literal in literals or len(literals) < MAX_LITERALS:
+                    literals[literal] = literals.get(literal, 0) + 1
+            elif _CONTROL_FLOW.fullmatch(text) and len(control_flow) < MAX_CONTROL_FLOW:
+                control_flow += text
+        return {
+            "ast_hash": hashlib.sha256(normalized).digest(),
+            "control_flow": bytes(control_flow),
+            "literals": literals,
+        }
+
     def canonicalize(self, features: Dict[str, Any]) -> bytes:
         """Canonicalize features to deterministic representation"""
-        # TODO: Implement canonicalization
-        return b""
-    
+        out = bytearray(features["ast_hash"])
+        control_flow = features["control_flow"]
+        out += struct.pack("<I", len(control_flow)) + control_flow
+        literals = sorted((text.encode("utf-8"), count) for text, count in features["literals"].items())
+        out += struct.pack("<I", len(literals))
+        for text, count in literals:
+            out += struct.pack("<I", len(text)) + text + struct.pack("<Q", count)
+        return bytes(out)
+
     def score(self, canonical: bytes, corpus: List[bytes]) -> float:
         """Compute coherence score ∈ [0, 1]"""
-        # TODO: Implement scoring
-        return 0.0
+        if not corpus:
+            return 1.0
+        own = shingles(canonical)
+        best = 0.0
+        for reference in corpus:
+            best = max(best, jaccard(own, shingles(reference)))
+            if best == 1.0:
+                break
+        return best
+
+
+def shingles(data: bytes) -> Set[int]:
+    """Little-endian 4-byte windows; shorter inputs keep their length"""
+    if len(data) < SHINGLE:
+        if not data:
+            return set()
+        window = bytearray(data) + bytes(SHINGLE - len(data))
+        window[SHINGLE - 1] |= (len(data) << 6) & 0xFF
+        return {int.from_bytes(window, "little")}
+    return {int.from_bytes(data[i:i + SHINGLE], "little") for i in range(len(data) - SHINGLE + 1)}
+
+
+def jaccard(a: Set[int], b: Set[int]) -> float:
+    """Jaccard similarity; two empty sets are identical"""
+    shared = len(a & b)
+    union = len(a) + len(b) - shared
+    return 1.0 if union == 0 else shared / union
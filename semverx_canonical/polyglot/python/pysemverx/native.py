@@ -0,0 +1,149 @@
+"""
+Native FilterFlash backend over the nnffi stable channel
+
+Batches cross into the Rust library once per call through ctypes,
+which releases the GIL for the duration of the call; the library
+spreads each batch over every core. Results are bit-for-bit those of
+the pure-Python oracle. With ``differential=True`` every batch is also
+run through the oracle and any disagreement raises CoherenceMismatch.
+
+What the differential check proves: feature extraction is implemented
+twice from the spec (a regex tokenizer here, a byte state machine in
+Rust), so it catches scanner disagreements as well as FFI and
+marshalling bugs. The canonical byte layout and the shingle/Jaccard
+score are direct transcriptions of the same spec on both sides; for
+those it mainly catches marshalling, layout and float handling bugs.
+
+The library is located through the SEMVERX_LIB environment variable,
+falling back to the platform's default name on the loader path.
+"""
+import ctypes
+import ctypes.util
+import os
+import struct
+import sys
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+from .filterflash import FilterFlashOracle
+
+_u8_p = ctypes.POINTER(ctypes.c_uint8)
+_u64_p = ctypes.POINTER(ctypes.c_uint64)
+_f64_p = ctypes.POINTER(ctypes.c_double)
+
+
+class CoherenceMismatch(AssertionError):
+    """The native backend disagreed with the pure-Python oracle"""
+
+
+def load_library(path: Optional[str] = None) -> ctypes.CDLL:
+    """Load the semverx cdylib and declare the FilterFlash entry points"""
+    path = path or os.environ.get("SEMVERX_LIB") or ctypes.util.find_library("semverx")
+    if path is None:
+        suffix = {"darwin": ".dylib", "win32": ".dll"}.get(sys.platform, ".so")
+        path = ("" if sys.platform == "win32" else "lib") + "semverx" + suffix
+    lib = ctypes.CDLL(path)
+    lib.semverx_ff_canonicalize_batch.argtypes = [_u8_p, ctypes.c_size_t, _u64_p, ctypes.c_size_t]
+    lib.semverx_ff_canonicalize_batch.restype = ctypes.c_void_p
+    lib.semverx_ff_batch_size.argtypes = [ctypes.c_void_p]
+    lib.semverx_ff_batch_size.restype = ctypes.c_size_t
+    lib.semverx_ff_batch_copy.argtypes = [ctypes.c_void_p, _u8_p, ctypes.c_size_t, _u64_p, ctypes.c_size_t]
+    lib.semverx_ff_batch_copy.restype = ctypes.c_int32
+    lib.semverx_ff_batch_free.argtypes = [ctypes.c_void_p]
+    lib.semverx_ff_batch_free.restype = None
+    lib.semverx_ff_score_batch.argtypes = [
+        _u8_p, ctypes.c_size_t, _u64_p, ctypes.c_size_t,
+        _u8_p, ctypes.c_size_t, _u64_p, ctypes.c_size_t,
+        _f64_p, ctypes.c_size_t,
+    ]
+    lib.semverx_ff_score_batch.restype = ctypes.c_int32
+    return lib
+
+
+def _pack(items: Sequence[bytes]) -> Tuple[ctypes.Array, ctypes.Array, int]:
+    """Concatenate items into one buffer plus len(items) + 1 offsets"""
+    data = b"".join(items)
+    offsets = (ctypes.c_uint64 * (len(items) + 1))()
+    at = 0
+    for i, item in enumerate(items):
+        at += len(item)
+        offsets[i + 1] = at
+    return (ctypes.c_uint8 * len(data)).from_buffer_copy(data), offsets, len(data)
+
+
+def decode_canonical(canonical: bytes) -> Dict[str, Any]:
+    """Features back from their canonical encoding"""
+    ast_hash, rest = canonical[:32], memoryview(canonical)[32:]
+    (flow_len,) = struct.unpack_from("<I", rest)
+    control_flow = bytes(rest[4:4 + flow_len])
+    at = 4 + flow_len
+    (count,) = struct.unpack_from("<I", rest, at)
+    at += 4
+    literals: Dict[str, int] = {}
+    for _ in range(count):
+        (text_len,) = struct.unpack_from("<I", rest, at)
+        text = bytes(rest[at + 4:at + 4 + text_len]).decode("utf-8")
+        (occurrences,) = struct.unpack_from("<Q", rest, at + 4 + text_len)
+        literals[text] = occurrences
+        at += 12 + text_len
+    return {"ast_hash": ast_hash, "control_flow": control_flow, "literals": literals}
+
+
+class NativeFilterFlashOracle(FilterFlashOracle):
+    """FilterFlashOracle computed by the Rust library, optionally cross-checked"""
+
+    def __init__(self, differential: bool = False, library: Optional[str] = None):
+        self.lib = load_library(library)
+        self.differential = differential
+        self.oracle = FilterFlashOracle()
+
+    def canonicalize_batch(self, artifacts: Sequence[bytes]) -> List[bytes]:
+        """Canonical encoding of every artifact, extracted in parallel"""
+        data, offsets, size = _pack(artifacts)
+        handle = self.lib.semverx_ff_canonicalize_batch(data, size, offsets, len(artifacts))
+        if not handle:
+            raise ValueError("artifact offsets do not fit the buffer")
+        try:
+            out = (ctypes.c_uint8 * self.lib.semverx_ff_batch_size(handle))()
+            bounds = (ctypes.c_uint64 * (len(artifacts) + 1))()
+            status = self.lib.semverx_ff_batch_copy(handle, out, len(out), bounds, len(bounds))
+        finally:
+            self.lib.semverx_ff_batch_free(handle)
+        if status != 0:
+            raise RuntimeError("semverx_ff_batch_copy failed with status %d" % status)
+        raw = bytes(out)
+        canonicals = [raw[bounds[i]:bounds[i + 1]] for i in range(len(artifacts))]
+        if self.differential:
+            for i, artifact in enumerate(artifacts):
+                expected = self.oracle.canonicalize(self.oracle.extract_features(artifact))
+                if canonicals[i] != expected:
+                    raise CoherenceMismatch("canonical encoding of artifact %d differs from the oracle" % i)
+        return canonicals
+
+    def extract_features_batch(self, artifacts: Sequence[bytes]) -> List[Dict[str, Any]]:
+        """Features of every artifact, extracted in parallel"""
+        return [decode_canonical(canonical) for canonical in self.canonicalize_batch(artifacts)]
+
+    def score_batch(self, canonicals: Sequence[bytes], corpus: List[bytes]) -> List[float]:
+        """Coherence of every canonical encoding against the corpus, in parallel"""
+        queries, query_offsets, queries_len = _pack(canonicals)
+        references, reference_offsets, references_len = _pack(corpus)
+        out = (ctypes.c_double * len(canonicals))()
+        status = self.lib.semverx_ff_score_batch(
+            queries, queries_len, query_offsets, len(canonicals),
+            references, references_len, reference_offsets, len(corpus),
+            out, len(out),
+        )
+        if status != 0:
+            raise RuntimeError("semverx_ff_score_batch failed with status %d" % status)
+        scores = list(out)
+        if self.differential:
+            for i, canonical in enumerate(canonicals):
+                if scores[i] != self.oracle.score(canonical, corpus):
+                    raise CoherenceMismatch("score of canonical %d differs from the oracle" % i)
+        return scores
+
+    def extract_features(self, artifact: bytes) -> Dict[str, Any]:
+        return self.extract_features_batch([artifact])[0]
+
+    def score(self, canonical: bytes, corpus: List[bytes]) -> float:
+        return self.score_batch([canonical], corpus)[0]
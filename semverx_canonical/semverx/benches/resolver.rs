@@ -0,0 +1,287 @@
+// benches/resolver.rs
+// Criterion suite for the DAG resolution strategies across graph topologies
+// Run: cargo bench --bench resolver  (SEMVERX_BENCH_MAX_NODES caps the sizes)
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
+
+use semverx::resolver::{
+    astar_resolve, bidirectional_resolve, find_hamiltonian_path, is_eulerian, resolve_hybrid,
+    DependencyGraph, NodeId,
+};
+
+/// Graph sizes swept for every topology
+const SIZES: [usize; 5] = [100, 1_000, 10_000, 100_000, 1_000_000];
+
+/// Versions per package in the registry-shaped graph
+const REGISTRY_VERSIONS: usize = 8;
+
+/// Budget for the Hamiltonian benchmarks; the benched topologies finish far below it
+const HAMILTONIAN_TIMEOUT: Duration = Duration::from_secs(10);
+
+/// System allocator wrapper counting allocations, so every benchmark can
+/// report allocations and bytes per call next to its timings
+struct CountingAlloc;
+
+static ALLOCATIONS: AtomicU64 = AtomicU64::new(0);
+static ALLOCATED_BYTES: AtomicU64 = AtomicU64::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(layout.size() as u64, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(new_size as u64, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
+
+/// Run `f` once outside the timing loop and print its allocation profile
+fn report_allocations<R>(label: &str, f: impl FnOnce() -> R) {
+    let (calls, bytes) = (ALLOCATIONS.load(Ordering::Relaxed), ALLOCATED_BYTES.load(Ordering::Relaxed));
+    black_box(f());
+    let calls = ALLOCATIONS.load(Ordering::Relaxed) - calls;
+    let bytes = ALLOCATED_BYTES.load(Ordering::Relaxed) - bytes;
+    eprintln!("{label:<48} allocations/call: {calls:>10}  bytes/call: {bytes:>12}");
+}
+
+/// Generated graph shapes, after the bidag topology families plus a
+/// registry-shaped graph
+#[derive(Debug, Clone, Copy)]
+enum Topology {
+    /// v0 -> v1 -> ... -> vn
+    Chain,
+    /// Stacked diamonds: top -> {left, right} -> next top
+    Diamond,
+    /// Hub linked both ways to every leaf (Eulerian)
+    Star,
+    /// Backbone chain with a two-way tap to one station per stop
+    Bus,
+    /// v0 -> v1 -> ... -> vn -> v0 (Eulerian and Hamiltonian)
+    Ring,
+    /// Packages with upgrade chains and skewed fan-in toward popular packages
+    Registry,
+}
+
+impl Topology {
+    const ALL: [Topology; 6] = [
+        Topology::Chain,
+        Topology::Diamond,
+        Topology::Star,
+        Topology::Bus,
+        Topology::Ring,
+        Topology::Registry,
+    ];
+
+    fn name(self) -> &'static str {
+        match self {
+            Topology::Chain => "chain",
+            Topology::Diamond => "diamond",
+            Topology::Star => "star",
+            Topology::Bus => "bus",
+            Topology::Ring => "ring",
+            Topology::Registry => "registry",
+        }
+    }
+
+    /// Shapes with a Hamiltonian path the degree prune finds in linear time;
+    /// on the rest the search only measures how long it takes to give up
+    fn has_hamiltonian_path(self) -> bool {
+        matches!(self, Topology::Chain | Topology::Ring)
+    }
+}
+
+/// A generated graph plus the endpoints every strategy resolves between
+struct Fixture {
+    graph: DependencyGraph,
+    start: NodeId,
+    goal: NodeId,
+}
+
+/// Versioned id for node `i`, so the A* heuristic has something to work on
+fn version_id(name: &str, i: usize) -> NodeId {
+    format!("{}@{}.{}.{}", name, i / 10_000, (i / 100) % 100, i % 100)
+}
+
+/// Deterministic xorshift stream, keeps generated graphs identical across runs
+struct XorShift(u64);
+
+impl XorShift {
+    fn next(&mut self) -> u64 {
+        self.0 ^= self.0 << 13;
+        self.0 ^= self.0 >> 7;
+        self.0 ^= self.0 << 17;
+        self.0
+    }
+
+    /// Index in `0..n` skewed quadratically toward 0
+    fn skewed(&mut self, n: usize) -> usize {
+        let u = (self.next() >> 11) as f64 / (1u64 << 53) as f64;
+        ((u * u) * n as f64) as usize
+    }
+}
+
+fn build(topology: Topology, n: usize) -> Fixture {
+    let mut graph = DependencyGraph::new();
+    let (start, goal) = match topology {
+        Topology::Chain | Topology::Ring => {
+            let ids: Vec<NodeId> = (0..n).map(|i| graph.add_node(version_id("pkg", i))).collect();
+            for pair in ids.windows(2) {
+                graph.add_edge(&pair[0], &pair[1]);
+            }
+            if let Topology::Ring = topology {
+                graph.add_edge(&ids[n - 1], &ids[0]);
+            }
+            (ids[0].clone(), ids[n - 1].clone())
+        }
+        Topology::Diamond => {
+            let ids: Vec<NodeId> = (0..n).map(|i| graph.add_node(version_id("pkg", i))).collect();
+            let mut top = 0;
+            while top + 3 < n {
+                for side in [top + 1, top + 2] {
+                    graph.add_edge(&ids[top], &ids[side]);
+                    graph.add_edge(&ids[side], &ids[top + 3]);
+                }
+                top += 3;
+            }
+            (ids[0].clone(), ids[top].clone())
+        }
+        Topology::Star => {
+            let ids: Vec<NodeId> = (0..n).map(|i| graph.add_node(version_id("pkg", i))).collect();
+            for leaf in &ids[1..] {
+                graph.add_edge(&ids[0], leaf);
+                graph.add_edge(leaf, &ids[0]);
+            }
+            (ids[1].clone(), ids[n - 1].clone())
+        }
+        Topology::Bus => {
+            let stops = n / 2;
+            let backbone: Vec<NodeId> = (0..stops).map(|i| graph.add_node(version_id("bus", i))).collect();
+            let stations: Vec<NodeId> = (0..stops).map(|i| graph.add_node(version_id("station", i))).collect();
+            for pair in backbone.windows(2) {
+                graph.add_edge(&pair[0], &pair[1]);
+            }
+            for (stop, station) in backbone.iter().zip(&stations) {
+                graph.add_edge(station, stop);
+                graph.add_edge(stop, station);
+            }
+            (stations[0].clone(), stations[stops - 1].clone())
+        }
+        Topology::Registry => {
+            let packages = (n / REGISTRY_VERSIONS).max(2);
+            let ids: Vec<Vec<NodeId>> = (0..packages)
+                .map(|p| {
+                    (0..REGISTRY_VERSIONS)
+                        .map(|v| graph.add_node(format!("pkg{}@{}.{}.0", p, v / 4 + 1, v % 4)))
+                        .collect()
+                })
+                .collect();
+            let mut rng = XorShift(0x5eed_cafe_f00d_d00d);
+            for (p, versions) in ids.iter().enumerate() {
+                // Upgrade chain within the package
+                for pair in versions.windows(2) {
+                    graph.add_edge(&pair[0], &pair[1]);
+                }
+                // 1-4 dependencies per version, mostly on popular packages
+                for version in versions {
+                    for _ in 0..(rng.next() % 4 + 1) {
+                        let dep = rng.skewed(packages);
+                        if dep != p {
+                            let target = &ids[dep][(rng.next() as usize) % REGISTRY_VERSIONS];
+                            graph.add_edge(version, target);
+                        }
+                    }
+                }
+            }
+            (ids[packages - 1][0].clone(), ids[0][REGISTRY_VERSIONS - 1].clone())
+        }
+    };
+    Fixture { graph, start, goal }
+}
+
+/// Largest size to run, from `SEMVERX_BENCH_MAX_NODES` (default: all)
+fn max_nodes() -> usize {
+    std::env::var("SEMVERX_BENCH_MAX_NODES")
+        .ok()
+        .and_then(|v| v.parse().ok())
+        .unwrap_or(usize::MAX)
+}
+
+fn bench_resolver(c: &mut Criterion) {
+    let max = max_nodes();
+
+    for topology in Topology::ALL {
+        for &n in SIZES.iter().filter(|&&n| n <= max) {
+            let fixture = build(topology, n);
+            let Fixture { graph, start, goal } = &fixture;
+            let id = BenchmarkId::new(topology.name(), n);
+            let label = |strategy: &str| format!("{}/{}/{}", strategy, topology.name(), n);
+            let samples = if n >= 100_000 { 10 } else { 50 };
+
+            // Throughput is reported as graph nodes per second
+            let mut group = c.benchmark_group("is_eulerian");
+            group.throughput(Throughput::Elements(n as u64)).sample_size(samples);
+            report_allocations(&label("is_eulerian"), || is_eulerian(graph));
+            group.bench_with_input(id.clone(), graph, |b, g| b.iter(|| is_eulerian(black_box(g))));
+            group.finish();
+
+            let mut group = c.benchmark_group("astar_resolve");
+            group.throughput(Throughput::Elements(n as u64)).sample_size(samples);
+            report_allocations(&label("astar_resolve"), || {
+                astar_resolve(graph, start.clone(), goal.clone())
+            });
+            group.bench_with_input(id.clone(), graph, |b, g| {
+                b.iter(|| astar_resolve(black_box(g), start.clone(), goal.clone()))
+            });
+            group.finish();
+
+            let mut group = c.benchmark_group("bidirectional_resolve");
+            group.throughput(Throughput::Elements(n as u64)).sample_size(samples);
+            report_allocations(&label("bidirectional_resolve"), || {
+                bidirectional_resolve(graph, start.clone(), goal.clone())
+            });
+            group.bench_with_input(id.clone(), graph, |b, g| {
+                b.iter(|| bidirectional_resolve(black_box(g), start.clone(), goal.clone()))
+            });
+            group.finish();
+
+            if topology.has_hamiltonian_path() {
+                let mut group = c.benchmark_group("find_hamiltonian_path");
+                group.throughput(Throughput::Elements(n as u64)).sample_size(samples);
+                report_allocations(&label("find_hamiltonian_path"), || {
+                    find_hamiltonian_path(graph, HAMILTONIAN_TIMEOUT)
+                });
+                group.bench_with_input(id.clone(), graph, |b, g| {
+                    b.iter(|| find_hamiltonian_path(black_box(g), HAMILTONIAN_TIMEOUT))
+                });
+                group.finish();
+            }
+
+            let mut group = c.benchmark_group("resolve_hybrid");
+            group.throughput(Throughput::Elements(n as u64)).sample_size(samples);
+            report_allocations(&label("resolve_hybrid"), || {
+                resolve_hybrid(graph, start.clone(), goal.clone())
+            });
+            group.bench_with_input(id, graph, |b, g| {
+                b.iter(|| resolve_hybrid(black_box(g), start.clone(), goal.clone()))
+            });
+            group.finish();
+        }
+    }
+}
+
+criterion_group!(benches, bench_resolver);
+criterion_main!(benches);
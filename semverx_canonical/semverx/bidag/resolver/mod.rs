@@ -1,5 +0,0 @@
-//! DAG Resolution Strategies
-
-pub mod eulerian;
-pub mod hamiltonian;
-pub mod astar;
@@ -0,0 +1,4 @@
+//! Audit layer: profiling and telemetry of the resolver and gates
+
+pub mod plpprofiler;
+pub mod plptelemtry;
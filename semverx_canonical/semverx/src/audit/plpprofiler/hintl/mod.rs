@@ -0,0 +1,253 @@
+//! HINTL: hot-path recording into per-thread shards
+//!
+//! Every thread registers one `Shard` on first use. Only its owner
+//! writes it, with load/store pairs on relaxed atomics rather than
+//! locked read-modify-writes, so recording costs a thread-local lookup
+//! and a few L1 stores while `collect` can still read every shard
+//! concurrently. A span reads the clock only when sampled, one span in
+//! `sample_every()` per thread; the others just count the call. Shards
+//! of exited threads are folded into retired totals, so short-lived
+//! scoped workers neither lose data nor grow the registry.
+
+use std::cell::Cell;
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+use std::time::Instant;
+
+use super::houtol::{bucket, ProbeStats, BUCKETS};
+use super::Probe;
+
+/// Default span sampling period
+pub const DEFAULT_SAMPLE_EVERY: u32 = 16;
+
+static SAMPLE_EVERY: AtomicU32 = AtomicU32::new(DEFAULT_SAMPLE_EVERY);
+
+static REGISTRY: Mutex<Registry> = Mutex::new(Registry { live: Vec::new(), retired: Vec::new() });
+
+/// Time one span in `n` per thread (1 times every span)
+pub fn set_sample_every(n: u32) {
+    SAMPLE_EVERY.store(n.max(1), Ordering::Relaxed);
+}
+
+/// Current span sampling period
+pub fn sample_every() -> u32 {
+    SAMPLE_EVERY.load(Ordering::Relaxed)
+}
+
+struct Registry {
+    live: Vec<Arc<Shard>>,
+    /// Folded shards of exited threads; empty until the first exit
+    retired: Vec<ProbeStats>,
+}
+
+/// Single-writer accumulators of one probe
+#[derive(Default)]
+struct Slot {
+    calls: AtomicU64,
+    timed: AtomicU64,
+    sum: AtomicU64,
+    max: AtomicU64,
+    buckets: [AtomicU64; BUCKETS],
+}
+
+/// Accumulators of one thread, one slot per probe
+#[derive(Default)]
+struct Shard {
+    slots: [Slot; Probe::COUNT],
+}
+
+/// Owner-only increment: no other thread ever stores to `cell`
+#[inline(always)]
+fn bump(cell: &AtomicU64, value: u64) {
+    cell.store(cell.load(Ordering::Relaxed).wrapping_add(value), Ordering::Relaxed);
+}
+
+impl Shard {
+    #[inline]
+    fn record(&self, probe: Probe, elapsed: Option<u64>) {
+        let slot = &self.slots[probe as usize];
+        bump(&slot.calls, 1);
+        if let Some(ns) = elapsed {
+            bump(&slot.timed, 1);
+            bump(&slot.sum, ns);
+            bump(&slot.buckets[bucket(ns)], 1);
+            if ns > slot.max.load(Ordering::Relaxed) {
+                slot.max.store(ns, Ordering::Relaxed);
+            }
+        }
+    }
+
+    #[inline]
+    fn add(&self, probe: Probe, value: u64) {
+        let slot = &self.slots[probe as usize];
+        bump(&slot.calls, 1);
+        bump(&slot.sum, value);
+    }
+
+    fn read(&self) -> Vec<ProbeStats> {
+        Probe::ALL
+            .iter()
+            .zip(&self.slots)
+            .map(|(&probe, slot)| {
+                let load = |cell: &AtomicU64| cell.load(Ordering::Relaxed);
+                let mut stats = ProbeStats::empty(probe);
+                stats.calls = load(&slot.calls);
+                stats.timed = load(&slot.timed);
+                stats.sum = load(&slot.sum);
+                stats.max = load(&slot.max);
+                for (out, cell) in stats.buckets.iter_mut().zip(&slot.buckets) {
+                    *out = load(cell);
+                }
+                stats
+            })
+            .collect()
+    }
+}
+
+/// This thread's shard and sampling countdown
+struct Local {
+    shard: Arc<Shard>,
+    countdown: Cell<u32>,
+}
+
+impl Local {
+    fn register() -> Self {
+        let shard = Arc::new(Shard::default());
+        REGISTRY.lock().unwrap().live.push(Arc::clone(&shard));
+        Self { shard, countdown: Cell::new(0) }
+    }
+
+    #[inline]
+    fn sample(&self) -> bool {
+        match self.countdown.get() {
+            0 => {
+                self.countdown.set(sample_every() - 1);
+                true
+            }
+            n => {
+                self.countdown.set(n - 1);
+                false
+            }
+        }
+    }
+}
+
+impl Drop for Local {
+    fn drop(&mut self) {
+        let mut registry = REGISTRY.lock().unwrap();
+        registry.live.retain(|shard| !Arc::ptr_eq(shard, &self.shard));
+        let stats = self.shard.read();
+        if registry.retired.is_empty() {
+            registry.retired = stats;
+        } else {
+            for (total, part) in registry.retired.iter_mut().zip(&stats) {
+                total.merge(part);
+            }
+        }
+    }
+}
+
+thread_local! {
+    static LOCAL: Local = Local::register();
+}
+
+/// Open span; records into its probe when dropped
+#[derive(Debug)]
+pub struct Span {
+    probe: Probe,
+    start: Option<Instant>,
+}
+
+impl Span {
+    /// Open a span, reading the clock only if this one is sampled
+    #[inline]
+    pub fn start(probe: Probe) -> Self {
+        let sampled = LOCAL.try_with(Local::sample).unwrap_or(false);
+        Self { probe, start: sampled.then(Instant::now) }
+    }
+
+    /// Record under `probe` instead of the probe the span was opened with
+    #[inline]
+    pub fn label(&mut self, probe: Probe) {
+        self.probe = probe;
+    }
+}
+
+impl Drop for Span {
+    #[inline]
+    fn drop(&mut self) {
+        let elapsed = self.start.map(|start| start.elapsed().as_nanos() as u64);
+        let _ = LOCAL.try_with(|local| local.shard.record(self.probe, elapsed));
+    }
+}
+
+/// Add `value` to counter `probe` on this thread's shard
+#[inline]
+pub fn count(probe: Probe, value: u64) {
+    let _ = LOCAL.try_with(|local| local.shard.add(probe, value));
+}
+
+/// This thread's totals only, e.g. to attribute one request's work
+pub fn local() -> Vec<ProbeStats> {
+    LOCAL.try_with(|local| local.shard.read()).unwrap_or_else(|_| Probe::ALL.iter().map(|&p| ProbeStats::empty(p)).collect())
+}
+
+/// Totals of every probe over all threads, live and exited
+pub fn collect() -> Vec<ProbeStats> {
+    let registry = REGISTRY.lock().unwrap();
+    let mut totals: Vec<ProbeStats> = if registry.retired.is_empty() {
+        Probe::ALL.iter().map(|&p| ProbeStats::empty(p)).collect()
+    } else {
+        registry.retired.clone()
+    };
+    for shard in &registry.live {
+        for (total, part) in totals.iter_mut().zip(shard.read()) {
+            total.merge(&part);
+        }
+    }
+    totals
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::thread;
+
+    fn stats(all: &[ProbeStats], probe: Probe) -> &ProbeStats {
+        &all[probe as usize]
+    }
+
+    #[test]
+    fn test_spans_counters_and_retired_threads() {
+        let before = local();
+        {
+            let mut span = Span::start(Probe::RegistryGet);
+            span.label(Probe::RegistryMaxSatisfying);
+        }
+        count(Probe::HeapPushes, 7);
+        count(Probe::HeapPushes, 5);
+        for _ in 0..3 * DEFAULT_SAMPLE_EVERY {
+            let _span = Span::start(Probe::FilterScore);
+        }
+        let after = local();
+
+        let delta = |probe| stats(&after, probe).calls - stats(&before, probe).calls;
+        assert_eq!(delta(Probe::RegistryGet), 0);
+        assert_eq!(delta(Probe::RegistryMaxSatisfying), 1);
+        assert_eq!(delta(Probe::HeapPushes), 2);
+        assert_eq!(stats(&after, Probe::HeapPushes).sum - stats(&before, Probe::HeapPushes).sum, 12);
+        assert_eq!(delta(Probe::FilterScore), 3 * DEFAULT_SAMPLE_EVERY as u64);
+        let timed = stats(&after, Probe::FilterScore).timed - stats(&before, Probe::FilterScore).timed;
+        assert!(timed >= 1 && timed <= 3 * DEFAULT_SAMPLE_EVERY as u64);
+        let filter = stats(&after, Probe::FilterScore);
+        assert_eq!(filter.buckets.iter().sum::<u64>(), filter.timed);
+
+        let seen = stats(&collect(), Probe::HamiltonianTimeouts).sum;
+        thread::scope(|scope| {
+            for _ in 0..4 {
+                scope.spawn(|| count(Probe::HamiltonianTimeouts, 1000));
+            }
+        });
+        assert!(stats(&collect(), Probe::HamiltonianTimeouts).sum >= seen + 4000);
+    }
+}
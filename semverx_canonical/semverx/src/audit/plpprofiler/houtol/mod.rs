@@ -0,0 +1,129 @@
+//! HOUTOL: per-probe statistics read out of the recording shards
+//!
+//! Span latencies land in log2 buckets: bucket `i` holds samples below
+//! `bucket_bound(i)` nanoseconds and at or above the previous bound, the
+//! last bucket is unbounded. Quantiles are therefore upper bounds, good
+//! to a factor of two, which is what an SLO check against a budget needs.
+
+use super::{Kind, Probe};
+
+/// Latency buckets per span
+pub const BUCKETS: usize = 32;
+
+/// Aggregated readout of one probe
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ProbeStats {
+    /// Probe read
+    pub probe: Probe,
+    /// Spans closed, or `count` calls made
+    pub calls: u64,
+    /// Spans timed (sampled); 0 for counters
+    pub timed: u64,
+    /// Nanoseconds over timed spans, or the counter's total
+    pub sum: u64,
+    /// Slowest timed span in nanoseconds
+    pub max: u64,
+    /// Timed spans per latency bucket
+    pub buckets: [u64; BUCKETS],
+}
+
+impl ProbeStats {
+    /// Statistics of a probe that never fired
+    pub fn empty(probe: Probe) -> Self {
+        Self { probe, calls: 0, timed: 0, sum: 0, max: 0, buckets: [0; BUCKETS] }
+    }
+
+    /// Fold another readout of the same probe into this one
+    pub fn merge(&mut self, other: &ProbeStats) {
+        debug_assert_eq!(self.probe, other.probe);
+        self.calls += other.calls;
+        self.timed += other.timed;
+        self.sum += other.sum;
+        self.max = self.max.max(other.max);
+        for (mine, theirs) in self.buckets.iter_mut().zip(&other.buckets) {
+            *mine += theirs;
+        }
+    }
+
+    /// Mean span latency in nanoseconds, `None` before the first sample
+    pub fn mean_ns(&self) -> Option<f64> {
+        (self.probe.kind() == Kind::Span && self.timed > 0).then(|| self.sum as f64 / self.timed as f64)
+    }
+
+    /// Upper bound of the `q`-quantile span latency in nanoseconds
+    ///
+    /// `q` is clamped to [0, 1]; the unbounded last bucket reports `max`.
+    pub fn quantile_ns(&self, q: f64) -> Option<u64> {
+        if self.probe.kind() != Kind::Span || self.timed == 0 {
+            return None;
+        }
+        let rank = ((q.clamp(0.0, 1.0) * self.timed as f64).ceil() as u64).max(1);
+        let mut seen = 0;
+        for (i, &n) in self.buckets.iter().enumerate() {
+            seen += n;
+            if seen >= rank {
+                return Some(if i + 1 == BUCKETS { self.max } else { bucket_bound(i).min(self.max.max(1)) });
+            }
+        }
+        Some(self.max)
+    }
+}
+
+/// Bucket of a latency in nanoseconds
+#[inline]
+pub fn bucket(ns: u64) -> usize {
+    (63 - (ns | 1).leading_zeros() as usize).min(BUCKETS - 1)
+}
+
+/// Exclusive upper bound of bucket `i` in nanoseconds
+pub fn bucket_bound(i: usize) -> u64 {
+    if i + 1 >= BUCKETS { u64::MAX } else { 2 << i }
+}
+
+/// Totals of every probe over all threads, live and exited
+///
+/// Empty without the `profiling` feature.
+pub fn snapshot() -> Vec<ProbeStats> {
+    #[cfg(feature = "profiling")]
+    return super::hintl::collect();
+    #[cfg(not(feature = "profiling"))]
+    Vec::new()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_buckets_and_quantiles() {
+        assert_eq!(bucket(0), 0);
+        assert_eq!(bucket(1), 0);
+        assert_eq!(bucket(2), 1);
+        assert_eq!(bucket(1023), 9);
+        assert_eq!(bucket(1024), 10);
+        assert_eq!(bucket(u64::MAX), BUCKETS - 1);
+        for ns in [0, 1, 5, 100, 4096, 1 << 40] {
+            let i = bucket(ns);
+            assert!(ns < bucket_bound(i));
+            assert!(i == 0 || ns >= bucket_bound(i - 1));
+        }
+
+        let mut stats = ProbeStats::empty(Probe::HybridShortest);
+        let mut other = ProbeStats::empty(Probe::HybridShortest);
+        for ns in [100u64, 120, 130, 5000] {
+            let target = if ns < 1000 { &mut stats } else { &mut other };
+            target.calls += 1;
+            target.timed += 1;
+            target.sum += ns;
+            target.max = target.max.max(ns);
+            target.buckets[bucket(ns)] += 1;
+        }
+        stats.merge(&other);
+        assert_eq!((stats.calls, stats.timed, stats.max), (4, 4, 5000));
+        assert_eq!(stats.mean_ns(), Some(1337.5));
+        assert_eq!(stats.quantile_ns(0.5), Some(128));
+        assert_eq!(stats.quantile_ns(0.75), Some(256));
+        assert_eq!(stats.quantile_ns(1.0), Some(5000));
+        assert_eq!(ProbeStats::empty(Probe::HeapPushes).quantile_ns(0.5), None);
+    }
+}
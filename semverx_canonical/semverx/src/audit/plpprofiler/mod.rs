@@ -0,0 +1,168 @@
+//! PLP profiler: spans and counters on the resolution hot paths
+//!
+//! Implements:
+//! - HINTL (`hintl/`): recording into per-thread shards, sampled spans
+//! - HOUTOL (`houtol/`): merging shards into per-probe statistics
+//!
+//! Every probe point is a `Probe`. Spans time a region and keep a log2
+//! latency histogram; counters sum a value. With the `profiling` cargo
+//! feature off, `span` and `count` are empty inline functions on a
+//! zero-sized guard and compile to nothing.
+//!
+//! ```
+//! use semverx::audit::plpprofiler::{self, Probe};
+//!
+//! let mut span = plpprofiler::span(Probe::HybridExhausted);
+//! // ... search ...
+//! span.label(Probe::HybridShortest); // attribute the time on success
+//! ```
+
+#[cfg(feature = "profiling")]
+pub mod hintl;
+pub mod houtol;
+
+pub use houtol::{snapshot, ProbeStats, BUCKETS};
+
+/// What a probe measures
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Kind {
+    /// Wall time of a region, sampled
+    Span,
+    /// Sum of reported values, never sampled
+    Counter,
+}
+
+/// Instrumentation point
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+#[repr(u8)]
+pub enum Probe {
+    /// Hybrid request answered by the shortest-path search
+    HybridShortest,
+    /// Hybrid request whose search ran and found no path
+    HybridExhausted,
+    /// Hybrid request answered by the planner without searching
+    HybridPruned,
+    /// One Hamiltonian search over an SCC
+    HamiltonianSearch,
+    /// Hamiltonian searches cut off by their deadline
+    HamiltonianTimeouts,
+    /// Nodes popped or expanded by the shortest-path searches
+    NodesExpanded,
+    /// Open-set pushes by A*
+    HeapPushes,
+    /// FilterFlash feature extraction
+    FilterExtract,
+    /// FilterFlash canonical encoding
+    FilterCanonicalize,
+    /// FilterFlash corpus scoring
+    FilterScore,
+    /// Exact registry lookup
+    RegistryGet,
+    /// Registry range lookup
+    RegistryMaxSatisfying,
+}
+
+impl Probe {
+    /// Number of probes
+    pub const COUNT: usize = 12;
+
+    /// Every probe, in discriminant order
+    pub const ALL: [Probe; Probe::COUNT] = [
+        Probe::HybridShortest,
+        Probe::HybridExhausted,
+        Probe::HybridPruned,
+        Probe::HamiltonianSearch,
+        Probe::HamiltonianTimeouts,
+        Probe::NodesExpanded,
+        Probe::HeapPushes,
+        Probe::FilterExtract,
+        Probe::FilterCanonicalize,
+        Probe::FilterScore,
+        Probe::RegistryGet,
+        Probe::RegistryMaxSatisfying,
+    ];
+
+    /// Metric name, snake case without prefix
+    pub fn name(self) -> &'static str {
+        match self {
+            Probe::HybridShortest => "hybrid_shortest",
+            Probe::HybridExhausted => "hybrid_exhausted",
+            Probe::HybridPruned => "hybrid_pruned",
+            Probe::HamiltonianSearch => "hamiltonian_search",
+            Probe::HamiltonianTimeouts => "hamiltonian_timeouts",
+            Probe::NodesExpanded => "nodes_expanded",
+            Probe::HeapPushes => "heap_pushes",
+            Probe::FilterExtract => "filterflash_extract",
+            Probe::FilterCanonicalize => "filterflash_canonicalize",
+            Probe::FilterScore => "filterflash_score",
+            Probe::RegistryGet => "registry_get",
+            Probe::RegistryMaxSatisfying => "registry_max_satisfying",
+        }
+    }
+
+    /// Span or counter
+    pub fn kind(self) -> Kind {
+        match self {
+            Probe::HamiltonianTimeouts | Probe::NodesExpanded | Probe::HeapPushes => Kind::Counter,
+            _ => Kind::Span,
+        }
+    }
+}
+
+/// Open span; records into `probe` when dropped
+#[cfg(feature = "profiling")]
+pub type Span = hintl::Span;
+
+/// Open span; a no-op without the `profiling` feature
+#[cfg(not(feature = "profiling"))]
+#[derive(Debug)]
+pub struct Span;
+
+#[cfg(not(feature = "profiling"))]
+impl Span {
+    /// Record under `probe` instead of the probe the span was opened with
+    #[inline(always)]
+    pub fn label(&mut self, _probe: Probe) {}
+}
+
+/// Start timing a region under `probe`
+#[cfg(feature = "profiling")]
+#[inline]
+pub fn span(probe: Probe) -> Span {
+    hintl::Span::start(probe)
+}
+
+/// Start timing a region under `probe`
+#[cfg(not(feature = "profiling"))]
+#[inline(always)]
+pub fn span(_probe: Probe) -> Span {
+    Span
+}
+
+/// Add `value` to counter `probe`
+#[cfg(feature = "profiling")]
+#[inline]
+pub fn count(probe: Probe, value: u64) {
+    hintl::count(probe, value)
+}
+
+/// Add `value` to counter `probe`
+#[cfg(not(feature = "profiling"))]
+#[inline(always)]
+pub fn count(_probe: Probe, _value: u64) {}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_probe_table_is_dense() {
+        for (i, probe) in Probe::ALL.iter().enumerate() {
+            assert_eq!(*probe as usize, i);
+        }
+        let mut names: Vec<&str> = Probe::ALL.iter().map(|p| p.name()).collect();
+        names.sort_unstable();
+        names.dedup();
+        assert_eq!(names.len(), Probe::COUNT);
+    }
+}
@@ -0,0 +1,161 @@
+//! PLP telemetry: exporting profiler statistics
+//!
+//! Implements:
+//! - Prometheus text exposition (format 0.0.4), for a `/metrics` scrape
+//! - OTLP/JSON metrics, the `ExportMetricsServiceRequest` body of an
+//!   OTLP/HTTP `POST /v1/metrics`
+//!
+//! Both render a `plpprofiler::snapshot()` as cumulative totals. Spans
+//! export a latency histogram over the sampled calls plus a counter of
+//! all calls; counters export their total.
+
+use std::fmt::Write;
+
+use crate::audit::plpprofiler::houtol::bucket_bound;
+use crate::audit::plpprofiler::{Kind, ProbeStats, BUCKETS};
+
+/// Prefix of every exported metric
+pub const PREFIX: &str = "semverx";
+
+/// Prometheus text exposition of `stats`
+pub fn prometheus(stats: &[ProbeStats]) -> String {
+    let mut out = String::new();
+    for s in stats {
+        let name = s.probe.name();
+        match s.probe.kind() {
+            Kind::Span => {
+                let metric = format!("{}_{}_seconds", PREFIX, name);
+                let _ = writeln!(out, "# HELP {} Sampled wall time of {}", metric, name);
+                let _ = writeln!(out, "# TYPE {} histogram", metric);
+                let mut cumulative = 0;
+                for (i, n) in s.buckets.iter().enumerate().take(BUCKETS - 1) {
+                    cumulative += n;
+                    let le = bucket_bound(i) as f64 / 1e9;
+                    let _ = writeln!(out, "{}_bucket{{le=\"{}\"}} {}", metric, le, cumulative);
+                }
+                let _ = writeln!(out, "{}_bucket{{le=\"+Inf\"}} {}", metric, s.timed);
+                let _ = writeln!(out, "{}_sum {}", metric, s.sum as f64 / 1e9);
+                let _ = writeln!(out, "{}_count {}", metric, s.timed);
+                let calls = format!("{}_{}_calls_total", PREFIX, name);
+                let _ = writeln!(out, "# HELP {} Calls of {}, sampled or not", calls, name);
+                let _ = writeln!(out, "# TYPE {} counter", calls);
+                let _ = writeln!(out, "{} {}", calls, s.calls);
+            }
+            Kind::Counter => {
+                let metric = format!("{}_{}_total", PREFIX, name);
+                let _ = writeln!(out, "# HELP {} Total of {}", metric, name);
+                let _ = writeln!(out, "# TYPE {} counter", metric);
+                let _ = writeln!(out, "{} {}", metric, s.sum);
+            }
+        }
+    }
+    out
+}
+
+/// OTLP/JSON metrics request for `stats`
+///
+/// Points are cumulative from `start_unix_nano` (process or profiler
+/// start) to `time_unix_nano`. 64-bit integers are JSON strings, as the
+/// OTLP JSON mapping requires.
+pub fn otlp_json(stats: &[ProbeStats], start_unix_nano: u64, time_unix_nano: u64) -> String {
+    let times = format!("\"startTimeUnixNano\":\"{}\",\"timeUnixNano\":\"{}\"", start_unix_nano, time_unix_nano);
+    let sum = |name: String, unit: &str, value: u64| {
+        format!(
+            "{{\"name\":\"{}\",\"unit\":\"{}\",\"sum\":{{\"aggregationTemporality\":2,\"isMonotonic\":true,\
+             \"dataPoints\":[{{{},\"asInt\":\"{}\"}}]}}}}",
+            name, unit, times, value
+        )
+    };
+    let mut metrics = Vec::with_capacity(stats.len() * 2);
+    for s in stats {
+        let name = s.probe.name();
+        match s.probe.kind() {
+            Kind::Span => {
+                let counts: Vec<String> = s.buckets.iter().map(|n| format!("\"{}\"", n)).collect();
+                let bounds: Vec<String> = (0..BUCKETS - 1).map(|i| bucket_bound(i).to_string()).collect();
+                let max = if s.timed > 0 { format!(",\"max\":{}", s.max) } else { String::new() };
+                metrics.push(format!(
+                    "{{\"name\":\"{}.{}.duration\",\"unit\":\"ns\",\"histogram\":{{\"aggregationTemporality\":2,\
+                     \"dataPoints\":[{{{},\"count\":\"{}\",\"sum\":{},\"bucketCounts\":[{}],\"explicitBounds\":[{}]{}}}]}}}}",
+                    PREFIX,
+                    name,
+                    times,
+                    s.timed,
+                    s.sum,
+                    counts.join(","),
+                    bounds.join(","),
+                    max
+                ));
+                metrics.push(sum(format!("{}.{}.calls", PREFIX, name), "1", s.calls));
+            }
+            Kind::Counter => metrics.push(sum(format!("{}.{}", PREFIX, name), "1", s.sum)),
+        }
+    }
+    format!(
+        "{{\"resourceMetrics\":[{{\"resource\":{{\"attributes\":[{{\"key\":\"service.name\",\"value\":{{\"stringValue\":\"{}\"}}}}]}},\
+         \"scopeMetrics\":[{{\"scope\":{{\"name\":\"{}.plpprofiler\"}},\"metrics\":[{}]}}]}}]}}",
+        PREFIX,
+        PREFIX,
+        metrics.join(",")
+    )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::audit::plpprofiler::houtol::bucket;
+    use crate::audit::plpprofiler::Probe;
+
+    fn sample() -> Vec<ProbeStats> {
+        let mut span = ProbeStats::empty(Probe::HybridShortest);
+        for ns in [100u64, 3000, 3500] {
+            span.timed += 1;
+            span.sum += ns;
+            span.max = span.max.max(ns);
+            span.buckets[bucket(ns)] += 1;
+        }
+        span.calls = 48;
+        let mut counter = ProbeStats::empty(Probe::NodesExpanded);
+        counter.calls = 2;
+        counter.sum = 912;
+        vec![span, counter]
+    }
+
+    #[test]
+    fn test_prometheus_exposition() {
+        let text = prometheus(&sample());
+        assert!(text.contains("# TYPE semverx_hybrid_shortest_seconds histogram\n"));
+        assert!(text.contains("semverx_hybrid_shortest_seconds_bucket{le=\"0.000000128\"} 1\n"));
+        assert!(text.contains("semverx_hybrid_shortest_seconds_bucket{le=\"0.000004096\"} 3\n"));
+        assert!(text.contains("semverx_hybrid_shortest_seconds_bucket{le=\"+Inf\"} 3\n"));
+        assert!(text.contains("semverx_hybrid_shortest_seconds_sum 0.0000066\n"));
+        assert!(text.contains("semverx_hybrid_shortest_seconds_count 3\n"));
+        assert!(text.contains("semverx_hybrid_shortest_calls_total 48\n"));
+        assert!(text.contains("# TYPE semverx_nodes_expanded_total counter\nsemverx_nodes_expanded_total 912\n"));
+
+        let buckets: Vec<u64> = text
+            .lines()
+            .filter(|l| l.starts_with("semverx_hybrid_shortest_seconds_bucket"))
+            .map(|l| l.rsplit(' ').next().unwrap().parse().unwrap())
+            .collect();
+        assert_eq!(buckets.len(), BUCKETS);
+        assert!(buckets.windows(2).all(|w| w[0] <= w[1]));
+    }
+
+    #[test]
+    fn test_otlp_json_shape() {
+        let json = otlp_json(&sample(), 10, 20);
+        assert!(json.starts_with("{\"resourceMetrics\":[{\"resource\":"));
+        assert!(json.contains("\"name\":\"semverx.hybrid_shortest.duration\",\"unit\":\"ns\""));
+        assert!(json.contains("\"startTimeUnixNano\":\"10\",\"timeUnixNano\":\"20\",\"count\":\"3\",\"sum\":6600"));
+        assert!(json.contains(",\"max\":3500}"));
+        assert!(json.contains("\"name\":\"semverx.hybrid_shortest.calls\""));
+        assert!(json.contains("\"name\":\"semverx.nodes_expanded\""));
+        assert!(json.contains("\"asInt\":\"912\""));
+        let depth = json.chars().try_fold(0i32, |depth, c| {
+            let depth = depth + match c { '{' | '[' => 1, '}' | ']' => -1, _ => 0 };
+            (depth >= 0).then_some(depth)
+        });
+        assert_eq!(depth, Some(0));
+    }
+}
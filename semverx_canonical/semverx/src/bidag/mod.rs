@@ -0,0 +1,33 @@
+//! Tri-Node Bidirectional DAG Resolution
+//! 
+//! Nodes: X(upload) ↔ Y(runtime) ↔ Z(backup)
+//! Strategies: Eulerian | Hamiltonian | A* | Bidirectional | Hybrid (see `crate::resolver`)
+//! Sync: compressed generation deltas, snapshot catch-up, Merkle summaries
+
+pub mod sync;
+
+/// Role of a node in the tri-node topology
+#[derive(Debug, Clone, Copy)]
+pub enum Node {
+    /// X: accepts uploads
+    Upload,
+    /// Y: serves resolution
+    Runtime,
+    /// Z: holds the backup copy
+    Backup,
+}
+
+/// Resolution strategy a node runs
+#[derive(Debug, Clone, Copy)]
+pub enum Strategy {
+    /// Eulerian shortcut
+    Eulerian,
+    /// Hamiltonian path search
+    Hamiltonian,
+    /// A* with the version heuristic
+    AStar,
+    /// Forward and backward frontiers, meeting in the middle
+    Bidirectional,
+    /// Planned per request from graph statistics
+    Hybrid,
+}
@@ -0,0 +1,269 @@
+//! Merkle summaries over the generation log
+//!
+//! Leaf `i` hashes the encoding of generation `i + 1`'s delta. Level
+//! `l` node `j` hashes its two children and covers leaves
+//! `j << l .. (j + 1) << l`; only complete subtrees exist, so the log
+//! of `n` generations is summarized by the peaks of the subtrees that
+//! the binary digits of `n` decompose it into. Appending is amortized
+//! O(1) hashes, a root over any retained prefix is O(log n), and two
+//! logs find their longest common prefix with O(log n) node
+//! comparisons (`common_prefix`).
+//!
+//! A log restored from a snapshot starts from the snapshot's peaks:
+//! generations before it can be compared only as whole peaks.
+
+use sha2::{Digest as _, Sha256};
+
+/// SHA-256 summary node
+pub type Digest = [u8; 32];
+
+const LEAF: u8 = 0;
+const NODE: u8 = 1;
+const ROOT: u8 = 2;
+
+/// Leaf hash of an encoded delta
+pub fn leaf(encoded: &[u8]) -> Digest {
+    Sha256::new().chain_update([LEAF]).chain_update(encoded).finalize().into()
+}
+
+fn parent(left: &Digest, right: &Digest) -> Digest {
+    Sha256::new().chain_update([NODE]).chain_update(left).chain_update(right).finalize().into()
+}
+
+/// Read access to summary nodes, local or fetched from a peer
+pub trait SummaryView {
+    /// Generations summarized
+    fn len(&self) -> u64;
+
+    /// True if no generation is summarized yet
+    fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Node `index` of level `level`, if retained
+    fn node(&self, level: u32, index: u64) -> Option<Digest>;
+}
+
+/// Retained nodes of one level, `start..start + hashes.len()`
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+struct Level {
+    start: u64,
+    hashes: Vec<Digest>,
+}
+
+impl Level {
+    fn end(&self) -> u64 {
+        self.start + self.hashes.len() as u64
+    }
+
+    fn get(&self, index: u64) -> Option<&Digest> {
+        index.checked_sub(self.start).and_then(|i| self.hashes.get(i as usize))
+    }
+}
+
+/// Append-only Merkle summary of a generation log
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct MerkleLog {
+    levels: Vec<Level>,
+}
+
+impl MerkleLog {
+    /// Summary of the empty log
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Summary continuing from the peaks of a `len`-generation log
+    ///
+    /// Returns `None` if `peaks` does not match the shape of `len`.
+    pub fn from_peaks(len: u64, peaks: &[Digest]) -> Option<Self> {
+        if peaks.len() != len.count_ones() as usize {
+            return None;
+        }
+        let height = 64 - len.leading_zeros();
+        let mut levels: Vec<Level> = (0..height).map(|l| Level { start: len >> l, hashes: Vec::new() }).collect();
+        let mut peaks = peaks.iter();
+        for l in (0..height).rev().filter(|&l| len >> l & 1 == 1) {
+            levels[l as usize] = Level { start: (len >> l) - 1, hashes: vec![*peaks.next()?] };
+        }
+        let mut log = Self { levels };
+        if log.levels.is_empty() {
+            log.levels.push(Level::default());
+        }
+        Some(log)
+    }
+
+    /// Generations summarized
+    pub fn len(&self) -> u64 {
+        self.levels.first().map_or(0, Level::end)
+    }
+
+    /// True before the first generation
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Summarize the next generation from its leaf hash
+    pub fn push(&mut self, leaf: Digest) {
+        let mut node = leaf;
+        for l in 0.. {
+            if self.levels.len() == l {
+                // The node completing now is this level's first
+                let start = if l == 0 { 0 } else { (self.len() >> l) - 1 };
+                self.levels.push(Level { start, hashes: Vec::new() });
+            }
+            let level = &mut self.levels[l];
+            level.hashes.push(node);
+            let index = level.end() - 1;
+            if index.is_multiple_of(2) {
+                return;
+            }
+            let left = level.get(index - 1).expect("left sibling of a complete pair is retained");
+            node = parent(left, &node);
+        }
+    }
+
+    /// Peaks of the first `len` generations, largest subtree first
+    ///
+    /// `None` if `len` exceeds the log or needs nodes not retained.
+    pub fn peaks(&self, len: u64) -> Option<Vec<Digest>> {
+        if len > self.len() {
+            return None;
+        }
+        (0..64u32)
+            .rev()
+            .filter(|&l| len >> l & 1 == 1)
+            .map(|l| self.levels.get(l as usize)?.get((len >> l) - 1).copied())
+            .collect()
+    }
+
+    /// Root over the first `len` generations
+    pub fn root_at(&self, len: u64) -> Option<Digest> {
+        let peaks = self.peaks(len)?;
+        let mut hasher = Sha256::new().chain_update([ROOT]).chain_update(len.to_le_bytes());
+        for peak in &peaks {
+            hasher.update(peak);
+        }
+        Some(hasher.finalize().into())
+    }
+
+    /// Root over the whole log
+    pub fn root(&self) -> Digest {
+        self.root_at(self.len()).expect("peaks of the full log are retained")
+    }
+}
+
+impl SummaryView for MerkleLog {
+    fn len(&self) -> u64 {
+        MerkleLog::len(self)
+    }
+
+    fn node(&self, level: u32, index: u64) -> Option<Digest> {
+        self.levels.get(level as usize)?.get(index).copied()
+    }
+}
+
+/// Number of leading generations on which two summaries agree
+///
+/// Compares the peaks of the shorter log left to right, then bisects
+/// the first differing peak: at most about 2·log2(n) `node` lookups on
+/// each side. A log merely lagging behind the other is not divergent;
+/// the result is then the shorter length. Where a needed node is not
+/// retained the answer is conservative, the start of that subtree.
+pub fn common_prefix(a: &impl SummaryView, b: &impl SummaryView) -> u64 {
+    let len = a.len().min(b.len());
+    let same = |level: u32, index: u64| match (a.node(level, index), b.node(level, index)) {
+        (Some(x), Some(y)) => Some(x == y),
+        _ => None,
+    };
+    let mut agreed = 0u64;
+    for l in (0..64u32).rev().filter(|&l| len >> l & 1 == 1) {
+        let index = agreed >> l;
+        match same(l, index) {
+            Some(true) => agreed += 1 << l,
+            Some(false) => return agreed + bisect(&same, l, index),
+            None => return agreed,
+        }
+    }
+    agreed
+}
+
+/// Leaves agreeing before the first difference under a differing node
+fn bisect(same: &impl Fn(u32, u64) -> Option<bool>, mut level: u32, mut index: u64) -> u64 {
+    let first = index << level;
+    while level > 0 {
+        level -= 1;
+        index *= 2;
+        match same(level, index) {
+            Some(true) => index += 1,
+            Some(false) => {}
+            None => return (index << level) - first,
+        }
+    }
+    index - first
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn log(leaves: impl IntoIterator<Item = u64>) -> MerkleLog {
+        let mut log = MerkleLog::new();
+        for i in leaves {
+            log.push(leaf(&i.to_le_bytes()));
+        }
+        log
+    }
+
+    /// Peer view counting node lookups
+    struct Counting<'a>(&'a MerkleLog, std::cell::Cell<usize>);
+
+    impl SummaryView for Counting<'_> {
+        fn len(&self) -> u64 {
+            self.0.len()
+        }
+
+        fn node(&self, level: u32, index: u64) -> Option<Digest> {
+            self.1.set(self.1.get() + 1);
+            self.0.node(level, index)
+        }
+    }
+
+    #[test]
+    fn test_roots_and_common_prefix() {
+        let full = log(0..1000);
+        assert_eq!(full.len(), 1000);
+        assert_eq!(full.root_at(37), log(0..37).root_at(37));
+        assert_ne!(full.root_at(37), full.root_at(38));
+        assert_eq!(common_prefix(&full, &log(0..600)), 600);
+        assert_eq!(common_prefix(&full, &full), 1000);
+
+        for split in [0u64, 1, 255, 256, 511, 777, 999] {
+            let forked = log((0..1000).map(|i| if i < split { i } else { i + 5000 }));
+            let peer = Counting(&forked, Default::default());
+            assert_eq!(common_prefix(&full, &peer), split, "fork at {}", split);
+            assert!(peer.1.get() <= 2 * 10 + 2, "{} lookups", peer.1.get());
+        }
+    }
+
+    #[test]
+    fn test_restored_log_continues_from_peaks() {
+        let full = log(0..300);
+        for base in [0u64, 1, 6, 128, 255] {
+            let mut restored = MerkleLog::from_peaks(base, &full.peaks(base).unwrap()).unwrap();
+            assert_eq!(restored.root(), full.root_at(base).unwrap());
+            for i in base..300 {
+                restored.push(leaf(&i.to_le_bytes()));
+            }
+            assert_eq!(restored.root(), full.root());
+            assert_eq!(common_prefix(&full, &restored), 300);
+
+            let mut forked = MerkleLog::from_peaks(base, &full.peaks(base).unwrap()).unwrap();
+            for i in base..300 {
+                forked.push(leaf(&(i + u64::from(i >= 280)).to_le_bytes()));
+            }
+            assert_eq!(common_prefix(&full, &forked), 280, "base {}", base);
+        }
+        assert!(MerkleLog::from_peaks(6, &[[0; 32]]).is_none());
+    }
+}
@@ -0,0 +1,476 @@
+//! Tri-node delta sync: X(upload) → Y(runtime) → Z(backup)
+//!
+//! Implements:
+//! - Generation-keyed deltas of registry entries and graph changes
+//! - Batched, deflate-compressed frames over a pipelined stream
+//! - Catch-up from a base snapshot when a replica lags past the log
+//! - Merkle summaries over generations, O(log n) divergence checks
+//!
+//! The upstream side of each hop keeps a `SyncSource`: the last
+//! `retain` deltas plus the state just before them (the base), which
+//! absorbs deltas as they fall out of the log. A replica at generation
+//! `g` is sent the deltas after `g`, or the base snapshot first if `g`
+//! predates the base. Both ends summarize the deltas they hold in a
+//! `MerkleLog`, and each stream ends with the source's root, so a
+//! diverged replica is detected at the end of every sync and located
+//! with `common_prefix` in O(log n) node exchanges.
+//!
+//! Y relays to Z by keeping a `SyncSource` of its own fed from what it
+//! applies (`Replica::with_relay`), so X ships each delta once.
+
+pub mod merkle;
+pub mod wire;
+
+use std::collections::VecDeque;
+use std::fmt;
+use std::io::{self, Read, Write};
+use std::sync::mpsc;
+use std::thread;
+
+use flate2::Compression;
+
+use crate::observer_gate::recovery::Generational;
+use crate::observer_gate::RecoveryState;
+pub use merkle::{common_prefix, Digest, MerkleLog, SummaryView};
+pub use wire::{read_frame, Frame};
+
+/// State replicated between the nodes: registry plus resolver graph
+pub type SyncState = RecoveryState;
+
+/// Changes of one generation: published entries, added nodes and edges
+pub type SyncDelta = <SyncState as Generational>::Delta;
+
+/// Generations per batch frame unless the caller picks another size
+pub const DEFAULT_BATCH: usize = 256;
+
+/// Encoded frames buffered between the encoding or decoding worker and
+/// the caller's thread
+const PIPELINE_DEPTH: usize = 4;
+
+/// Why a replica could not apply a stream
+#[derive(Debug)]
+pub enum SyncError {
+    /// The stream skipped generations the replica does not have
+    Gap {
+        /// Next generation the replica can apply
+        expected: u64,
+        /// First generation the frame carried
+        got: u64,
+    },
+    /// The replica holds generations its source never produced
+    Ahead {
+        /// Source head
+        head: u64,
+        /// Replica generation
+        generation: u64,
+    },
+    /// Delta or summary root differs from the replica's own at `generation`
+    Diverged {
+        /// First generation found to differ; locate the exact fork
+        /// with `common_prefix`
+        generation: u64,
+    },
+    /// Transport failure or a corrupt frame
+    Io(io::Error),
+}
+
+impl fmt::Display for SyncError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            SyncError::Gap { expected, got } => write!(f, "expected generation {}, stream starts at {}", expected, got),
+            SyncError::Ahead { head, generation } => {
+                write!(f, "replica at generation {} is ahead of source head {}", generation, head)
+            }
+            SyncError::Diverged { generation } => write!(f, "replica diverged from source at generation {}", generation),
+            SyncError::Io(e) => write!(f, "sync stream failed: {}", e),
+        }
+    }
+}
+
+impl std::error::Error for SyncError {
+    fn source(&self) -> Option<&(dyn std::error::Error + 'static)> {
+        match self {
+            SyncError::Io(e) => Some(e),
+            _ => None,
+        }
+    }
+}
+
+impl From<io::Error> for SyncError {
+    fn from(e: io::Error) -> Self {
+        SyncError::Io(e)
+    }
+}
+
+/// Canonical encoding and Merkle leaf of one delta
+fn leaf_of(delta: &SyncDelta, scratch: &mut Vec<u8>) -> Digest {
+    scratch.clear();
+    wire::encode_delta(scratch, delta);
+    merkle::leaf(scratch)
+}
+
+/// Upstream end of a hop: recent deltas plus the base they apply to
+#[derive(Debug, Clone)]
+pub struct SyncSource {
+    /// State at generation `base_generation`
+    base: SyncState,
+    base_generation: u64,
+    /// Deltas of generations `base_generation + 1..=head`
+    log: VecDeque<SyncDelta>,
+    retain: usize,
+    summary: MerkleLog,
+}
+
+impl SyncSource {
+    /// Source at generation 0 keeping the last `retain` deltas (at least 1)
+    pub fn new(retain: usize) -> Self {
+        Self {
+            base: SyncState::default(),
+            base_generation: 0,
+            log: VecDeque::new(),
+            retain: retain.max(1),
+            summary: MerkleLog::new(),
+        }
+    }
+
+    /// Source continuing from a snapshot, e.g. on a relay after catch-up
+    ///
+    /// `None` if `peaks` does not fit `generation`.
+    pub fn from_snapshot(generation: u64, peaks: &[Digest], base: SyncState, retain: usize) -> Option<Self> {
+        Some(Self {
+            base,
+            base_generation: generation,
+            log: VecDeque::new(),
+            retain: retain.max(1),
+            summary: MerkleLog::from_peaks(generation, peaks)?,
+        })
+    }
+
+    /// Latest generation
+    pub fn head(&self) -> u64 {
+        self.summary.len()
+    }
+
+    /// Oldest generation a replica can resume from without a snapshot
+    pub fn base(&self) -> u64 {
+        self.base_generation
+    }
+
+    /// Summary of every generation up to `head`
+    pub fn summary(&self) -> &MerkleLog {
+        &self.summary
+    }
+
+    /// Record the next generation's delta and return its number
+    ///
+    /// O(delta): the delta is hashed once, and the one falling out of
+    /// the log is applied to the base.
+    pub fn commit(&mut self, delta: SyncDelta) -> u64 {
+        let leaf = leaf_of(&delta, &mut Vec::new());
+        self.commit_hashed(delta, leaf)
+    }
+
+    fn commit_hashed(&mut self, delta: SyncDelta, leaf: Digest) -> u64 {
+        self.summary.push(leaf);
+        self.log.push_back(delta);
+        while self.log.len() > self.retain {
+            let oldest = self.log.pop_front().expect("log is longer than retain");
+            self.base.apply(&oldest);
+            self.base_generation += 1;
+        }
+        self.head()
+    }
+
+    /// Encoded frames bringing a replica at generation `after` to `head`
+    ///
+    /// A base snapshot if `after` predates the base, then batches of up
+    /// to `batch` deltas, then the summary root. Frames are encoded and
+    /// compressed lazily, one per `next`.
+    pub fn frames(&self, after: u64, batch: usize) -> Result<impl Iterator<Item = Vec<u8>> + '_, SyncError> {
+        if after > self.head() {
+            return Err(SyncError::Ahead { head: self.head(), generation: after });
+        }
+        let level = Compression::default();
+        let snapshot = (after < self.base_generation).then(|| {
+            let peaks = self.summary.peaks(self.base_generation).expect("peaks of the base are retained");
+            wire::encode_snapshot(self.base_generation, &peaks, &self.base, level)
+        });
+        let skip = (after.max(self.base_generation) - self.base_generation) as usize;
+        let batch = batch.max(1);
+        let batches = (skip..self.log.len()).step_by(batch).map(move |at| {
+            let end = self.log.len().min(at + batch);
+            wire::encode_batch(self.base_generation + at as u64 + 1, self.log.range(at..end), level)
+        });
+        let summary = std::iter::once_with(move || wire::encode_summary(self.head(), &self.summary.root()));
+        Ok(snapshot.into_iter().chain(batches).chain(summary))
+    }
+
+    /// Write `frames(after, batch)` to `out`, encoding ahead on a worker
+    ///
+    /// Compression of the next frames overlaps the write of the current
+    /// one, with at most `PIPELINE_DEPTH` frames buffered. Returns the
+    /// bytes written.
+    pub fn stream(&self, after: u64, batch: usize, out: &mut impl Write) -> Result<u64, SyncError> {
+        let frames = self.frames(after, batch)?;
+        let (tx, rx) = mpsc::sync_channel::<Vec<u8>>(PIPELINE_DEPTH);
+        let written = thread::scope(|scope| {
+            scope.spawn(move || {
+                for frame in frames {
+                    if tx.send(frame).is_err() {
+                        return;
+                    }
+                }
+            });
+            let mut written = 0u64;
+            for frame in rx {
+                out.write_all(&frame)?;
+                written += frame.len() as u64;
+            }
+            out.flush().map(|()| written)
+        })?;
+        Ok(written)
+    }
+}
+
+/// Downstream end of a hop
+#[derive(Debug, Clone, Default)]
+pub struct Replica {
+    state: SyncState,
+    summary: MerkleLog,
+    relay: Option<SyncSource>,
+    relay_retain: usize,
+}
+
+impl Replica {
+    /// Empty replica at generation 0
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Replica that also serves the next hop, keeping `retain` deltas
+    pub fn with_relay(retain: usize) -> Self {
+        Self { relay: Some(SyncSource::new(retain)), relay_retain: retain, ..Self::default() }
+    }
+
+    /// Generations applied
+    pub fn generation(&self) -> u64 {
+        self.summary.len()
+    }
+
+    /// Replicated registry and graph
+    pub fn state(&self) -> &SyncState {
+        &self.state
+    }
+
+    /// Summary of the applied generations
+    pub fn summary(&self) -> &MerkleLog {
+        &self.summary
+    }
+
+    /// Source for the next hop, if relaying
+    pub fn relay(&self) -> Option<&SyncSource> {
+        self.relay.as_ref()
+    }
+
+    /// Apply one decoded frame and return the new generation
+    ///
+    /// Deltas the replica already holds are checked against its summary
+    /// and skipped, so resending an overlapping range is harmless.
+    pub fn apply(&mut self, frame: Frame) -> Result<u64, SyncError> {
+        match frame {
+            Frame::Batch { first, deltas } => {
+                let expected = self.generation() + 1;
+                if first > expected || first == 0 {
+                    return Err(SyncError::Gap { expected, got: first });
+                }
+                let mut scratch = Vec::new();
+                for (generation, delta) in (first..).zip(deltas) {
+                    let leaf = leaf_of(&delta, &mut scratch);
+                    if generation <= self.generation() {
+                        match self.summary.node(0, generation - 1) {
+                            Some(own) if own != leaf => return Err(SyncError::Diverged { generation }),
+                            _ => continue,
+                        }
+                    }
+                    self.summary.push(leaf);
+                    self.state.apply(&delta);
+                    if let Some(relay) = &mut self.relay {
+                        relay.commit_hashed(delta, leaf);
+                    }
+                }
+            }
+            Frame::Snapshot { generation, peaks, state } => {
+                if generation <= self.generation() {
+                    if self.summary.peaks(generation).is_some_and(|own| own != peaks) {
+                        return Err(SyncError::Diverged { generation });
+                    }
+                    return Ok(self.generation());
+                }
+                let summary = MerkleLog::from_peaks(generation, &peaks)
+                    .ok_or_else(|| io::Error::new(io::ErrorKind::InvalidData, "snapshot peaks do not fit its generation"))?;
+                let mut restored = SyncState::default();
+                restored.apply(&state);
+                if self.relay.is_some() {
+                    self.relay = SyncSource::from_snapshot(generation, &peaks, restored.clone(), self.relay_retain);
+                }
+                self.state = restored;
+                self.summary = summary;
+            }
+            Frame::Summary { generation, root } => {
+                if self.summary.root_at(generation).is_some_and(|own| own != root) {
+                    return Err(SyncError::Diverged { generation });
+                }
+            }
+        }
+        Ok(self.generation())
+    }
+
+    /// Apply every frame of a stream, decoding ahead on a worker
+    ///
+    /// Decompression of the next frames overlaps applying the current
+    /// one. Returns the generation reached; on an error the frames
+    /// before it stay applied. The worker finishes the frame it is
+    /// reading before this returns.
+    pub fn receive(&mut self, input: &mut (impl Read + Send)) -> Result<u64, SyncError> {
+        let (tx, rx) = mpsc::sync_channel::<io::Result<Frame>>(PIPELINE_DEPTH);
+        thread::scope(|scope| {
+            scope.spawn(move || loop {
+                let frame = match wire::read_frame(input) {
+                    Ok(Some(frame)) => Ok(frame),
+                    Ok(None) => return,
+                    Err(e) => Err(e),
+                };
+                let failed = frame.is_err();
+                if tx.send(frame).is_err() || failed {
+                    return;
+                }
+            });
+            for frame in rx {
+                self.apply(frame?)?;
+            }
+            Ok(self.generation())
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::observer_gate::recovery::GraphDelta;
+    use crate::registry::PackageEntry;
+    use crate::resolver::GraphView;
+    use std::io::{BufReader, Cursor};
+
+    fn delta(g: u64) -> SyncDelta {
+        let entry = PackageEntry {
+            name: format!("pkg{}", g % 7),
+            version: format!("1.{}.{}", g / 7, g % 3),
+            tarball_hash: vec![g as u8; 32],
+            signature: vec![7; 64],
+        };
+        let node = format!("1.{}.0", g);
+        let edges = if g > 1 { vec![(format!("1.{}.0", g - 1), node.clone())] } else { Vec::new() };
+        (vec![entry], GraphDelta { nodes: vec![node], edges })
+    }
+
+    fn source(generations: u64, retain: usize) -> SyncSource {
+        let mut source = SyncSource::new(retain);
+        for g in 1..=generations {
+            assert_eq!(source.commit(delta(g)), g);
+        }
+        source
+    }
+
+    fn sync(source: &SyncSource, replica: &mut Replica, batch: usize) -> Result<u64, SyncError> {
+        let mut wire = Vec::new();
+        source.stream(replica.generation(), batch, &mut wire)?;
+        replica.receive(&mut BufReader::new(Cursor::new(wire)))
+    }
+
+    fn same_state(a: &SyncState, b: &SyncState) {
+        assert_eq!(a.0.entries().len(), b.0.entries().len());
+        for (x, y) in a.0.entries().iter().zip(b.0.entries()) {
+            assert_eq!(x.view(), y.view());
+        }
+        assert_eq!(a.1.node_count(), b.1.node_count());
+        assert_eq!(a.1.edge_count(), b.1.edge_count());
+        assert_eq!(a.1.find_node("1.5.0"), b.1.find_node("1.5.0"));
+    }
+
+    #[test]
+    fn test_three_node_chain_with_catch_up() {
+        let mut x = source(40, 16);
+        let mut y = Replica::with_relay(8);
+        let mut z = Replica::new();
+
+        assert_eq!(sync(&x, &mut y, 5).unwrap(), 40);
+        assert_eq!(sync(y.relay().unwrap(), &mut z, 3).unwrap(), 40);
+        assert_eq!(z.summary().root(), x.summary().root());
+
+        // Incremental rounds ship only the new generations
+        for g in 41..=50 {
+            x.commit(delta(g));
+        }
+        let mut full = Vec::new();
+        x.stream(0, DEFAULT_BATCH, &mut full).unwrap();
+        let mut tail = Vec::new();
+        x.stream(y.generation(), DEFAULT_BATCH, &mut tail).unwrap();
+        assert!(tail.len() * 3 < full.len());
+        y.receive(&mut Cursor::new(tail)).unwrap();
+        assert_eq!(sync(y.relay().unwrap(), &mut z, DEFAULT_BATCH).unwrap(), 50);
+
+        // Z fell behind Y's relay log: served from the relay's base snapshot
+        let mut far = Replica::new();
+        assert_eq!(sync(y.relay().unwrap(), &mut far, 4).unwrap(), 50);
+        assert_eq!(far.summary().root(), x.summary().root());
+
+        let mut replay = SyncState::default();
+        for g in 1..=50 {
+            replay.apply(&delta(g));
+        }
+        for node in [y.state(), z.state(), far.state()] {
+            same_state(node, &replay);
+        }
+
+        // Resending an overlap is a no-op
+        let mut again = Vec::new();
+        x.stream(45, 2, &mut again).unwrap();
+        assert_eq!(z.receive(&mut Cursor::new(again)).unwrap(), 50);
+    }
+
+    #[test]
+    fn test_divergence_gap_and_corruption() {
+        let x = source(30, 64);
+        let mut forked = SyncSource::new(64);
+        for g in 1..=30 {
+            forked.commit(if g == 19 { delta(1000) } else { delta(g) });
+        }
+        let mut replica = Replica::new();
+        sync(&forked, &mut replica, 8).unwrap();
+        assert!(matches!(sync(&x, &mut Replica::new(), 8), Ok(30)));
+
+        let mut wire = Vec::new();
+        x.stream(20, 8, &mut wire).unwrap();
+        let mut behind = Replica::new();
+        for g in 1..=10 {
+            behind.apply(Frame::Batch { first: g, deltas: vec![delta(g)] }).unwrap();
+        }
+        assert!(matches!(behind.receive(&mut Cursor::new(&wire)), Err(SyncError::Gap { expected: 11, got: 21 })));
+        assert!(matches!(replica.receive(&mut Cursor::new(&wire)), Err(SyncError::Diverged { generation: 30 })));
+        assert_eq!(common_prefix(x.summary(), replica.summary()), 18);
+        assert!(matches!(x.frames(31, 8), Err(SyncError::Ahead { head: 30, generation: 31 })));
+
+        let mut corrupt = Vec::new();
+        x.stream(0, 8, &mut corrupt).unwrap();
+        corrupt.truncate(corrupt.len() / 2);
+        assert!(matches!(Replica::new().receive(&mut Cursor::new(corrupt)), Err(SyncError::Io(_))));
+
+        // Lengths are checked against what arrives, never preallocated
+        let huge = [0, 0, 1, 0xff, 0xff, 0xff, 0x7f, 1, 2, 3];
+        let err = read_frame(&mut Cursor::new(huge)).unwrap_err();
+        assert_eq!(err.kind(), io::ErrorKind::UnexpectedEof);
+        let oversized = [0, 0, 1, 0x81, 0x80, 0x80, 0x80, 0x01];
+        let err = read_frame(&mut Cursor::new(oversized)).unwrap_err();
+        assert_eq!(err.kind(), io::ErrorKind::InvalidData);
+    }
+}
@@ -0,0 +1,323 @@
+//! Sync frame encoding
+//!
+//! A frame is one header followed by its payload:
+//!
+//! - kind `u8`: 0 batch, 1 snapshot, 2 summary
+//! - flags `u8`: bit 0 set if the payload is deflate-compressed
+//! - generation: varint; first generation of a batch, or the
+//!   generation a snapshot or summary describes
+//! - payload length: varint, then the payload bytes
+//!
+//! Integers are LEB128 varints and byte strings are a varint length
+//! plus the bytes. A delta is its registry entries (name, version,
+//! tarball hash, signature), then its node ids, then its edges as
+//! `from`, `to` id pairs. A batch payload is a delta count plus the
+//! deltas; a snapshot payload is the summary peaks plus the whole
+//! state written as one delta; a summary payload is the Merkle root.
+//!
+//! Payloads are compressed only when that makes them smaller, so tiny
+//! frames pay no deflate header. The encoding of a delta is also what
+//! its Merkle leaf hashes, so it must stay deterministic.
+
+use std::io::{self, Read, Write};
+
+use flate2::read::DeflateDecoder;
+use flate2::write::DeflateEncoder;
+use flate2::Compression;
+use petgraph::graph::NodeIndex;
+
+use crate::observer_gate::recovery::GraphDelta;
+use crate::registry::PackageEntry;
+use crate::resolver::GraphView;
+use super::merkle::Digest;
+use super::{SyncDelta, SyncState};
+
+const KIND_BATCH: u8 = 0;
+const KIND_SNAPSHOT: u8 = 1;
+const KIND_SUMMARY: u8 = 2;
+const FLAG_DEFLATE: u8 = 1;
+
+/// Payloads shorter than this are never worth compressing
+const COMPRESS_MIN: usize = 64;
+
+/// Largest payload a frame may declare or inflate to, against corrupt
+/// lengths and deflate bombs
+pub const MAX_PAYLOAD: u64 = 1 << 28;
+
+/// A decoded sync frame
+#[derive(Debug, Clone)]
+pub enum Frame {
+    /// Deltas of generations `first..first + deltas.len()`
+    Batch {
+        /// Generation of `deltas[0]`
+        first: u64,
+        /// One delta per generation, in order
+        deltas: Vec<SyncDelta>,
+    },
+    /// Whole state at `generation`, as one delta from the empty state
+    Snapshot {
+        /// Generation the state is at
+        generation: u64,
+        /// Summary peaks over generations `1..=generation`
+        peaks: Vec<Digest>,
+        /// Entries, nodes and edges of the state, in insertion order
+        state: SyncDelta,
+    },
+    /// Summary root of the sender's first `generation` generations
+    Summary {
+        /// Generations covered
+        generation: u64,
+        /// `MerkleLog::root_at(generation)`
+        root: Digest,
+    },
+}
+
+fn corrupt(reason: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, reason)
+}
+
+fn put_varint(out: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        out.push(value as u8 | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+fn put_bytes(out: &mut Vec<u8>, bytes: &[u8]) {
+    put_varint(out, bytes.len() as u64);
+    out.extend_from_slice(bytes);
+}
+
+fn put_entry(out: &mut Vec<u8>, entry: &PackageEntry) {
+    put_bytes(out, entry.name.as_bytes());
+    put_bytes(out, entry.version.as_bytes());
+    put_bytes(out, &entry.tarball_hash);
+    put_bytes(out, &entry.signature);
+}
+
+/// Canonical encoding of one delta
+pub fn encode_delta(out: &mut Vec<u8>, delta: &SyncDelta) {
+    let (entries, graph) = delta;
+    put_varint(out, entries.len() as u64);
+    for entry in entries {
+        put_entry(out, entry);
+    }
+    put_varint(out, graph.nodes.len() as u64);
+    for id in &graph.nodes {
+        put_bytes(out, id.as_bytes());
+    }
+    put_varint(out, graph.edges.len() as u64);
+    for (from, to) in &graph.edges {
+        put_bytes(out, from.as_bytes());
+        put_bytes(out, to.as_bytes());
+    }
+}
+
+/// Whole state as one delta, O(state), without cloning it first
+fn encode_state(out: &mut Vec<u8>, (registry, graph): &SyncState) {
+    put_varint(out, registry.len() as u64);
+    for entry in registry.entries() {
+        put_entry(out, entry);
+    }
+    put_varint(out, graph.node_count() as u64);
+    for i in 0..graph.node_count() {
+        put_bytes(out, graph.node_id(NodeIndex::new(i)).as_bytes());
+    }
+    let edges = graph.raw_edges();
+    put_varint(out, edges.len() as u64);
+    for edge in edges {
+        put_bytes(out, graph.node_id(edge.source()).as_bytes());
+        put_bytes(out, graph.node_id(edge.target()).as_bytes());
+    }
+}
+
+/// Header plus payload, deflated at `level` when that is smaller
+fn frame(kind: u8, generation: u64, payload: Vec<u8>, level: Compression) -> Vec<u8> {
+    let (flags, body) = if payload.len() >= COMPRESS_MIN {
+        let mut encoder = DeflateEncoder::new(Vec::with_capacity(payload.len() / 2), level);
+        let packed = encoder.write_all(&payload).and_then(|()| encoder.finish());
+        match packed {
+            Ok(packed) if packed.len() < payload.len() => (FLAG_DEFLATE, packed),
+            _ => (0, payload),
+        }
+    } else {
+        (0, payload)
+    };
+    let mut out = Vec::with_capacity(body.len() + 20);
+    out.push(kind);
+    out.push(flags);
+    put_varint(&mut out, generation);
+    put_varint(&mut out, body.len() as u64);
+    out.extend_from_slice(&body);
+    out
+}
+
+/// Encoded batch frame for the deltas of `first..`
+pub fn encode_batch<'a>(first: u64, deltas: impl ExactSizeIterator<Item = &'a SyncDelta>, level: Compression) -> Vec<u8> {
+    let mut payload = Vec::new();
+    put_varint(&mut payload, deltas.len() as u64);
+    for delta in deltas {
+        encode_delta(&mut payload, delta);
+    }
+    frame(KIND_BATCH, first, payload, level)
+}
+
+/// Encoded snapshot frame of `state` at `generation`
+pub fn encode_snapshot(generation: u64, peaks: &[Digest], state: &SyncState, level: Compression) -> Vec<u8> {
+    let mut payload = Vec::new();
+    put_varint(&mut payload, peaks.len() as u64);
+    for peak in peaks {
+        payload.extend_from_slice(peak);
+    }
+    encode_state(&mut payload, state);
+    frame(KIND_SNAPSHOT, generation, payload, level)
+}
+
+/// Encoded summary frame
+pub fn encode_summary(generation: u64, root: &Digest) -> Vec<u8> {
+    frame(KIND_SUMMARY, generation, root.to_vec(), Compression::none())
+}
+
+/// Cursor over a payload
+struct Payload<'a> {
+    data: &'a [u8],
+}
+
+impl<'a> Payload<'a> {
+    fn varint(&mut self) -> io::Result<u64> {
+        let mut value = 0u64;
+        for shift in (0..64).step_by(7) {
+            let (&byte, rest) = self.data.split_first().ok_or_else(|| corrupt("truncated varint"))?;
+            self.data = rest;
+            value |= u64::from(byte & 0x7f) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+        }
+        Err(corrupt("varint overflows 64 bits"))
+    }
+
+    fn bytes(&mut self) -> io::Result<&'a [u8]> {
+        let len = usize::try_from(self.varint()?).map_err(|_| corrupt("length overflows"))?;
+        if len > self.data.len() {
+            return Err(corrupt("truncated field"));
+        }
+        let (bytes, rest) = self.data.split_at(len);
+        self.data = rest;
+        Ok(bytes)
+    }
+
+    fn string(&mut self) -> io::Result<String> {
+        String::from_utf8(self.bytes()?.to_vec()).map_err(|_| corrupt("id is not UTF-8"))
+    }
+
+    /// A count of items at least `min_size` bytes each; bounds allocations
+    fn count(&mut self, min_size: usize) -> io::Result<usize> {
+        let count = self.varint()?;
+        if count > (self.data.len() / min_size.max(1)) as u64 {
+            return Err(corrupt("count exceeds payload"));
+        }
+        Ok(count as usize)
+    }
+
+    fn delta(&mut self) -> io::Result<SyncDelta> {
+        let entries = (0..self.count(4)?)
+            .map(|_| {
+                Ok(PackageEntry {
+                    name: self.string()?,
+                    version: self.string()?,
+                    tarball_hash: self.bytes()?.to_vec(),
+                    signature: self.bytes()?.to_vec(),
+                })
+            })
+            .collect::<io::Result<Vec<_>>>()?;
+        let nodes = (0..self.count(1)?).map(|_| self.string()).collect::<io::Result<Vec<_>>>()?;
+        let edges = (0..self.count(2)?)
+            .map(|_| Ok((self.string()?, self.string()?)))
+            .collect::<io::Result<Vec<_>>>()?;
+        Ok((entries, GraphDelta { nodes, edges }))
+    }
+
+    fn finish(&self) -> io::Result<()> {
+        if self.data.is_empty() { Ok(()) } else { Err(corrupt("trailing payload bytes")) }
+    }
+}
+
+fn read_varint(input: &mut impl Read) -> io::Result<Option<u64>> {
+    let mut value = 0u64;
+    for (i, shift) in (0..64).step_by(7).enumerate() {
+        let mut byte = [0u8];
+        if input.read(&mut byte)? == 0 {
+            return if i == 0 { Ok(None) } else { Err(corrupt("truncated frame header")) };
+        }
+        value |= u64::from(byte[0] & 0x7f) << shift;
+        if byte[0] & 0x80 == 0 {
+            return Ok(Some(value));
+        }
+    }
+    Err(corrupt("varint overflows 64 bits"))
+}
+
+/// Read one frame; `None` at a clean end of stream
+///
+/// Reads the header a byte at a time, so wrap raw sockets and files
+/// in a `BufReader`.
+pub fn read_frame(input: &mut impl Read) -> io::Result<Option<Frame>> {
+    let mut head = [0u8; 2];
+    match input.read(&mut head[..1])? {
+        0 => return Ok(None),
+        _ => input.read_exact(&mut head[1..])?,
+    }
+    let [kind, flags] = head;
+    let truncated = || corrupt("truncated frame header");
+    let generation = read_varint(input)?.ok_or_else(truncated)?;
+    let len = read_varint(input)?.ok_or_else(truncated)?;
+    if len > MAX_PAYLOAD {
+        return Err(corrupt("payload length out of range"));
+    }
+    // Grows with the bytes that actually arrive, not the declared length
+    let mut body = Vec::new();
+    input.by_ref().take(len).read_to_end(&mut body)?;
+    if body.len() as u64 != len {
+        return Err(io::Error::new(io::ErrorKind::UnexpectedEof, "truncated frame payload"));
+    }
+    let payload = match flags {
+        0 => body,
+        FLAG_DEFLATE => {
+            let mut out = Vec::with_capacity(body.len() * 3);
+            DeflateDecoder::new(&body[..]).take(MAX_PAYLOAD + 1).read_to_end(&mut out)?;
+            if out.len() as u64 > MAX_PAYLOAD {
+                return Err(corrupt("inflated payload out of range"));
+            }
+            out
+        }
+        _ => return Err(corrupt("unknown frame flags")),
+    };
+
+    let mut p = Payload { data: &payload };
+    let frame = match kind {
+        KIND_BATCH => {
+            let deltas = (0..p.count(3)?).map(|_| p.delta()).collect::<io::Result<Vec<_>>>()?;
+            Frame::Batch { first: generation, deltas }
+        }
+        KIND_SNAPSHOT => {
+            let peaks = (0..p.count(32)?)
+                .map(|_| {
+                    let (peak, rest) = p.data.split_at(32);
+                    p.data = rest;
+                    peak.try_into().unwrap()
+                })
+                .collect();
+            Frame::Snapshot { generation, peaks, state: p.delta()? }
+        }
+        KIND_SUMMARY => {
+            let root: Digest = p.data.try_into().map_err(|_| corrupt("summary root is not 32 bytes"))?;
+            p.data = &[];
+            Frame::Summary { generation, root }
+        }
+        _ => return Err(corrupt("unknown frame kind")),
+    };
+    p.finish()?;
+    Ok(Some(frame))
+}
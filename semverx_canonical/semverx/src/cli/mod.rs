@@ -0,0 +1,138 @@
+//! SemVerX command line
+//!
+//! Implements:
+//! - `plpadapter`: lockfile parsing into a frozen dependency graph
+//! - `plpsdk`: parallel whole-lockfile resolution streamed as NDJSON
+//! - `run`: argument handling behind the `semverx` binary
+//!
+//! ```text
+//! semverx resolve <lockfile> --registry <image> [--threads N] [--ordered]
+//! ```
+//!
+//! `resolve` maps the registry image, resolves every `dep` of the
+//! lockfile and writes one NDJSON line per entry to stdout. It exits 0
+//! when every entry was pinned, 1 when some were not and 2 on usage or
+//! I/O errors.
+
+pub mod plpadapter;
+pub mod plpsdk;
+
+use std::io::{self, Write};
+
+use crate::registry::RegistryImage;
+use plpadapter::Lockfile;
+use plpsdk::{RunConfig, Session};
+
+/// Usage line printed on argument errors
+pub const USAGE: &str = "usage: semverx resolve <lockfile> --registry <image> [--threads N] [--ordered]";
+
+/// Parsed `resolve` arguments
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ResolveArgs {
+    /// Lockfile path
+    pub lockfile: String,
+    /// Registry image path
+    pub registry: String,
+    /// Scheduling and output options
+    pub config: RunConfig,
+}
+
+impl ResolveArgs {
+    /// Parse the arguments following `resolve`
+    pub fn parse(args: &[String]) -> Result<Self, &'static str> {
+        let mut lockfile = None;
+        let mut registry = None;
+        let mut config = RunConfig::default();
+        let mut args = args.iter();
+        while let Some(arg) = args.next() {
+            match arg.as_str() {
+                "--registry" => registry = Some(args.next().ok_or("--registry needs a path")?.clone()),
+                "--threads" => {
+                    let threads = args.next().and_then(|n| n.parse().ok()).filter(|&n| n > 0);
+                    config.threads = threads.ok_or("--threads needs a positive count")?;
+                }
+                "--ordered" => config.ordered = true,
+                flag if flag.starts_with("--") => return Err("unknown option"),
+                _ if lockfile.is_none() => lockfile = Some(arg.clone()),
+                _ => return Err("more than one lockfile"),
+            }
+        }
+        Ok(Self {
+            lockfile: lockfile.ok_or("missing lockfile")?,
+            registry: registry.ok_or("missing --registry")?,
+            config,
+        })
+    }
+}
+
+/// Run the command line `args` (without the program name), returning the exit code
+pub fn run(args: &[String], out: impl Write, mut err: impl Write) -> i32 {
+    let parsed = match args.split_first() {
+        Some((command, rest)) if command == "resolve" => ResolveArgs::parse(rest),
+        Some(_) => Err("unknown command"),
+        None => Err("missing command"),
+    };
+    let args = match parsed {
+        Ok(args) => args,
+        Err(reason) => {
+            let _ = writeln!(err, "semverx: {}\n{}", reason, USAGE);
+            return 2;
+        }
+    };
+    match resolve(&args, out) {
+        Ok(0) => 0,
+        Ok(failed) => {
+            let _ = writeln!(err, "semverx: {} entries unsatisfied", failed);
+            1
+        }
+        Err(e) => {
+            let _ = writeln!(err, "semverx: {}", e);
+            2
+        }
+    }
+}
+
+/// `semverx resolve`; returns the number of unsatisfied entries
+fn resolve(args: &ResolveArgs, out: impl Write) -> io::Result<usize> {
+    let lock = Lockfile::read(&args.lockfile)?;
+    let registry = RegistryImage::open(&args.registry)?;
+    let session = Session::from_lockfile(&lock, registry);
+    let summary = session.resolve_all(&lock, out, &args.config)?;
+    Ok(summary.failed)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::registry::{PackageEntry, PackageRegistry};
+
+    fn strings(args: &[&str]) -> Vec<String> {
+        args.iter().map(|s| s.to_string()).collect()
+    }
+
+    #[test]
+    fn test_resolve_command_end_to_end() {
+        let dir = std::env::temp_dir().join(format!("semverx-cli-{}", std::process::id()));
+        std::fs::create_dir_all(&dir).unwrap();
+        let (lock, image) = (dir.join("semverx.lock"), dir.join("registry.img"));
+        std::fs::write(&lock, "root app@1.0.0\nedge app@1.0.0 a@1.1.0\ndep a ^1\ndep b ^1\n").unwrap();
+        let mut registry = PackageRegistry::new();
+        registry.publish(PackageEntry { name: "a".into(), version: "1.1.0".into(), tarball_hash: vec![1], signature: vec![] });
+        registry.save_image(&image).unwrap();
+
+        let args = strings(&["resolve", lock.to_str().unwrap(), "--registry", image.to_str().unwrap(), "--ordered"]);
+        let (mut out, mut err) = (Vec::new(), Vec::new());
+        assert_eq!(run(&args, &mut out, &mut err), 1);
+        let out = String::from_utf8(out).unwrap();
+        let lines: Vec<&str> = out.lines().collect();
+        assert_eq!(lines.len(), 2);
+        assert!(lines[0].contains("\"version\":\"1.1.0\",\"tarball\":\"01\",\"path\":[\"app@1.0.0\",\"a@1.1.0\"]"));
+        assert!(lines[1].contains("\"error\""));
+        assert_eq!(String::from_utf8(err).unwrap(), "semverx: 1 entries unsatisfied\n");
+        std::fs::remove_dir_all(&dir).unwrap();
+
+        let mut err = Vec::new();
+        assert_eq!(run(&strings(&["resolve", "x.lock", "--threads", "0"]), io::sink(), &mut err), 2);
+        assert!(String::from_utf8(err).unwrap().starts_with("semverx: --threads needs a positive count\n"));
+    }
+}
@@ -0,0 +1,154 @@
+//! PLP adapter: lockfiles into resolver inputs
+//!
+//! Implements:
+//! - The line-oriented `semverx.lock` format
+//! - Freezing a lockfile's dependency edges into one `FrozenGraph`
+//!
+//! One record per line; blank lines and `#` comments are skipped:
+//!
+//! ```text
+//! root app@1.0.0
+//! dep left-pad ^1.2(stable)
+//! edge app@1.0.0 left-pad@1.2.3
+//! ```
+//!
+//! `dep` lines are the requirements to resolve, in output order.
+//! `edge` lines are the locked dependency graph over `name@version`
+//! node ids, and `root` (at most once) is the node resolution paths
+//! start from.
+
+use std::fmt;
+use std::fs;
+use std::io;
+use std::path::Path;
+
+use crate::registry::VersionReq;
+use crate::resolver::{DependencyGraph, FrozenGraph, NodeId};
+
+/// One requirement to resolve
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Dependency {
+    /// Package name
+    pub name: String,
+    /// Version requirement, e.g. `^1.2(stable)`
+    pub req: String,
+}
+
+impl Dependency {
+    /// Graph node id of `version` of this package
+    pub fn node_id(&self, version: &str) -> NodeId {
+        format!("{}@{}", self.name, version)
+    }
+}
+
+/// Parsed lockfile
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct Lockfile {
+    /// Node resolution paths start from
+    pub root: Option<NodeId>,
+    /// Requirements, in file order
+    pub dependencies: Vec<Dependency>,
+    /// Locked edges `from -> to`
+    pub edges: Vec<(NodeId, NodeId)>,
+}
+
+/// Malformed lockfile line
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ParseError {
+    /// 1-based line number
+    pub line: usize,
+    /// What is wrong with it
+    pub reason: &'static str,
+}
+
+impl fmt::Display for ParseError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "lockfile line {}: {}", self.line, self.reason)
+    }
+}
+
+impl std::error::Error for ParseError {}
+
+impl Lockfile {
+    /// Parse lockfile text, O(length)
+    ///
+    /// Requirements are validated here, so resolution never meets a
+    /// malformed one.
+    pub fn parse(text: &str) -> Result<Self, ParseError> {
+        let mut lock = Lockfile::default();
+        for (i, line) in text.lines().enumerate() {
+            let fail = |reason| Err(ParseError { line: i + 1, reason });
+            let line = line.split('#').next().unwrap_or("");
+            let fields: Vec<&str> = line.split_whitespace().collect();
+            match fields[..] {
+                [] => {}
+                ["root", id] if lock.root.is_none() => lock.root = Some(id.to_string()),
+                ["root", _] => return fail("second root"),
+                ["dep", name, req] => {
+                    if VersionReq::parse(req).is_none() {
+                        return fail("invalid version requirement");
+                    }
+                    lock.dependencies.push(Dependency { name: name.to_string(), req: req.to_string() });
+                }
+                ["edge", from, to] => lock.edges.push((from.to_string(), to.to_string())),
+                ["root" | "dep" | "edge", ..] => return fail("wrong number of fields"),
+                _ => return fail("unknown record"),
+            }
+        }
+        Ok(lock)
+    }
+
+    /// Read and parse the lockfile at `path`
+    ///
+    /// Parse errors surface as `InvalidData`.
+    pub fn read(path: impl AsRef<Path>) -> io::Result<Self> {
+        let text = fs::read_to_string(path)?;
+        Self::parse(&text).map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))
+    }
+
+    /// Dependency graph of the root and every edge endpoint, frozen
+    ///
+    /// O(V + E); node versions are parsed from the ids once here.
+    pub fn graph(&self) -> FrozenGraph {
+        let mut graph = DependencyGraph::new();
+        if let Some(root) = &self.root {
+            graph.add_symbol(root);
+        }
+        for (from, to) in &self.edges {
+            let (from, to) = (graph.add_symbol(from), graph.add_symbol(to));
+            graph.add_edge_symbols(from, to);
+        }
+        FrozenGraph::from_graph(&graph)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::GraphView;
+
+    #[test]
+    fn test_parse_and_freeze() {
+        let text = "# locked\nroot app@1.0.0\n\ndep left-pad ^1.2(stable)\ndep chalk ~2.0\n\
+                    edge app@1.0.0 left-pad@1.2.3  # direct\nedge app@1.0.0 chalk@2.0.1\n";
+        let lock = Lockfile::parse(text).unwrap();
+        assert_eq!(lock.root.as_deref(), Some("app@1.0.0"));
+        assert_eq!(lock.dependencies[1], Dependency { name: "chalk".into(), req: "~2.0".into() });
+        assert_eq!(lock.dependencies[0].node_id("1.2.3"), "left-pad@1.2.3");
+        assert_eq!(lock.edges.len(), 2);
+
+        let graph = lock.graph();
+        assert_eq!(graph.node_count(), 3);
+        assert_eq!(graph.edge_count(), 2);
+        assert!(graph.symbols().get("chalk@2.0.1").is_some());
+    }
+
+    #[test]
+    fn test_parse_errors_name_the_line() {
+        let err = |text: &str| Lockfile::parse(text).unwrap_err();
+        assert_eq!(err("dep a ^1\ndep b nope\n"), ParseError { line: 2, reason: "invalid version requirement" });
+        assert_eq!(err("root a@1.0.0\nroot b@1.0.0").reason, "second root");
+        assert_eq!(err("edge a@1.0.0").reason, "wrong number of fields");
+        assert_eq!(err("\n\npin a 1.0.0").line, 3);
+    }
+}
@@ -0,0 +1,431 @@
+//! PLP SDK: whole-lockfile resolution
+//!
+//! Implements:
+//! - `Session`: one frozen graph plus one registry snapshot, shared
+//!   read-only by every worker of a run
+//! - `Session::resolve_all`: every lockfile dependency resolved on a
+//!   self-scheduling worker pool, streamed out as NDJSON
+//!
+//! Resolving a dependency picks the highest registry version satisfying
+//! its requirement, then the shortest path from the lockfile root to
+//! that `name@version` node. Picks are memoized per run by (name,
+//! requirement) and paths live in the session's `ResolutionCache`, so
+//! duplicate entries cost a hash lookup.
+//!
+//! One JSON object per line, written as soon as it is ready:
+//!
+//! ```text
+//! {"index":0,"name":"left-pad","req":"^1.2","version":"1.2.3","tarball":"ab12","path":["app@1.0.0","left-pad@1.2.3"],"cost":1}
+//! {"index":1,"name":"chalk","req":"^9","error":"no version satisfies the requirement"}
+//! ```
+//!
+//! `path` is null without a root or when the locked graph does not
+//! reach the pinned node. `index` is the entry's position in the
+//! lockfile; lines arrive in completion order unless `ordered` is set.
+
+use std::collections::hash_map::DefaultHasher;
+use std::collections::{BTreeMap, HashMap};
+use std::fmt::Write as _;
+use std::hash::{Hash, Hasher};
+use std::io::{self, BufWriter, Write};
+use std::ops::Deref;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::mpsc::{self, Receiver, TryRecvError};
+use std::sync::{Arc, Mutex};
+use std::thread;
+
+use crate::cli::plpadapter::{Dependency, Lockfile};
+use crate::registry::{PackageEntryRef, PackageRegistry, RegistryImage};
+use crate::resolver::{
+    CacheStats, FrozenGraph, GraphView, ResolutionCache, ResolutionStrategy, Symbol, SymbolPath,
+};
+
+/// Shards of the per-run pick memo
+const MEMO_SHARDS: usize = 16;
+
+/// Registry snapshot a session resolves against
+pub trait Registry: Sync {
+    /// Highest version of `name` satisfying `req`
+    fn max_satisfying(&self, name: &str, req: &str) -> Option<PackageEntryRef<'_>>;
+}
+
+impl Registry for PackageRegistry {
+    fn max_satisfying(&self, name: &str, req: &str) -> Option<PackageEntryRef<'_>> {
+        PackageRegistry::max_satisfying(self, name, req).map(|entry| entry.view())
+    }
+}
+
+impl<B: Deref<Target = [u8]> + Sync> Registry for RegistryImage<B> {
+    fn max_satisfying(&self, name: &str, req: &str) -> Option<PackageEntryRef<'_>> {
+        RegistryImage::max_satisfying(self, name, req)
+    }
+}
+
+impl<R: Registry + Send> Registry for Arc<R> {
+    fn max_satisfying(&self, name: &str, req: &str) -> Option<PackageEntryRef<'_>> {
+        R::max_satisfying(&**self, name, req)
+    }
+}
+
+/// Worker count, scheduling granularity and output order of a run
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct RunConfig {
+    /// Resolver threads
+    pub threads: usize,
+    /// Entries claimed per scheduling step
+    pub chunk: usize,
+    /// Rendered lines buffered between the workers and the writer
+    pub queue_depth: usize,
+    /// Emit lines in lockfile order instead of completion order
+    pub ordered: bool,
+}
+
+impl Default for RunConfig {
+    fn default() -> Self {
+        Self {
+            threads: thread::available_parallelism().map_or(1, |n| n.get()),
+            chunk: 16,
+            queue_depth: 256,
+            ordered: false,
+        }
+    }
+}
+
+/// Counts of one run
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Summary {
+    /// Entries pinned to a version
+    pub resolved: usize,
+    /// Entries no version satisfies
+    pub failed: usize,
+    /// Pinned entries the locked graph does not reach from the root
+    pub unreachable: usize,
+    /// Path cache counters after the run
+    pub cache: CacheStats,
+}
+
+/// Outcome of one dependency
+#[derive(Debug, Clone, PartialEq)]
+pub enum Resolution<'r> {
+    /// Pinned to `entry`; `path` from the root, if there is one
+    Pinned {
+        /// Chosen registry entry
+        entry: PackageEntryRef<'r>,
+        /// Shortest root-to-entry path in the locked graph
+        path: Option<SymbolPath>,
+    },
+    /// No published version satisfies the requirement
+    Unsatisfied,
+}
+
+type Memo<'a, 'r> = Vec<Mutex<HashMap<(&'a str, &'a str), Option<PackageEntryRef<'r>>>>>;
+
+/// One lockfile's graph and registry, resolved any number of times
+#[derive(Debug)]
+pub struct Session<R> {
+    graph: Arc<FrozenGraph>,
+    registry: R,
+    root: Option<Symbol>,
+    paths: ResolutionCache,
+}
+
+impl<R: Registry> Session<R> {
+    /// Session resolving paths from `root` (a node id of `graph`)
+    ///
+    /// An unknown or absent root disables path resolution.
+    pub fn new(graph: Arc<FrozenGraph>, registry: R, root: Option<&str>, cache_capacity: usize) -> Self {
+        let root = root.and_then(|id| graph.symbols().get(id));
+        Self { graph, registry, root, paths: ResolutionCache::new(cache_capacity) }
+    }
+
+    /// Session over `lock`'s frozen graph and root
+    pub fn from_lockfile(lock: &Lockfile, registry: R) -> Self {
+        let graph = Arc::new(lock.graph());
+        let capacity = lock.dependencies.len().max(1);
+        Self::new(graph, registry, lock.root.as_deref(), capacity)
+    }
+
+    /// The frozen graph every worker reads
+    pub fn graph(&self) -> &FrozenGraph {
+        &self.graph
+    }
+
+    /// Resolve one dependency, O(log n) plus one cached path search
+    pub fn resolve(&self, dep: &Dependency) -> Resolution<'_> {
+        match self.registry.max_satisfying(&dep.name, &dep.req) {
+            Some(entry) => Resolution::Pinned { path: self.path_to(dep, entry.version), entry },
+            None => Resolution::Unsatisfied,
+        }
+    }
+
+    fn path_to(&self, dep: &Dependency, version: &str) -> Option<SymbolPath> {
+        let root = self.root?;
+        let goal = self.graph.symbols().get(&dep.node_id(version))?;
+        self.paths.resolve_symbols(&*self.graph, root, goal, ResolutionStrategy::AStar).ok().flatten()
+    }
+
+    /// Resolve every dependency of `lock` in parallel, streaming NDJSON
+    ///
+    /// Workers claim `config.chunk` entries at a time from a shared
+    /// cursor, so fast and slow entries balance across threads without
+    /// a scheduler. Output is flushed whenever the writer catches up
+    /// with the workers. A write error stops the run and is returned.
+    pub fn resolve_all(&self, lock: &Lockfile, out: impl Write, config: &RunConfig) -> io::Result<Summary> {
+        let deps = &lock.dependencies;
+        let chunk = config.chunk.max(1);
+        let next = AtomicUsize::new(0);
+        let stop = AtomicBool::new(false);
+        let memo: Memo<'_, '_> = (0..MEMO_SHARDS).map(|_| Mutex::new(HashMap::new())).collect();
+        let (done_tx, done_rx) = mpsc::sync_channel::<(usize, Outcome, String)>(config.queue_depth.max(1));
+
+        let written = thread::scope(|scope| {
+            for _ in 0..config.threads.clamp(1, deps.len().max(1)) {
+                let (done, next, stop, memo) = (done_tx.clone(), &next, &stop, &memo);
+                scope.spawn(move || {
+                    while !stop.load(Ordering::Relaxed) {
+                        let first = next.fetch_add(chunk, Ordering::Relaxed);
+                        if first >= deps.len() {
+                            return;
+                        }
+                        for (i, dep) in deps.iter().enumerate().skip(first).take(chunk) {
+                            let resolution = self.resolve_memo(dep, memo);
+                            let line = self.render(i, dep, &resolution);
+                            if done.send((i, Outcome::of(&resolution), line)).is_err() {
+                                return;
+                            }
+                        }
+                    }
+                });
+            }
+            drop(done_tx);
+            let written = write_lines(done_rx, out, config.ordered);
+            if written.is_err() {
+                stop.store(true, Ordering::Relaxed);
+            }
+            written
+        });
+
+        let mut summary = written?;
+        summary.cache = self.paths.stats();
+        Ok(summary)
+    }
+
+    fn resolve_memo<'a>(&'a self, dep: &'a Dependency, memo: &Memo<'a, 'a>) -> Resolution<'a> {
+        let key = (dep.name.as_str(), dep.req.as_str());
+        let mut hasher = DefaultHasher::new();
+        key.hash(&mut hasher);
+        let shard = &memo[hasher.finish() as usize % MEMO_SHARDS];
+        let cached = shard.lock().unwrap().get(&key).copied();
+        let entry = match cached {
+            Some(entry) => entry,
+            None => {
+                let entry = self.registry.max_satisfying(key.0, key.1);
+                shard.lock().unwrap().insert(key, entry);
+                entry
+            }
+        };
+        match entry {
+            Some(entry) => Resolution::Pinned { path: self.path_to(dep, entry.version), entry },
+            None => Resolution::Unsatisfied,
+        }
+    }
+
+    /// NDJSON line (without the newline) for entry `index`
+    pub fn render(&self, index: usize, dep: &Dependency, resolution: &Resolution<'_>) -> String {
+        let mut line = format!("{{\"index\":{},\"name\":", index);
+        push_json_str(&mut line, &dep.name);
+        line.push_str(",\"req\":");
+        push_json_str(&mut line, &dep.req);
+        match resolution {
+            Resolution::Pinned { entry, path } => {
+                line.push_str(",\"version\":");
+                push_json_str(&mut line, entry.version);
+                line.push_str(",\"tarball\":\"");
+                for byte in entry.tarball_hash {
+                    let _ = write!(line, "{:02x}", byte);
+                }
+                line.push_str("\",\"path\":");
+                match path {
+                    Some(path) => {
+                        line.push('[');
+                        for (i, &sym) in path.nodes.iter().enumerate() {
+                            if i > 0 {
+                                line.push(',');
+                            }
+                            push_json_str(&mut line, self.graph.symbols().resolve(sym));
+                        }
+                        let _ = write!(line, "],\"cost\":{}", path.cost);
+                    }
+                    None => line.push_str("null"),
+                }
+            }
+            Resolution::Unsatisfied => line.push_str(",\"error\":\"no version satisfies the requirement\""),
+        }
+        line.push('}');
+        line
+    }
+}
+
+/// What a rendered line counts toward in the `Summary`
+#[derive(Debug, Clone, Copy)]
+enum Outcome {
+    Resolved { reached: bool },
+    Failed,
+}
+
+impl Outcome {
+    fn of(resolution: &Resolution<'_>) -> Self {
+        match resolution {
+            Resolution::Pinned { path, .. } => Outcome::Resolved { reached: path.is_some() },
+            Resolution::Unsatisfied => Outcome::Failed,
+        }
+    }
+}
+
+/// Writer side of `resolve_all`: drain lines, flush when idle
+fn write_lines(lines: Receiver<(usize, Outcome, String)>, out: impl Write, ordered: bool) -> io::Result<Summary> {
+    let mut out = BufWriter::new(out);
+    let mut summary = Summary::default();
+    let mut pending = BTreeMap::new();
+    let mut due = 0;
+    loop {
+        let (i, outcome, line) = match lines.try_recv() {
+            Ok(message) => message,
+            Err(TryRecvError::Empty) => {
+                out.flush()?;
+                match lines.recv() {
+                    Ok(message) => message,
+                    Err(_) => break,
+                }
+            }
+            Err(TryRecvError::Disconnected) => break,
+        };
+        match outcome {
+            Outcome::Resolved { reached } => {
+                summary.resolved += 1;
+                summary.unreachable += usize::from(!reached);
+            }
+            Outcome::Failed => summary.failed += 1,
+        }
+        if !ordered {
+            writeln!(out, "{}", line)?;
+            continue;
+        }
+        pending.insert(i, line);
+        while let Some(line) = pending.remove(&due) {
+            writeln!(out, "{}", line)?;
+            due += 1;
+        }
+    }
+    out.flush()?;
+    Ok(summary)
+}
+
+/// Append `s` as a JSON string literal
+fn push_json_str(out: &mut String, s: &str) {
+    out.push('"');
+    for c in s.chars() {
+        match c {
+            '"' => out.push_str("\\\""),
+            '\\' => out.push_str("\\\\"),
+            '\n' => out.push_str("\\n"),
+            c if c < ' ' => {
+                let _ = write!(out, "\\u{:04x}", c as u32);
+            }
+            c => out.push(c),
+        }
+    }
+    out.push('"');
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::registry::PackageEntry;
+
+    fn registry() -> PackageRegistry {
+        let mut registry = PackageRegistry::new();
+        for (name, version) in [("left-pad", "1.2.0"), ("left-pad", "1.2.3"), ("left-pad", "2.0.0"), ("chalk", "2.0.1")] {
+            registry.publish(PackageEntry {
+                name: name.to_string(),
+                version: version.to_string(),
+                tarball_hash: vec![0xab, version.len() as u8],
+                signature: Vec::new(),
+            });
+        }
+        registry
+    }
+
+    fn lockfile(copies: usize) -> Lockfile {
+        let mut text = String::from("root app@1.0.0\nedge app@1.0.0 chalk@2.0.1\nedge chalk@2.0.1 left-pad@1.2.3\n");
+        for _ in 0..copies {
+            text.push_str("dep left-pad ^1.2\ndep chalk ~2.0\ndep chalk ^9\ndep left-pad ^2\n");
+        }
+        Lockfile::parse(&text).unwrap()
+    }
+
+    #[test]
+    fn test_resolve_renders_ndjson() {
+        let lock = lockfile(1);
+        let session = Session::from_lockfile(&lock, registry());
+        let line = |i: usize| session.render(i, &lock.dependencies[i], &session.resolve(&lock.dependencies[i]));
+        assert_eq!(
+            line(0),
+            "{\"index\":0,\"name\":\"left-pad\",\"req\":\"^1.2\",\"version\":\"1.2.3\",\"tarball\":\"ab05\",\
+             \"path\":[\"app@1.0.0\",\"chalk@2.0.1\",\"left-pad@1.2.3\"],\"cost\":2}"
+        );
+        assert_eq!(line(2), "{\"index\":2,\"name\":\"chalk\",\"req\":\"^9\",\"error\":\"no version satisfies the requirement\"}");
+        assert!(line(3).ends_with("\"version\":\"2.0.0\",\"tarball\":\"ab05\",\"path\":null}"));
+
+        let mut escaped = String::new();
+        push_json_str(&mut escaped, "a\"b\\c\u{1}");
+        assert_eq!(escaped, "\"a\\\"b\\\\c\\u0001\"");
+    }
+
+    #[test]
+    fn test_resolve_all_streams_every_entry() {
+        let lock = lockfile(250);
+        let session = Session::from_lockfile(&lock, registry());
+        let expected: Vec<String> = lock
+            .dependencies
+            .iter()
+            .enumerate()
+            .map(|(i, dep)| session.render(i, dep, &session.resolve(dep)))
+            .collect();
+
+        for ordered in [false, true] {
+            let config = RunConfig { threads: 4, chunk: 7, queue_depth: 8, ordered };
+            let mut out = Vec::new();
+            let summary = session.resolve_all(&lock, &mut out, &config).unwrap();
+            assert_eq!((summary.resolved, summary.failed, summary.unreachable), (750, 250, 250));
+            assert!(summary.cache.hits > 0);
+
+            let mut lines: Vec<String> = String::from_utf8(out).unwrap().lines().map(String::from).collect();
+            if ordered {
+                assert_eq!(lines, expected);
+            } else {
+                let index = |l: &String| l[9..].split(',').next().unwrap().parse::<usize>().unwrap();
+                lines.sort_by_key(index);
+                assert_eq!(lines, expected);
+            }
+        }
+    }
+
+    #[test]
+    fn test_write_error_stops_the_run() {
+        struct Broken;
+        impl Write for Broken {
+            fn write(&mut self, _: &[u8]) -> io::Result<usize> {
+                Err(io::Error::new(io::ErrorKind::BrokenPipe, "closed"))
+            }
+            fn flush(&mut self) -> io::Result<()> {
+                Ok(())
+            }
+        }
+        let lock = lockfile(1000);
+        let session = Session::from_lockfile(&lock, registry());
+        let config = RunConfig { threads: 2, chunk: 1, queue_depth: 1, ordered: false };
+        let err = session.resolve_all(&lock, Broken, &config).unwrap_err();
+        assert_eq!(err.kind(), io::ErrorKind::BrokenPipe);
+    }
+}
@@ -0,0 +1,151 @@
+//! Streaming SHA-256 for tarball and AST hashes
+//!
+//! Artifacts are hashed through one reused chunk buffer and never held
+//! in memory whole. `sha2` picks SHA-NI on x86 and the ARMv8 SHA2
+//! instructions on aarch64 at runtime, with a portable fallback. Several
+//! artifacts are hashed in parallel, one artifact per worker at a time.
+
+use std::fs::File;
+use std::io::{self, Read};
+use std::path::Path;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::thread;
+
+use sha2::{Digest, Sha256};
+
+/// Bytes read per chunk; large enough to amortize syscalls, small
+/// enough to stay in L2 between the read and the compression rounds
+pub const CHUNK: usize = 256 * 1024;
+
+/// SHA-256 output
+pub type Sha256Digest = [u8; 32];
+
+/// SHA-256 of an in-memory or memory-mapped buffer
+pub fn sha256(bytes: &[u8]) -> Sha256Digest {
+    Sha256::digest(bytes).into()
+}
+
+/// SHA-256 of everything `reader` yields, O(CHUNK) memory
+pub fn sha256_reader(reader: impl Read) -> io::Result<Sha256Digest> {
+    sha256_with(reader, &mut vec![0; CHUNK])
+}
+
+/// SHA-256 of a file, streamed
+pub fn sha256_file(path: impl AsRef<Path>) -> io::Result<Sha256Digest> {
+    sha256_reader(File::open(path)?)
+}
+
+/// SHA-256 of each reader, results in input order
+///
+/// Workers pull the next unhashed reader as they finish, so one huge
+/// tarball does not hold up the rest. Memory is one chunk buffer per
+/// worker regardless of artifact sizes.
+pub fn sha256_all<R: Read + Send>(readers: Vec<R>) -> Vec<io::Result<Sha256Digest>> {
+    let readers: Vec<Mutex<R>> = readers.into_iter().map(Mutex::new).collect();
+    hash_parallel(&readers, |reader, buf| sha256_with(&mut *reader.lock().unwrap(), buf))
+}
+
+/// SHA-256 of each file, streamed and hashed in parallel
+///
+/// Files are opened by the worker that hashes them, so at most one
+/// descriptor per worker is open at a time.
+pub fn sha256_files<P: AsRef<Path> + Sync>(paths: &[P]) -> Vec<io::Result<Sha256Digest>> {
+    hash_parallel(paths, |path, buf| sha256_with(File::open(path)?, buf))
+}
+
+fn sha256_with(mut reader: impl Read, buf: &mut [u8]) -> io::Result<Sha256Digest> {
+    let mut hasher = Sha256::new();
+    loop {
+        match reader.read(buf) {
+            Ok(0) => return Ok(hasher.finalize().into()),
+            Ok(n) => hasher.update(&buf[..n]),
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(e),
+        }
+    }
+}
+
+/// Run `hash` over every item on a pool of scoped workers, each owning
+/// one chunk buffer; items are claimed one at a time from a shared counter
+fn hash_parallel<T: Sync>(
+    items: &[T],
+    hash: impl Fn(&T, &mut [u8]) -> io::Result<Sha256Digest> + Sync,
+) -> Vec<io::Result<Sha256Digest>> {
+    let threads = thread::available_parallelism().map_or(1, |n| n.get()).min(items.len());
+    if threads <= 1 {
+        let mut buf = vec![0; CHUNK];
+        return items.iter().map(|item| hash(item, &mut buf)).collect();
+    }
+
+    let next = AtomicUsize::new(0);
+    let mut done: Vec<(usize, io::Result<Sha256Digest>)> = thread::scope(|scope| {
+        let workers: Vec<_> = (0..threads)
+            .map(|_| {
+                scope.spawn(|| {
+                    let mut buf = vec![0; CHUNK];
+                    let mut done = Vec::new();
+                    loop {
+                        let i = next.fetch_add(1, Ordering::Relaxed);
+                        match items.get(i) {
+                            Some(item) => done.push((i, hash(item, &mut buf))),
+                            None => return done,
+                        }
+                    }
+                })
+            })
+            .collect();
+        workers.into_iter().flat_map(|worker| worker.join().unwrap()).collect()
+    });
+    done.sort_unstable_by_key(|&(i, _)| i);
+    done.into_iter().map(|(_, result)| result).collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Cursor;
+
+    /// Reader handing out at most 7 bytes per call
+    struct Trickle(Cursor<Vec<u8>>);
+
+    impl Read for Trickle {
+        fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+            let n = buf.len().min(7);
+            self.0.read(&mut buf[..n])
+        }
+    }
+
+    #[test]
+    fn test_streaming_matches_one_shot() {
+        let artifact: Vec<u8> = (0..CHUNK * 3 + 11).map(|i| (i * 31) as u8).collect();
+        let expected = sha256(&artifact);
+        assert_eq!(sha256_reader(artifact.as_slice()).unwrap(), expected);
+        assert_eq!(sha256_reader(Trickle(Cursor::new(b"abc".to_vec()))).unwrap(), sha256(b"abc"));
+
+        let artifacts: Vec<Vec<u8>> = (0..9).map(|n| artifact[..n * CHUNK / 3].to_vec()).collect();
+        let expected: Vec<_> = artifacts.iter().map(|a| sha256(a)).collect();
+        let hashed: Vec<_> = sha256_all(artifacts.iter().map(|a| a.as_slice()).collect())
+            .into_iter()
+            .map(Result::unwrap)
+            .collect();
+        assert_eq!(hashed, expected);
+
+        // SHA-256("abc") from FIPS 180-2
+        assert_eq!(sha256(b"abc")[..4], [0xba, 0x78, 0x16, 0xbf]);
+    }
+
+    #[test]
+    fn test_files_keep_order_and_report_errors() {
+        let dir = std::env::temp_dir();
+        let present = dir.join(format!("semverx-digest-{}", std::process::id()));
+        std::fs::write(&present, b"tarball").unwrap();
+        let missing = dir.join("semverx-digest-missing");
+
+        let results = sha256_files(&[&present, &missing, &present]);
+        std::fs::remove_file(&present).unwrap();
+        assert_eq!(results[0].as_ref().unwrap(), &sha256(b"tarball"));
+        assert!(results[1].is_err());
+        assert_eq!(results[2].as_ref().unwrap(), &sha256(b"tarball"));
+    }
+}
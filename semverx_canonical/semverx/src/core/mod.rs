@@ -0,0 +1,7 @@
+//! Core SemVerX primitives
+//! 
+//! Content digests and the native FFI boundary; the version types
+//! themselves live at the crate root
+
+pub mod digest;
+pub mod nnffi;
@@ -0,0 +1,274 @@
+//! Records and kernels shared by every channel binding
+//!
+//! Records are `#[repr(C)]`, 16 bytes and 4-byte aligned, so clients
+//! can lay them out in a typed array (`Uint32Array`, `ctypes` array,
+//! numpy structured array) and hand over the pointer. The kernels work
+//! on borrowed slices and caller-owned outputs only; nothing here
+//! allocates.
+
+use crate::nlm::ast::{RangeAst, RangeOp};
+use crate::registry::avl_tree::LANES;
+use crate::registry::VersionReq;
+use crate::{Channel, PackedVersion, SemVerX};
+
+/// `RangeRecord::channel` value for "any channel"
+pub const ANY_CHANNEL: u8 = 0xff;
+
+/// `max_satisfying` output when no candidate satisfies the range
+pub const NO_MATCH: u32 = u32::MAX;
+
+/// Outcome of an FFI call; negative values are errors
+#[repr(i32)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Status {
+    /// Success
+    Ok = 0,
+    /// A required pointer was null
+    NullPointer = -1,
+    /// A record holds an unknown channel, operator or component count
+    BadRecord = -2,
+    /// An output buffer is shorter than the call needs
+    OutputTooSmall = -3,
+    /// Shared memory is too small, misaligned or has a bad header
+    BadRing = -4,
+}
+
+/// `major.minor.patch(channel)`, with the channel as `Channel as u32`
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct VersionRecord {
+    /// Major version
+    pub major: u32,
+    /// Minor version
+    pub minor: u32,
+    /// Patch version
+    pub patch: u32,
+    /// Channel code 0-3 (legacy, experimental, stable, lts)
+    pub channel: u32,
+}
+
+impl VersionRecord {
+    /// Record for a parsed version
+    pub fn new(version: &SemVerX) -> Self {
+        Self { major: version.major, minor: version.minor, patch: version.patch, channel: version.channel as u32 }
+    }
+
+    /// Packed key, or `None` for an unknown channel code
+    pub fn pack(&self) -> Option<PackedVersion> {
+        let channel = u8::try_from(self.channel).ok().and_then(Channel::try_from_code)?;
+        Some(PackedVersion::new(self.major, self.minor, self.patch, channel))
+    }
+}
+
+/// A range as the NLM parser's `RangeAst`, in C layout
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct RangeRecord {
+    /// 0 caret, 1 tilde, 2 exact, 3 at-least, 4 any
+    pub op: u8,
+    /// Components written, 0-3
+    pub given: u8,
+    /// Channel pin 0-3, or `ANY_CHANNEL`
+    pub channel: u8,
+    /// Must be 0
+    pub reserved: u8,
+    /// Major, minor, patch; unwritten components are 0
+    pub parts: [u32; 3],
+}
+
+impl RangeRecord {
+    /// Record for a parsed range
+    pub fn new(ast: &RangeAst) -> Self {
+        let op = match ast.op {
+            RangeOp::Caret => 0,
+            RangeOp::Tilde => 1,
+            RangeOp::Exact => 2,
+            RangeOp::AtLeast => 3,
+            RangeOp::Any => 4,
+        };
+        let channel = ast.channel.map_or(ANY_CHANNEL, |channel| channel as u8);
+        Self { op, given: ast.given, channel, reserved: 0, parts: ast.parts }
+    }
+
+    /// The requirement, or `None` for a malformed record
+    pub fn to_req(&self) -> Option<VersionReq> {
+        let op = match self.op {
+            0 => RangeOp::Caret,
+            1 => RangeOp::Tilde,
+            2 => RangeOp::Exact,
+            3 => RangeOp::AtLeast,
+            4 => RangeOp::Any,
+            _ => return None,
+        };
+        let channel = match self.channel {
+            ANY_CHANNEL => None,
+            code => Some(Channel::try_from_code(code)?),
+        };
+        (self.given <= 3 && self.reserved == 0)
+            .then(|| VersionReq::from_ast(&RangeAst { op, parts: self.parts, given: self.given, channel }))
+    }
+}
+
+/// Candidate keys packed on the stack, one block at a time
+fn blocks(candidates: &[VersionRecord]) -> impl Iterator<Item = Result<([PackedVersion; LANES], usize), Status>> + '_ {
+    candidates.chunks(LANES).map(|records| {
+        let mut keys = [PackedVersion::new(0, 0, 0, Channel::Legacy); LANES];
+        for (key, record) in keys.iter_mut().zip(records) {
+            *key = record.pack().ok_or(Status::BadRecord)?;
+        }
+        Ok((keys, records.len()))
+    })
+}
+
+/// Number of 64-bit mask words per range in `match_masks`
+pub fn mask_words(candidates: usize) -> usize {
+    candidates.div_ceil(LANES)
+}
+
+/// For each range, a bit mask of the candidates satisfying it
+///
+/// `out` holds `mask_words(candidates.len())` words per range, range
+/// after range; bit `i % 64` of word `i / 64` stands for candidate `i`.
+/// Candidates are packed once per block and matched against every
+/// range while still in registers and L1.
+pub fn match_masks(candidates: &[VersionRecord], ranges: &[RangeRecord], out: &mut [u64]) -> Status {
+    let words = mask_words(candidates.len());
+    if out.len() < words * ranges.len() {
+        return Status::OutputTooSmall;
+    }
+    let mut reqs = [None; LANES];
+    for group in (0..ranges.len()).step_by(LANES) {
+        let group_ranges = &ranges[group..ranges.len().min(group + LANES)];
+        for (req, range) in reqs.iter_mut().zip(group_ranges) {
+            *req = match range.to_req() {
+                Some(req) => Some(req),
+                None => return Status::BadRecord,
+            };
+        }
+        for (block, packed) in blocks(candidates).enumerate() {
+            let (keys, len) = match packed {
+                Ok(packed) => packed,
+                Err(status) => return status,
+            };
+            for (r, req) in reqs.iter().take(group_ranges.len()).flatten().enumerate() {
+                out[(group + r) * words + block] = req.match_mask(&keys[..len]);
+            }
+        }
+    }
+    Status::Ok
+}
+
+/// For each range, the index of the highest satisfying candidate, or `NO_MATCH`
+///
+/// Candidates need not be sorted; ties go to the first occurrence.
+pub fn max_satisfying(candidates: &[VersionRecord], ranges: &[RangeRecord], out: &mut [u32]) -> Status {
+    if out.len() < ranges.len() {
+        return Status::OutputTooSmall;
+    }
+    for (slot, range) in out.iter_mut().zip(ranges) {
+        let Some(req) = range.to_req() else { return Status::BadRecord };
+        let mut best: Option<(PackedVersion, u32)> = None;
+        for (block, packed) in blocks(candidates).enumerate() {
+            let (keys, len) = match packed {
+                Ok(packed) => packed,
+                Err(status) => return status,
+            };
+            let mut mask = req.match_mask(&keys[..len]);
+            while mask != 0 {
+                let lane = mask.trailing_zeros() as usize;
+                if best.is_none_or(|(key, _)| keys[lane] > key) {
+                    best = Some((keys[lane], (block * LANES + lane) as u32));
+                }
+                mask &= mask - 1;
+            }
+        }
+        *slot = best.map_or(NO_MATCH, |(_, index)| index);
+    }
+    Status::Ok
+}
+
+/// Parse `count` versions from one text buffer
+///
+/// Version `i` is `text[offsets[i]..offsets[i + 1]]`, so `offsets`
+/// holds `count + 1` entries. Unparseable versions get channel
+/// `u32::MAX` in `out`. Returns how many failed to parse.
+pub fn parse_versions(text: &[u8], offsets: &[u32], out: &mut [VersionRecord]) -> Result<usize, Status> {
+    let count = offsets.len().saturating_sub(1);
+    if out.len() < count {
+        return Err(Status::OutputTooSmall);
+    }
+    let mut failed = 0;
+    for (record, span) in out.iter_mut().zip(offsets.windows(2)) {
+        let bytes = text.get(span[0] as usize..span[1] as usize).ok_or(Status::BadRecord)?;
+        let parsed = std::str::from_utf8(bytes).ok().and_then(SemVerX::parse);
+        *record = match parsed {
+            Some(version) => VersionRecord::new(&version),
+            None => {
+                failed += 1;
+                VersionRecord { channel: u32::MAX, ..VersionRecord::default() }
+            }
+        };
+    }
+    Ok(failed)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::nlm::parser::parse_range;
+
+    fn record(version: &str) -> VersionRecord {
+        VersionRecord::new(&SemVerX::parse(version).unwrap())
+    }
+
+    fn range(expr: &str) -> RangeRecord {
+        RangeRecord::new(&parse_range(expr.as_bytes()).unwrap())
+    }
+
+    #[test]
+    fn test_batch_kernels_match_version_req() {
+        let versions: Vec<String> = (0..150)
+            .map(|i| format!("{}.{}.{}({})", i % 3, i % 7, i % 5, ["stable", "lts", "legacy"][i % 3]))
+            .collect();
+        let candidates: Vec<VersionRecord> = versions.iter().map(|v| record(v)).collect();
+        let exprs = ["^1.2", "~0.3(lts)", "*", ">=2.6", "=1"];
+        let ranges: Vec<RangeRecord> = exprs.iter().map(|e| range(e)).collect();
+
+        let words = mask_words(candidates.len());
+        let mut masks = vec![0u64; words * ranges.len()];
+        assert_eq!(match_masks(&candidates, &ranges, &mut masks), Status::Ok);
+        let mut best = vec![0u32; ranges.len()];
+        assert_eq!(max_satisfying(&candidates, &ranges, &mut best), Status::Ok);
+
+        for (r, expr) in exprs.iter().enumerate() {
+            let req = VersionReq::parse(expr).unwrap();
+            let parsed: Vec<SemVerX> = versions.iter().map(|v| SemVerX::parse(v).unwrap()).collect();
+            for (i, version) in parsed.iter().enumerate() {
+                let bit = masks[r * words + i / 64] >> (i % 64) & 1 == 1;
+                assert_eq!(bit, req.matches(version), "{} against {}", expr, versions[i]);
+            }
+            let expected = (0..parsed.len())
+                .filter(|&i| req.matches(&parsed[i]))
+                .fold(None, |best: Option<usize>, i| match best {
+                    Some(b) if parsed[b] >= parsed[i] => Some(b),
+                    _ => Some(i),
+                });
+            assert_eq!(best[r], expected.map_or(NO_MATCH, |i| i as u32), "{}", expr);
+        }
+
+        assert_eq!(match_masks(&candidates, &ranges, &mut masks[1..]), Status::OutputTooSmall);
+        let bad = RangeRecord { op: 9, ..ranges[0] };
+        assert_eq!(max_satisfying(&candidates, &[bad], &mut best), Status::BadRecord);
+    }
+
+    #[test]
+    fn test_parse_versions_from_one_buffer() {
+        let text = b"1.2.3nope0.1.0(lts)";
+        let mut out = [VersionRecord::default(); 3];
+        assert_eq!(parse_versions(text, &[0, 5, 9, 19], &mut out), Ok(1));
+        assert_eq!(out[0], record("1.2.3"));
+        assert_eq!(out[1].channel, u32::MAX);
+        assert_eq!(out[2], record("0.1.0(lts)"));
+        assert_eq!(parse_versions(text, &[0, 40], &mut out), Err(Status::BadRecord));
+    }
+}
@@ -0,0 +1,338 @@
+//! Experimental shared-memory request ring
+//!
+//! A long-running Node or Python client maps one shared region and
+//! attaches it once with `semverx_ring_start`. From then on it submits
+//! `max_satisfying` queries by writing slots and bumping a counter,
+//! with no FFI crossing per query. A server thread on this side polls
+//! the region and answers in place.
+//!
+//! The region is an array of native-endian 32-bit words:
+//!
+//! | words            | contents                                        |
+//! |------------------|-------------------------------------------------|
+//! | 0..4             | magic `RING_MAGIC`, `RING_VERSION`, slot count (power of two), 0 |
+//! | 16               | submitted: queries written by the client         |
+//! | 32               | completed: queries answered by the server        |
+//! | 64..             | slots of 16 words each                          |
+//! | after the slots  | candidate arena of `VersionRecord`s (4 words each) |
+//!
+//! A slot holds a `RangeRecord` (words 0..4), the first candidate and
+//! the candidate count within the arena (4, 5), and on completion the
+//! answer's offset from that first candidate or `NO_MATCH` (6) and a
+//! `Status` (7).
+//!
+//! The client may fill slot `submitted % slots` while `submitted -
+//! completed < slots`, then publishes it by storing `submitted + 1`
+//! with release ordering. Query `n` is answered once `completed > n`
+//! (loaded with acquire ordering), after which its slot may be reused.
+
+use std::slice;
+use std::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+use std::sync::Arc;
+use std::thread::{self, JoinHandle};
+use std::time::Duration;
+
+use super::super::bind::{RangeRecord, Status, VersionRecord, NO_MATCH};
+use crate::registry::avl_tree::LANES;
+use crate::{Channel, PackedVersion};
+
+/// First header word of an attached region
+pub const RING_MAGIC: u32 = u32::from_le_bytes(*b"SVXR");
+
+/// Layout version in the second header word
+pub const RING_VERSION: u32 = 1;
+
+const SUBMITTED: usize = 16;
+const COMPLETED: usize = 32;
+const SLOTS: usize = 64;
+const SLOT_WORDS: usize = 16;
+const RECORD_WORDS: usize = 4;
+
+/// Polls that spin before the server starts yielding, then sleeping
+const SPINS: u32 = 256;
+const YIELDS: u32 = 64;
+const IDLE_SLEEP: Duration = Duration::from_micros(50);
+
+/// Typed view of a request ring over shared words
+#[derive(Debug, Clone, Copy)]
+pub struct ShmRing<'a> {
+    words: &'a [AtomicU32],
+    slots: usize,
+}
+
+impl<'a> ShmRing<'a> {
+    /// Words needed for `slots` slots plus `arena` candidate records
+    pub fn words_for(slots: usize, arena: usize) -> usize {
+        SLOTS + slots * SLOT_WORDS + arena * RECORD_WORDS
+    }
+
+    /// Write a fresh header with `slots` slots (a power of two) and attach
+    pub fn init(words: &'a [AtomicU32], slots: usize) -> Result<Self, Status> {
+        if !slots.is_power_of_two() || words.len() < Self::words_for(slots, 0) || slots > u32::MAX as usize {
+            return Err(Status::BadRing);
+        }
+        for (word, value) in words.iter().zip([RING_MAGIC, RING_VERSION, slots as u32, 0]) {
+            word.store(value, Ordering::Relaxed);
+        }
+        words[SUBMITTED].store(0, Ordering::Relaxed);
+        words[COMPLETED].store(0, Ordering::Release);
+        Self::attach(words)
+    }
+
+    /// Attach to a region whose header is already written
+    pub fn attach(words: &'a [AtomicU32]) -> Result<Self, Status> {
+        if words.len() < SLOTS
+            || words[0].load(Ordering::Acquire) != RING_MAGIC
+            || words[1].load(Ordering::Relaxed) != RING_VERSION
+        {
+            return Err(Status::BadRing);
+        }
+        let slots = words[2].load(Ordering::Relaxed) as usize;
+        if !slots.is_power_of_two() || words.len() < Self::words_for(slots, 0) {
+            return Err(Status::BadRing);
+        }
+        Ok(Self { words, slots })
+    }
+
+    /// Candidate records the arena holds
+    pub fn arena_len(&self) -> usize {
+        (self.words.len() - Self::words_for(self.slots, 0)) / RECORD_WORDS
+    }
+
+    /// Store `record` at arena position `at` (client side)
+    pub fn write_candidate(&self, at: usize, record: &VersionRecord) {
+        let base = Self::words_for(self.slots, at);
+        for (word, value) in self.words[base..base + RECORD_WORDS]
+            .iter()
+            .zip([record.major, record.minor, record.patch, record.channel])
+        {
+            word.store(value, Ordering::Relaxed);
+        }
+    }
+
+    /// Queue a query over arena records `first..first + count` (client side)
+    ///
+    /// Returns its sequence number, or `None` while every slot is in flight.
+    pub fn submit(&self, range: &RangeRecord, first: u32, count: u32) -> Option<u32> {
+        let seq = self.words[SUBMITTED].load(Ordering::Relaxed);
+        if seq.wrapping_sub(self.words[COMPLETED].load(Ordering::Acquire)) as usize >= self.slots {
+            return None;
+        }
+        let slot = self.slot(seq);
+        let head = u32::from_ne_bytes([range.op, range.given, range.channel, range.reserved]);
+        let values = [head, range.parts[0], range.parts[1], range.parts[2], first, count, NO_MATCH, Status::Ok as u32];
+        for (word, value) in slot.iter().zip(values) {
+            word.store(value, Ordering::Relaxed);
+        }
+        self.words[SUBMITTED].store(seq.wrapping_add(1), Ordering::Release);
+        Some(seq)
+    }
+
+    /// Answer to query `seq` once the server has completed it (client side)
+    pub fn result(&self, seq: u32) -> Option<Result<u32, i32>> {
+        let completed = self.words[COMPLETED].load(Ordering::Acquire);
+        // Completed iff seq lies in the window of the last `slots` answers
+        if completed.wrapping_sub(seq).wrapping_sub(1) as usize >= self.slots {
+            return None;
+        }
+        let slot = self.slot(seq);
+        match slot[7].load(Ordering::Relaxed) as i32 {
+            0 => Some(Ok(slot[6].load(Ordering::Relaxed))),
+            status => Some(Err(status)),
+        }
+    }
+
+    /// Answer every submitted query (server side); returns how many
+    pub fn serve_pending(&self) -> usize {
+        let submitted = self.words[SUBMITTED].load(Ordering::Acquire);
+        let mut completed = self.words[COMPLETED].load(Ordering::Relaxed);
+        let mut served = 0;
+        while completed != submitted {
+            let slot = self.slot(completed);
+            let (answer, status) = match self.answer(slot) {
+                Ok(index) => (index, Status::Ok),
+                Err(status) => (NO_MATCH, status),
+            };
+            slot[6].store(answer, Ordering::Relaxed);
+            slot[7].store(status as i32 as u32, Ordering::Relaxed);
+            completed = completed.wrapping_add(1);
+            self.words[COMPLETED].store(completed, Ordering::Release);
+            served += 1;
+        }
+        served
+    }
+
+    /// Serve until `stop` is set, spinning, then yielding, then sleeping while idle
+    pub fn serve(&self, stop: &AtomicBool) {
+        let mut idle = 0u32;
+        while !stop.load(Ordering::Acquire) {
+            if self.serve_pending() > 0 {
+                idle = 0;
+                continue;
+            }
+            idle = idle.saturating_add(1);
+            if idle < SPINS {
+                std::hint::spin_loop();
+            } else if idle < SPINS + YIELDS {
+                thread::yield_now();
+            } else {
+                thread::park_timeout(IDLE_SLEEP);
+            }
+        }
+    }
+
+    fn slot(&self, seq: u32) -> &'a [AtomicU32] {
+        let base = SLOTS + (seq as usize & (self.slots - 1)) * SLOT_WORDS;
+        &self.words[base..base + SLOT_WORDS]
+    }
+
+    fn answer(&self, slot: &[AtomicU32]) -> Result<u32, Status> {
+        let [op, given, channel, reserved] = slot[0].load(Ordering::Relaxed).to_ne_bytes();
+        let parts = [1, 2, 3].map(|i| slot[i].load(Ordering::Relaxed));
+        let req = RangeRecord { op, given, channel, reserved, parts }.to_req().ok_or(Status::BadRecord)?;
+        let (first, count) = (slot[4].load(Ordering::Relaxed) as usize, slot[5].load(Ordering::Relaxed) as usize);
+        if first.checked_add(count).is_none_or(|end| end > self.arena_len()) {
+            return Err(Status::BadRecord);
+        }
+
+        let mut best: Option<(PackedVersion, u32)> = None;
+        let mut keys = [PackedVersion::new(0, 0, 0, Channel::Legacy); LANES];
+        for block in (0..count).step_by(LANES) {
+            let len = LANES.min(count - block);
+            for (lane, key) in keys[..len].iter_mut().enumerate() {
+                let base = Self::words_for(self.slots, first + block + lane);
+                let [major, minor, patch, channel] = [0, 1, 2, 3].map(|i| self.words[base + i].load(Ordering::Relaxed));
+                *key = VersionRecord { major, minor, patch, channel }.pack().ok_or(Status::BadRecord)?;
+            }
+            let mut mask = req.match_mask(&keys[..len]);
+            while mask != 0 {
+                let lane = mask.trailing_zeros() as usize;
+                if best.is_none_or(|(key, _)| keys[lane] > key) {
+                    best = Some((keys[lane], (block + lane) as u32));
+                }
+                mask &= mask - 1;
+            }
+        }
+        Ok(best.map_or(NO_MATCH, |(_, index)| index))
+    }
+}
+
+/// Server thread attached to one region, returned by `semverx_ring_start`
+#[derive(Debug)]
+pub struct RingServer {
+    stop: Arc<AtomicBool>,
+    thread: JoinHandle<()>,
+}
+
+/// Write a fresh ring header into `mem` (`words` 32-bit words) with `slots` slots
+///
+/// # Safety
+/// `mem` must be 4-byte aligned and valid for `words` words; other
+/// processes may map it, but none may use the ring until this returns.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ring_init(mem: *mut u32, words: usize, slots: u32) -> i32 {
+    if mem.is_null() || mem.align_offset(4) != 0 {
+        return Status::NullPointer as i32;
+    }
+    // SAFETY: aligned and valid for `words` words per the contract; AtomicU32 has u32's layout
+    let region = unsafe { slice::from_raw_parts(mem as *const AtomicU32, words) };
+    match ShmRing::init(region, slots as usize) {
+        Ok(_) => Status::Ok as i32,
+        Err(status) => status as i32,
+    }
+}
+
+/// Start a server thread answering queries on an initialized region
+///
+/// Returns null if the region is not a valid ring.
+///
+/// # Safety
+/// `mem` must be 4-byte aligned and remain valid for `words` words
+/// until the returned handle is passed to `semverx_ring_stop`.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ring_start(mem: *mut u32, words: usize) -> *mut RingServer {
+    if mem.is_null() || mem.align_offset(4) != 0 {
+        return std::ptr::null_mut();
+    }
+    // SAFETY: per the contract the region outlives the server, which
+    // `semverx_ring_stop` joins before the caller may release it
+    let region: &'static [AtomicU32] = unsafe { slice::from_raw_parts(mem as *const AtomicU32, words) };
+    if ShmRing::attach(region).is_err() {
+        return std::ptr::null_mut();
+    }
+    let stop = Arc::new(AtomicBool::new(false));
+    let thread = {
+        let stop = Arc::clone(&stop);
+        thread::spawn(move || {
+            if let Ok(ring) = ShmRing::attach(region) {
+                ring.serve(&stop);
+            }
+        })
+    };
+    Box::into_raw(Box::new(RingServer { stop, thread }))
+}
+
+/// Stop and join a server started by `semverx_ring_start`
+///
+/// # Safety
+/// `server` must come from `semverx_ring_start` and not be stopped twice.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ring_stop(server: *mut RingServer) {
+    if server.is_null() {
+        return;
+    }
+    // SAFETY: produced by Box::into_raw in semverx_ring_start, released once
+    let server = unsafe { Box::from_raw(server) };
+    server.stop.store(true, Ordering::Release);
+    server.thread.thread().unpark();
+    let _ = server.thread.join();
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::nlm::parser::parse_range;
+    use crate::SemVerX;
+
+    fn range(expr: &str) -> RangeRecord {
+        RangeRecord::new(&parse_range(expr.as_bytes()).unwrap())
+    }
+
+    #[test]
+    fn test_client_and_server_over_shared_words() {
+        let words: Vec<AtomicU32> = (0..ShmRing::words_for(4, 100)).map(|_| AtomicU32::new(0)).collect();
+        let ring = ShmRing::init(&words, 4).unwrap();
+        assert_eq!(ring.arena_len(), 100);
+        for i in 0..100u32 {
+            let version = SemVerX::parse(&format!("{}.{}.0", i / 10, i % 10)).unwrap();
+            ring.write_candidate(i as usize, &VersionRecord::new(&version));
+        }
+
+        let stop = AtomicBool::new(false);
+        thread::scope(|scope| {
+            scope.spawn(|| ShmRing::attach(&words).unwrap().serve(&stop));
+            let queries = [("^3", 0, 100, Ok(39)), ("~5.2", 0, 100, Ok(52)), ("^3", 50, 50, Ok(NO_MATCH)), ("^1", 95, 10, Err(-2))];
+            for round in 0..50 {
+                let (expr, first, count, expected) = queries[round % queries.len()];
+                let seq = loop {
+                    if let Some(seq) = ring.submit(&range(expr), first, count) {
+                        break seq;
+                    }
+                    thread::yield_now();
+                };
+                let answer = loop {
+                    if let Some(answer) = ring.result(seq) {
+                        break answer;
+                    }
+                    thread::yield_now();
+                };
+                assert_eq!(answer, expected, "{} round {}", expr, round);
+            }
+            stop.store(true, Ordering::Release);
+        });
+        assert!(ShmRing::attach(&words[..10]).is_err());
+    }
+}
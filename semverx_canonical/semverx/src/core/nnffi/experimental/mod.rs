@@ -0,0 +1,5 @@
+//! Experimental shared-memory channel
+
+pub mod bind;
+
+pub use bind::{RingServer, ShmRing};
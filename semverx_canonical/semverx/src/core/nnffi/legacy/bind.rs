@@ -0,0 +1,86 @@
+//! Legacy per-call C ABI
+//!
+//! One NUL-terminated string per argument and one crossing per query,
+//! kept for clients that predate the batch ABI. New clients should use
+//! the stable channel's batch calls.
+
+use std::ffi::{c_char, CStr};
+
+use super::super::bind::{Status, VersionRecord};
+use crate::registry::VersionReq;
+use crate::SemVerX;
+
+/// Borrow a C string as UTF-8
+///
+/// # Safety
+/// `ptr` must be null or a NUL-terminated string valid for `'a`.
+#[allow(unsafe_code)]
+unsafe fn text<'a>(ptr: *const c_char) -> Result<Option<&'a str>, Status> {
+    if ptr.is_null() {
+        return Err(Status::NullPointer);
+    }
+    // SAFETY: non-null and NUL-terminated per this function's contract
+    Ok(unsafe { CStr::from_ptr(ptr) }.to_str().ok())
+}
+
+/// 1 if `version` satisfies `range`, 0 if not or if either fails to parse
+///
+/// # Safety
+/// Both arguments must be NUL-terminated strings.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_satisfies(version: *const c_char, range: *const c_char) -> i32 {
+    // SAFETY: forwarded from this function's contract
+    match unsafe { (text(version), text(range)) } {
+        (Ok(version), Ok(range)) => {
+            let version = version.and_then(SemVerX::parse);
+            let req = range.and_then(VersionReq::parse);
+            matches!((version, req), (Some(version), Some(req)) if req.matches(&version)) as i32
+        }
+        _ => Status::NullPointer as i32,
+    }
+}
+
+/// Parse one version into `out`; returns 1 on success, 0 if it does not parse
+///
+/// # Safety
+/// `version` must be a NUL-terminated string and `out` valid for one write.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_parse_version(version: *const c_char, out: *mut VersionRecord) -> i32 {
+    if out.is_null() {
+        return Status::NullPointer as i32;
+    }
+    // SAFETY: forwarded from this function's contract
+    match unsafe { text(version) } {
+        Ok(text) => match text.and_then(SemVerX::parse) {
+            Some(version) => {
+                // SAFETY: non-null and valid for one write per the contract
+                unsafe { out.write(VersionRecord::new(&version)) };
+                1
+            }
+            None => 0,
+        },
+        Err(status) => status as i32,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[allow(unsafe_code)]
+    fn test_per_call_strings() {
+        let mut out = VersionRecord::default();
+        // SAFETY: C string literals and a live local record
+        unsafe {
+            assert_eq!(semverx_satisfies(c"1.4.0(lts)".as_ptr(), c"^1.2".as_ptr()), 1);
+            assert_eq!(semverx_satisfies(c"1.4.0(lts)".as_ptr(), c"^1.2(stable)".as_ptr()), 0);
+            assert_eq!(semverx_satisfies(c"1.4.0".as_ptr(), std::ptr::null()), Status::NullPointer as i32);
+            assert_eq!(semverx_parse_version(c"2.0.1(experimental)".as_ptr(), &mut out), 1);
+            assert_eq!(semverx_parse_version(c"two".as_ptr(), &mut out), 0);
+        }
+        assert_eq!(out, VersionRecord { major: 2, minor: 0, patch: 1, channel: 1 });
+    }
+}
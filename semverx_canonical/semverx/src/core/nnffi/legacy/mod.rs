@@ -0,0 +1,3 @@
+//! Legacy per-call channel
+
+pub mod bind;
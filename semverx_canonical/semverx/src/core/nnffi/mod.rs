@@ -0,0 +1,118 @@
+//! Non Native Foreign Function Functor Interface
+//!
+//! C ABI for the polyglot clients, separated by channel:
+//! - `stable`: batch calls over arrays of packed version and range
+//!   records with caller-owned outputs, one crossing per batch
+//! - `legacy`: one C string per argument and one crossing per query
+//! - `experimental` (feature `shm-ring`): a shared-memory request ring
+//!   served by a background thread, no crossing per query
+//!
+//! The records and the kernels behind every channel live in `bind`.
+
+pub mod bind;
+pub mod legacy;
+pub mod stable;
+#[cfg(feature = "shm-ring")]
+pub mod experimental;
+
+pub use bind::{RangeRecord, Status, VersionRecord};
+
+#[cfg(test)]
+#[allow(unsafe_code)]
+mod tests {
+    use std::os::raw::c_char;
+
+    use super::bind::{self, RangeRecord, VersionRecord};
+
+    /// Handles as C sees them: pointers to an incomplete type
+    #[repr(C)]
+    struct Opaque {
+        _private: [u8; 0],
+    }
+
+    // Bound by symbol name at link time, not through Rust paths: an entry
+    // point that is mangled, renamed or not compiled fails this link
+    extern "C" {
+        fn semverx_mask_words(candidates: usize) -> usize;
+        fn semverx_match_batch(
+            candidates: *const VersionRecord,
+            candidate_count: usize,
+            ranges: *const RangeRecord,
+            range_count: usize,
+            out: *mut u64,
+            out_len: usize,
+        ) -> i32;
+        fn semverx_max_satisfying_batch(
+            candidates: *const VersionRecord,
+            candidate_count: usize,
+            ranges: *const RangeRecord,
+            range_count: usize,
+            out: *mut u32,
+            out_len: usize,
+        ) -> i32;
+        fn semverx_parse_versions(
+            text: *const u8,
+            text_len: usize,
+            offsets: *const u32,
+            count: usize,
+            out: *mut VersionRecord,
+        ) -> i64;
+        fn semverx_satisfies(version: *const c_char, range: *const c_char) -> i32;
+        fn semverx_parse_version(version: *const c_char, out: *mut VersionRecord) -> i32;
+        fn semverx_ff_canonicalize_batch(data: *const u8, len: usize, offsets: *const u64, count: usize) -> *mut Opaque;
+        fn semverx_ff_batch_size(batch: *const Opaque) -> usize;
+        fn semverx_ff_batch_copy(
+            batch: *const Opaque,
+            out: *mut u8,
+            out_len: usize,
+            out_offsets: *mut u64,
+            offsets_len: usize,
+        ) -> i32;
+        fn semverx_ff_batch_free(batch: *mut Opaque);
+        fn semverx_ff_score_batch(
+            queries: *const u8,
+            queries_len: usize,
+            query_offsets: *const u64,
+            query_count: usize,
+            corpus: *const u8,
+            corpus_len: usize,
+            corpus_offsets: *const u64,
+            corpus_count: usize,
+            out: *mut f64,
+            out_len: usize,
+        ) -> i32;
+        #[cfg(feature = "shm-ring")]
+        fn semverx_ring_init(mem: *mut u32, words: usize, slots: u32) -> i32;
+        #[cfg(feature = "shm-ring")]
+        fn semverx_ring_start(mem: *mut u32, words: usize) -> *mut Opaque;
+        #[cfg(feature = "shm-ring")]
+        fn semverx_ring_stop(server: *mut Opaque);
+    }
+
+    #[test]
+    fn test_entry_points_link_by_name() {
+        let exports = vec![
+            semverx_mask_words as usize,
+            semverx_match_batch as usize,
+            semverx_max_satisfying_batch as usize,
+            semverx_parse_versions as usize,
+            semverx_satisfies as usize,
+            semverx_parse_version as usize,
+            semverx_ff_canonicalize_batch as usize,
+            semverx_ff_batch_size as usize,
+            semverx_ff_batch_copy as usize,
+            semverx_ff_batch_free as usize,
+            semverx_ff_score_batch as usize,
+        ];
+        #[cfg(feature = "shm-ring")]
+        let exports = [exports, vec![semverx_ring_init as usize, semverx_ring_start as usize, semverx_ring_stop as usize]].concat();
+        assert!(exports.iter().all(|&address| address != 0));
+
+        // SAFETY: integer argument only
+        assert_eq!(unsafe { semverx_mask_words(130) }, bind::mask_words(130));
+        let (version, range) = (b"1.4.0\0", b"^1.2\0");
+        // SAFETY: both are NUL-terminated literals
+        let satisfied = unsafe { semverx_satisfies(version.as_ptr().cast(), range.as_ptr().cast()) };
+        assert_eq!(satisfied, 1);
+    }
+}
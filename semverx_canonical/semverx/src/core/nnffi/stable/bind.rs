@@ -0,0 +1,162 @@
+//! Stable batch C ABI
+//!
+//! One crossing per batch: callers pass arrays of `VersionRecord` and
+//! `RangeRecord` plus output buffers they own, and nothing is allocated
+//! or copied on this side. Every function returns a `Status` code.
+//! Pointers may be null only when their length is 0.
+
+use std::slice;
+
+use super::super::bind::{self, RangeRecord, Status, VersionRecord};
+
+/// Borrow `len` records at `ptr`; null is accepted only for `len == 0`
+///
+/// # Safety
+/// If non-null, `ptr` must point to `len` initialized, aligned `T`s that
+/// stay valid and unmodified for `'a`.
+#[allow(unsafe_code)]
+pub(super) unsafe fn input<'a, T>(ptr: *const T, len: usize) -> Result<&'a [T], Status> {
+    match (ptr.is_null(), len) {
+        (true, 0) => Ok(&[]),
+        (true, _) => Err(Status::NullPointer),
+        // SAFETY: non-null and, per this function's contract, valid for `len` reads
+        (false, _) => Ok(unsafe { slice::from_raw_parts(ptr, len) }),
+    }
+}
+
+/// Mutable counterpart of `input`
+///
+/// # Safety
+/// If non-null, `ptr` must point to `len` aligned `T`s, valid for
+/// writes and not accessed by anyone else for `'a`.
+#[allow(unsafe_code)]
+pub(super) unsafe fn output<'a, T>(ptr: *mut T, len: usize) -> Result<&'a mut [T], Status> {
+    match (ptr.is_null(), len) {
+        (true, 0) => Ok(&mut []),
+        (true, _) => Err(Status::NullPointer),
+        // SAFETY: non-null and, per this function's contract, exclusively ours for `len` writes
+        (false, _) => Ok(unsafe { slice::from_raw_parts_mut(ptr, len) }),
+    }
+}
+
+/// Number of `u64` mask words per range for `semverx_match_batch`
+#[no_mangle]
+#[allow(unsafe_code)]
+pub extern "C" fn semverx_mask_words(candidates: usize) -> usize {
+    bind::mask_words(candidates)
+}
+
+/// Match every range against every candidate, writing bit masks
+///
+/// `out` receives `semverx_mask_words(candidate_count)` words per
+/// range; `out_len` is its length in words.
+///
+/// # Safety
+/// Each pointer must be null with a zero length, or valid for its
+/// length; `out` must not overlap the inputs.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_match_batch(
+    candidates: *const VersionRecord,
+    candidate_count: usize,
+    ranges: *const RangeRecord,
+    range_count: usize,
+    out: *mut u64,
+    out_len: usize,
+) -> i32 {
+    // SAFETY: forwarded from this function's contract
+    let args = unsafe { (input(candidates, candidate_count), input(ranges, range_count), output(out, out_len)) };
+    match args {
+        (Ok(candidates), Ok(ranges), Ok(out)) => bind::match_masks(candidates, ranges, out) as i32,
+        _ => Status::NullPointer as i32,
+    }
+}
+
+/// Index of the highest candidate satisfying each range
+///
+/// `out[i]` receives an index into `candidates`, or `u32::MAX` when
+/// nothing satisfies range `i`; `out_len` must be at least `range_count`.
+///
+/// # Safety
+/// As for `semverx_match_batch`.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_max_satisfying_batch(
+    candidates: *const VersionRecord,
+    candidate_count: usize,
+    ranges: *const RangeRecord,
+    range_count: usize,
+    out: *mut u32,
+    out_len: usize,
+) -> i32 {
+    // SAFETY: forwarded from this function's contract
+    let args = unsafe { (input(candidates, candidate_count), input(ranges, range_count), output(out, out_len)) };
+    match args {
+        (Ok(candidates), Ok(ranges), Ok(out)) => bind::max_satisfying(candidates, ranges, out) as i32,
+        _ => Status::NullPointer as i32,
+    }
+}
+
+/// Parse `count` versions packed into one UTF-8 buffer
+///
+/// Version `i` spans `text[offsets[i]..offsets[i + 1]]`; `offsets` has
+/// `count + 1` entries and `out` room for `count` records. Returns the
+/// number of unparseable versions (marked with channel `u32::MAX`), or
+/// a negative `Status`.
+///
+/// # Safety
+/// `text` must be valid for `text_len` bytes, `offsets` for `count + 1`
+/// entries and `out` for `count` records (nulls only with zero lengths).
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_parse_versions(
+    text: *const u8,
+    text_len: usize,
+    offsets: *const u32,
+    count: usize,
+    out: *mut VersionRecord,
+) -> i64 {
+    let offset_count = if count == 0 && offsets.is_null() { 0 } else { count + 1 };
+    // SAFETY: forwarded from this function's contract
+    let args = unsafe { (input(text, text_len), input(offsets, offset_count), output(out, count)) };
+    let parsed = match args {
+        (Ok(text), Ok(offsets), Ok(out)) => bind::parse_versions(text, offsets, out),
+        _ => Err(Status::NullPointer),
+    };
+    match parsed {
+        Ok(failed) => failed as i64,
+        Err(status) => status as i64,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::nlm::parser::parse_range;
+    use std::ptr;
+
+    #[test]
+    #[allow(unsafe_code)]
+    fn test_one_crossing_per_batch() {
+        let text = b"1.2.3(stable)1.4.0(lts)2.0.0";
+        let offsets = [0u32, 13, 23, 28];
+        let mut versions = [VersionRecord::default(); 3];
+        // SAFETY: every pointer is a live local array of the stated length
+        let failed = unsafe { semverx_parse_versions(text.as_ptr(), text.len(), offsets.as_ptr(), 3, versions.as_mut_ptr()) };
+        assert_eq!(failed, 0);
+
+        let ranges = [RangeRecord::new(&parse_range(b"^1").unwrap()), RangeRecord::new(&parse_range(b"^3").unwrap())];
+        let mut best = [0u32; 2];
+        let mut masks = [0u64; 2];
+        // SAFETY: as above
+        unsafe {
+            assert_eq!(semverx_max_satisfying_batch(versions.as_ptr(), 3, ranges.as_ptr(), 2, best.as_mut_ptr(), 2), 0);
+            assert_eq!(semverx_match_batch(versions.as_ptr(), 3, ranges.as_ptr(), 2, masks.as_mut_ptr(), 2), 0);
+            assert_eq!(semverx_match_batch(versions.as_ptr(), 3, ranges.as_ptr(), 2, masks.as_mut_ptr(), 1), Status::OutputTooSmall as i32);
+            assert_eq!(semverx_match_batch(ptr::null(), 3, ranges.as_ptr(), 2, masks.as_mut_ptr(), 2), Status::NullPointer as i32);
+            assert_eq!(semverx_parse_versions(ptr::null(), 0, ptr::null(), 0, ptr::null_mut()), 0);
+        }
+        assert_eq!(best, [1, u32::MAX]);
+        assert_eq!(masks, [0b011, 0]);
+    }
+}
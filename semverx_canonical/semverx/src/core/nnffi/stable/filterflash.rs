@@ -0,0 +1,268 @@
+//! FilterFlash batch calls behind the pysemverx native oracle
+//!
+//! Artifacts arrive concatenated in one buffer, delimited by `count + 1`
+//! u64 offsets, and are extracted, canonicalized or scored on every
+//! core. The calls touch no interpreter state, so a ctypes caller runs
+//! them with the GIL released. Results are exactly those of the
+//! reference functions in `crate::filterflash`.
+
+use std::thread;
+
+use super::bind::{input, output};
+use super::super::bind::Status;
+use crate::filterflash::canonicalizer::canonicalize;
+use crate::filterflash::extractor::extract;
+use crate::filterflash::scorer::{jaccard, shingles};
+
+/// Canonical encodings of one batch, concatenated
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct CanonicalBatch {
+    bytes: Vec<u8>,
+    /// `count + 1` offsets into `bytes`
+    offsets: Vec<u64>,
+}
+
+impl CanonicalBatch {
+    /// Extract and canonicalize every artifact in parallel
+    pub fn build(artifacts: &[&[u8]]) -> Self {
+        let encoded = parallel_map(artifacts, |artifact| canonicalize(&extract(artifact)));
+        let mut offsets = Vec::with_capacity(encoded.len() + 1);
+        offsets.push(0);
+        let mut bytes = Vec::with_capacity(encoded.iter().map(Vec::len).sum());
+        for canonical in &encoded {
+            bytes.extend_from_slice(canonical);
+            offsets.push(bytes.len() as u64);
+        }
+        Self { bytes, offsets }
+    }
+
+    /// Canonical encoding of artifact `i`
+    pub fn get(&self, i: usize) -> Option<&[u8]> {
+        let (start, end) = (*self.offsets.get(i)?, *self.offsets.get(i + 1)?);
+        Some(&self.bytes[start as usize..end as usize])
+    }
+}
+
+/// `scorer::score` of every query against one corpus, in parallel
+///
+/// Corpus shingle sets are built once for the whole batch.
+pub fn score_all(queries: &[&[u8]], corpus: &[&[u8]], out: &mut [f64]) {
+    let references = parallel_map(corpus, |reference| shingles(reference));
+    let scores = parallel_map(queries, |query| {
+        if references.is_empty() {
+            return 1.0;
+        }
+        let own = shingles(query);
+        references.iter().map(|reference| jaccard(&own, reference)).fold(0.0, f64::max)
+    });
+    out[..scores.len()].copy_from_slice(&scores);
+}
+
+/// `f` over every item on scoped workers, one contiguous chunk per core
+fn parallel_map<T: Sync, R: Send>(items: &[T], f: impl Fn(&T) -> R + Sync) -> Vec<R> {
+    let threads = thread::available_parallelism().map_or(1, |n| n.get()).min(items.len());
+    if threads <= 1 {
+        return items.iter().map(f).collect();
+    }
+    let chunk = items.len().div_ceil(threads);
+    thread::scope(|scope| {
+        let f = &f;
+        let workers: Vec<_> = items
+            .chunks(chunk)
+            .map(|part| scope.spawn(move || part.iter().map(f).collect::<Vec<R>>()))
+            .collect();
+        workers.into_iter().flat_map(|worker| worker.join().unwrap()).collect()
+    })
+}
+
+/// Split `data` at `offsets`; `None` if they are not ascending within it
+fn spans<'a>(data: &'a [u8], offsets: &[u64]) -> Option<Vec<&'a [u8]>> {
+    offsets
+        .windows(2)
+        .map(|span| data.get(usize::try_from(span[0]).ok()?..usize::try_from(span[1]).ok()?))
+        .collect()
+}
+
+/// Borrow a concatenated batch from raw parts
+///
+/// # Safety
+/// `data` must be valid for `len` bytes and `offsets` for `count + 1`
+/// entries, or null with a zero length / count.
+#[allow(unsafe_code)]
+unsafe fn batch<'a>(data: *const u8, len: usize, offsets: *const u64, count: usize) -> Result<Vec<&'a [u8]>, Status> {
+    let offset_count = if count == 0 && offsets.is_null() { 0 } else { count + 1 };
+    // SAFETY: forwarded from this function's contract
+    let (data, offsets) = unsafe { (input(data, len)?, input(offsets, offset_count)?) };
+    spans(data, offsets).ok_or(Status::BadRecord)
+}
+
+/// Extract and canonicalize `count` artifacts in parallel
+///
+/// Returns a batch handle to read with `semverx_ff_batch_size` and
+/// `semverx_ff_batch_copy` and release with `semverx_ff_batch_free`,
+/// or null if the offsets do not fit the buffer.
+///
+/// # Safety
+/// `data` must be valid for `len` bytes and `offsets` for `count + 1`
+/// entries (nulls only with zero lengths).
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ff_canonicalize_batch(
+    data: *const u8,
+    len: usize,
+    offsets: *const u64,
+    count: usize,
+) -> *mut CanonicalBatch {
+    // SAFETY: forwarded from this function's contract
+    match unsafe { batch(data, len, offsets, count) } {
+        Ok(artifacts) => Box::into_raw(Box::new(CanonicalBatch::build(&artifacts))),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
+/// Total bytes of the canonical encodings in `batch`
+///
+/// # Safety
+/// `batch` must be a live handle from `semverx_ff_canonicalize_batch`.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ff_batch_size(batch: *const CanonicalBatch) -> usize {
+    // SAFETY: a live handle per the contract
+    unsafe { batch.as_ref() }.map_or(0, |batch| batch.bytes.len())
+}
+
+/// Copy the encodings into `out` (`out_len` bytes) and their `count + 1`
+/// offsets into `out_offsets` (`offsets_len` entries)
+///
+/// # Safety
+/// `batch` must be a live handle; `out` and `out_offsets` must be valid
+/// for their lengths.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ff_batch_copy(
+    batch: *const CanonicalBatch,
+    out: *mut u8,
+    out_len: usize,
+    out_offsets: *mut u64,
+    offsets_len: usize,
+) -> i32 {
+    // SAFETY: forwarded from this function's contract
+    let (batch, out, out_offsets) = match unsafe { (batch.as_ref(), output(out, out_len), output(out_offsets, offsets_len)) } {
+        (Some(batch), Ok(out), Ok(out_offsets)) => (batch, out, out_offsets),
+        _ => return Status::NullPointer as i32,
+    };
+    if out.len() < batch.bytes.len() || out_offsets.len() < batch.offsets.len() {
+        return Status::OutputTooSmall as i32;
+    }
+    out[..batch.bytes.len()].copy_from_slice(&batch.bytes);
+    out_offsets[..batch.offsets.len()].copy_from_slice(&batch.offsets);
+    Status::Ok as i32
+}
+
+/// Release a batch handle
+///
+/// # Safety
+/// `batch` must come from `semverx_ff_canonicalize_batch` and not be freed twice.
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ff_batch_free(batch: *mut CanonicalBatch) {
+    if !batch.is_null() {
+        // SAFETY: produced by Box::into_raw and released once per the contract
+        drop(unsafe { Box::from_raw(batch) });
+    }
+}
+
+/// Coherence of each query against the corpus, as the linear `scorer::score`
+///
+/// Queries and corpus are concatenated buffers with `count + 1` offsets
+/// each; `out` receives `query_count` scores.
+///
+/// # Safety
+/// Every buffer must be valid for its length (nulls only with zero lengths).
+#[no_mangle]
+#[allow(unsafe_code)]
+pub unsafe extern "C" fn semverx_ff_score_batch(
+    queries: *const u8,
+    queries_len: usize,
+    query_offsets: *const u64,
+    query_count: usize,
+    corpus: *const u8,
+    corpus_len: usize,
+    corpus_offsets: *const u64,
+    corpus_count: usize,
+    out: *mut f64,
+    out_len: usize,
+) -> i32 {
+    // SAFETY: forwarded from this function's contract
+    let args = unsafe {
+        (
+            batch(queries, queries_len, query_offsets, query_count),
+            batch(corpus, corpus_len, corpus_offsets, corpus_count),
+            output(out, out_len),
+        )
+    };
+    match args {
+        (Ok(queries), Ok(corpus), Ok(out)) if out.len() >= queries.len() => {
+            score_all(&queries, &corpus, out);
+            Status::Ok as i32
+        }
+        (Ok(_), Ok(_), Ok(_)) => Status::OutputTooSmall as i32,
+        (Err(status), _, _) | (_, Err(status), _) | (_, _, Err(status)) => status as i32,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::filterflash::scorer;
+
+    fn concat(items: &[&[u8]]) -> (Vec<u8>, Vec<u64>) {
+        let mut offsets = vec![0u64];
+        let mut data = Vec::new();
+        for item in items {
+            data.extend_from_slice(item);
+            offsets.push(data.len() as u64);
+        }
+        (data, offsets)
+    }
+
+    #[test]
+    #[allow(unsafe_code)]
+    fn test_batches_match_reference_functions() {
+        let artifacts: Vec<Vec<u8>> = (0..40)
+            .map(|i| format!("fn f{}() {{ call({}, \"s{}\"); }}\n", i % 4, i, i % 3).repeat(1 + i).into_bytes())
+            .collect();
+        let refs: Vec<&[u8]> = artifacts.iter().map(Vec::as_slice).collect();
+        let (data, offsets) = concat(&refs);
+
+        // SAFETY: buffers are live locals of the stated lengths, the handle is freed once
+        let (bytes, copied) = unsafe {
+            let handle = semverx_ff_canonicalize_batch(data.as_ptr(), data.len(), offsets.as_ptr(), refs.len());
+            assert!(!handle.is_null());
+            let mut bytes = vec![0u8; semverx_ff_batch_size(handle)];
+            let mut copied = vec![0u64; refs.len() + 1];
+            assert_eq!(semverx_ff_batch_copy(handle, bytes.as_mut_ptr(), bytes.len(), copied.as_mut_ptr(), 3), Status::OutputTooSmall as i32);
+            assert_eq!(semverx_ff_batch_copy(handle, bytes.as_mut_ptr(), bytes.len(), copied.as_mut_ptr(), copied.len()), 0);
+            semverx_ff_batch_free(handle);
+            (bytes, copied)
+        };
+        let canonicals: Vec<Vec<u8>> = refs.iter().map(|a| canonicalize(&extract(a))).collect();
+        for (i, canonical) in canonicals.iter().enumerate() {
+            assert_eq!(&bytes[copied[i] as usize..copied[i + 1] as usize], &canonical[..]);
+        }
+
+        let corpus: Vec<&[u8]> = canonicals.iter().step_by(3).map(Vec::as_slice).collect();
+        let queries: Vec<&[u8]> = canonicals.iter().map(Vec::as_slice).collect();
+        let mut scores = vec![0.0; queries.len()];
+        score_all(&queries, &corpus, &mut scores);
+        for (query, score) in queries.iter().zip(&scores) {
+            assert_eq!(score.to_bits(), scorer::score(query, &corpus).to_bits());
+        }
+        score_all(&queries, &[], &mut scores);
+        assert!(scores.iter().all(|&s| s == 1.0));
+
+        let bad = [0u64, 5, 3];
+        // SAFETY: as above; the offsets are rejected before any read past `data`
+        assert!(unsafe { semverx_ff_canonicalize_batch(data.as_ptr(), data.len(), bad.as_ptr(), 2) }.is_null());
+    }
+}
@@ -0,0 +1,4 @@
+//! Stable batch channel
+
+pub mod bind;
+pub mod filterflash;
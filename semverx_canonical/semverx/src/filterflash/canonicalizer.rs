@@ -0,0 +1,62 @@
+//! Deterministic encoding of a `FeatureVector`
+//!
+//! The encoding depends only on feature values, never on `HashMap`
+//! iteration order, so every language port produces the same bytes
+//! for the same features:
+//!
+//! `ast_hash` | `u32` length | `control_flow` | `u32` literal count |
+//! per literal in byte order: `u32` length, text, `u64` count
+//!
+//! All integers are little-endian.
+
+use sha2::{Digest, Sha256};
+
+use crate::audit::plpprofiler::{self, Probe};
+use super::FeatureVector;
+
+/// Canonical bytes for `features`, O(L log L) in the number of literals
+pub fn canonicalize(features: &FeatureVector) -> Vec<u8> {
+    let _span = plpprofiler::span(Probe::FilterCanonicalize);
+    let mut literals: Vec<(&String, &usize)> = features.literals.iter().collect();
+    literals.sort_unstable_by(|a, b| a.0.as_bytes().cmp(b.0.as_bytes()));
+
+    let literal_bytes: usize = literals.iter().map(|(text, _)| 12 + text.len()).sum();
+    let mut out = Vec::with_capacity(features.ast_hash.len() + 8 + features.control_flow.len() + literal_bytes);
+    out.extend_from_slice(&features.ast_hash);
+    out.extend_from_slice(&(features.control_flow.len() as u32).to_le_bytes());
+    out.extend_from_slice(&features.control_flow);
+    out.extend_from_slice(&(literals.len() as u32).to_le_bytes());
+    for (text, &count) in literals {
+        out.extend_from_slice(&(text.len() as u32).to_le_bytes());
+        out.extend_from_slice(text.as_bytes());
+        out.extend_from_slice(&(count as u64).to_le_bytes());
+    }
+    out
+}
+
+/// SHA-256 identifying a canonical encoding
+pub fn canonical_hash(canonical: &[u8]) -> Vec<u8> {
+    Sha256::digest(canonical).to_vec()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::HashMap;
+
+    #[test]
+    fn test_independent_of_insertion_order() {
+        let mut a = HashMap::new();
+        let mut b = HashMap::new();
+        for (i, text) in ["\"x\"", "42", "\"longer literal\"", "7"].iter().enumerate() {
+            a.insert(text.to_string(), i + 1);
+        }
+        for (i, text) in ["\"x\"", "42", "\"longer literal\"", "7"].iter().enumerate().rev() {
+            b.insert(text.to_string(), i + 1);
+        }
+        let features = |literals| FeatureVector { ast_hash: vec![1; 32], control_flow: b"{}".to_vec(), literals };
+        let (a, b) = (canonicalize(&features(a)), canonicalize(&features(b)));
+        assert_eq!(a, b);
+        assert_eq!(&a[32..38], &[2, 0, 0, 0, b'{', b'}']);
+    }
+}
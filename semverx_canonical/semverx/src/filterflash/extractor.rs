@@ -0,0 +1,233 @@
+//! Incremental feature extraction
+//!
+//! `FeatureExtractor` is a byte-level state machine whose state carries
+//! across chunk boundaries, so feeding an artifact in any chunking
+//! yields the same `FeatureVector` as feeding it whole. Memory is
+//! bounded by the caps below, not by the artifact size.
+//!
+//! Features:
+//! - `ast_hash`: SHA-256 of the artifact with whitespace runs outside
+//!   string literals collapsed to one space and trimmed at both ends
+//! - `control_flow`: the `{}()[];` skeleton outside string literals,
+//!   capped at `MAX_CONTROL_FLOW` bytes
+//! - `literals`: occurrence counts of string literals (quotes included)
+//!   and numeric literals, each truncated to `MAX_LITERAL` bytes, for at
+//!   most `MAX_LITERALS` distinct literals
+
+use std::collections::HashMap;
+
+use sha2::{Digest, Sha256};
+
+use crate::audit::plpprofiler::{self, Probe};
+
+use super::FeatureVector;
+
+/// Longest control-flow skeleton kept
+pub const MAX_CONTROL_FLOW: usize = 64 * 1024;
+
+/// Longest literal text kept; longer literals are counted by their prefix
+pub const MAX_LITERAL: usize = 64;
+
+/// Most distinct literals tracked; later new literals are not counted
+pub const MAX_LITERALS: usize = 4096;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Scan {
+    Code,
+    Str { escaped: bool },
+    Number,
+}
+
+/// Streaming feature extractor
+#[derive(Debug, Clone)]
+pub struct FeatureExtractor {
+    hasher: Sha256,
+    /// Normalized bytes of the current chunk, flushed into `hasher`
+    normalized: Vec<u8>,
+    scan: Scan,
+    /// Whitespace seen since the last emitted byte
+    space: bool,
+    /// Anything emitted yet (leading whitespace is dropped)
+    started: bool,
+    prev: u8,
+    literal: Vec<u8>,
+    control_flow: Vec<u8>,
+    literals: HashMap<String, usize>,
+}
+
+impl Default for FeatureExtractor {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl FeatureExtractor {
+    /// Extractor at the start of an artifact
+    pub fn new() -> Self {
+        Self {
+            hasher: Sha256::new(),
+            normalized: Vec::new(),
+            scan: Scan::Code,
+            space: false,
+            started: false,
+            prev: b' ',
+            literal: Vec::with_capacity(MAX_LITERAL),
+            control_flow: Vec::new(),
+            literals: HashMap::new(),
+        }
+    }
+
+    /// Feed the next chunk, O(chunk)
+    pub fn update(&mut self, chunk: &[u8]) {
+        let _span = plpprofiler::span(Probe::FilterExtract);
+        let mut normalized = std::mem::take(&mut self.normalized);
+        normalized.clear();
+        normalized.reserve(chunk.len());
+
+        for &b in chunk {
+            match self.scan {
+                Scan::Str { escaped } => {
+                    normalized.push(b);
+                    self.push_literal(b);
+                    self.scan = match b {
+                        _ if escaped => Scan::Str { escaped: false },
+                        b'\\' => Scan::Str { escaped: true },
+                        b'"' => {
+                            self.end_literal();
+                            Scan::Code
+                        }
+                        _ => Scan::Str { escaped: false },
+                    };
+                    continue;
+                }
+                Scan::Number if b.is_ascii_alphanumeric() || b == b'_' || b == b'.' => {
+                    normalized.push(b);
+                    self.push_literal(b);
+                    self.prev = b;
+                    continue;
+                }
+                Scan::Number => {
+                    self.end_literal();
+                    self.scan = Scan::Code;
+                }
+                Scan::Code => {}
+            }
+
+            if b.is_ascii_whitespace() {
+                self.space = true;
+                self.prev = b' ';
+                continue;
+            }
+            if self.space && self.started {
+                normalized.push(b' ');
+            }
+            self.space = false;
+            self.started = true;
+            normalized.push(b);
+
+            match b {
+                b'"' => {
+                    self.literal.clear();
+                    self.push_literal(b);
+                    self.scan = Scan::Str { escaped: false };
+                }
+                b'0'..=b'9' if !is_ident(self.prev) => {
+                    self.literal.clear();
+                    self.push_literal(b);
+                    self.scan = Scan::Number;
+                }
+                b'{' | b'}' | b'(' | b')' | b'[' | b']' | b';' => {
+                    if self.control_flow.len() < MAX_CONTROL_FLOW {
+                        self.control_flow.push(b);
+                    }
+                }
+                _ => {}
+            }
+            self.prev = b;
+        }
+
+        self.hasher.update(&normalized);
+        self.normalized = normalized;
+    }
+
+    /// Features of everything fed so far
+    ///
+    /// A trailing numeric literal is counted; an unterminated string
+    /// literal is not.
+    pub fn finish(mut self) -> FeatureVector {
+        if self.scan == Scan::Number {
+            self.end_literal();
+        }
+        FeatureVector {
+            ast_hash: self.hasher.finalize().to_vec(),
+            control_flow: self.control_flow,
+            literals: self.literals,
+        }
+    }
+
+    fn push_literal(&mut self, b: u8) {
+        if self.literal.len() < MAX_LITERAL {
+            self.literal.push(b);
+        }
+    }
+
+    fn end_literal(&mut self) {
+        let text = String::from_utf8_lossy(&self.literal);
+        if let Some(count) = self.literals.get_mut(text.as_ref()) {
+            *count += 1;
+        } else if self.literals.len() < MAX_LITERALS {
+            self.literals.insert(text.into_owned(), 1);
+        }
+    }
+}
+
+/// Features of a buffered artifact
+pub fn extract(artifact: &[u8]) -> FeatureVector {
+    let mut extractor = FeatureExtractor::new();
+    extractor.update(artifact);
+    extractor.finish()
+}
+
+fn is_ident(b: u8) -> bool {
+    b.is_ascii_alphanumeric() || b == b'_'
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_features() {
+        let features = extract(b"  fn f(x) { let s = \"a { b\\\"\"; x1 + 42; 42 }\n");
+        assert_eq!(features.control_flow, b"(){;;}");
+        assert_eq!(features.literals.get("\"a { b\\\"\""), Some(&1));
+        assert_eq!(features.literals.get("42"), Some(&2));
+        assert_eq!(features.literals.get("1"), None, "digits inside identifiers");
+
+        let spaced = extract(b"fn f(x)\t{\n  let s = \"a { b\\\"\";   x1 + 42; 42 }");
+        assert_eq!(spaced.ast_hash, features.ast_hash, "whitespace runs collapse");
+        assert_ne!(extract(b"fn f(x){}").ast_hash, extract(b"fnf(x){}").ast_hash);
+    }
+
+    #[test]
+    fn test_any_chunking_matches_buffered() {
+        let artifact: Vec<u8> = b"let a = \"x  y\";\n  call(1.5e3, \"q\\\"\") ; 007 {}  "
+            .iter()
+            .cycle()
+            .take(5_000)
+            .copied()
+            .collect();
+        let whole = extract(&artifact);
+
+        for size in [1, 2, 3, 7, 64, 4_999] {
+            let mut extractor = FeatureExtractor::new();
+            for chunk in artifact.chunks(size) {
+                extractor.update(chunk);
+            }
+            let chunked = extractor.finish();
+            assert_eq!(chunked.ast_hash, whole.ast_hash, "chunk size {}", size);
+            assert_eq!(chunked.control_flow, whole.control_flow);
+            assert_eq!(chunked.literals, whole.literals);
+        }
+    }
+}
@@ -0,0 +1,341 @@
+//! Sublinear corpus index for coherence gating
+//!
+//! Scoring against a corpus linearly costs one Jaccard per corpus
+//! artifact. The index finds candidates by prefix filtering instead:
+//! each artifact's shingles are sorted by a global order (rarest first)
+//! and only the first `n - ceil(t * n) + 1` of its `n` shingles are
+//! posted. Two sets with Jaccard ≥ t always share a posted shingle, and
+//! their sizes lie within a factor t of each other. Candidates are
+//! then scored exactly, so the gate never rejects an artifact that the
+//! linear scan would accept.
+//!
+//! MinHash/LSH banding would be faster still, but only bounds the miss
+//! probability; prefix filtering gives that bound as zero.
+
+use std::collections::HashMap;
+use std::io::{self, Read, Write};
+
+use crate::audit::plpprofiler::{self, Probe};
+use super::scorer::shingles;
+use super::COHERENCE_GATE;
+
+const MAGIC: &[u8; 8] = b"SVXCIX\0\0";
+const FORMAT_VERSION: u32 = 1;
+
+/// Corpus of canonical encodings indexed for one gate threshold
+#[derive(Debug, Clone)]
+pub struct CorpusIndex {
+    threshold: f64,
+    /// Shingles known at build time, in global order (rarest first)
+    ordered: Vec<u32>,
+    rank: HashMap<u32, u32>,
+    /// Each artifact's shingles as order keys, ascending
+    docs: Vec<Vec<u64>>,
+    postings: HashMap<u64, Vec<u32>>,
+    /// Artifacts with no shingles at all
+    empty: usize,
+}
+
+impl Default for CorpusIndex {
+    fn default() -> Self {
+        Self::new(COHERENCE_GATE)
+    }
+}
+
+impl CorpusIndex {
+    /// Empty index gating at `threshold`
+    pub fn new(threshold: f64) -> Self {
+        Self {
+            threshold,
+            ordered: Vec::new(),
+            rank: HashMap::new(),
+            docs: Vec::new(),
+            postings: HashMap::new(),
+            empty: 0,
+        }
+    }
+
+    /// Index `corpus`, ordering shingles by their frequency in it
+    ///
+    /// O(total shingles · log). Artifacts inserted later keep this
+    /// order; shingles it has never seen sort first, as the rarest.
+    pub fn build(corpus: &[&[u8]], threshold: f64) -> Self {
+        let sets: Vec<Vec<u32>> = corpus.iter().map(|c| shingles(c).into_iter().collect()).collect();
+        let mut frequency: HashMap<u32, u32> = HashMap::new();
+        for &shingle in sets.iter().flatten() {
+            *frequency.entry(shingle).or_insert(0) += 1;
+        }
+        let mut ordered: Vec<u32> = frequency.keys().copied().collect();
+        ordered.sort_unstable_by_key(|s| (frequency[s], *s));
+
+        let mut index = Self::with_order(threshold, ordered);
+        for set in sets {
+            index.insert_shingles(set);
+        }
+        index
+    }
+
+    fn with_order(threshold: f64, ordered: Vec<u32>) -> Self {
+        let rank = ordered.iter().enumerate().map(|(r, &s)| (s, r as u32)).collect();
+        Self { ordered, rank, ..Self::new(threshold) }
+    }
+
+    /// Add a canonical encoding; returns its position in the corpus
+    pub fn insert(&mut self, canonical: &[u8]) -> usize {
+        self.insert_shingles(shingles(canonical).into_iter().collect())
+    }
+
+    fn insert_shingles(&mut self, set: Vec<u32>) -> usize {
+        let id = self.docs.len();
+        let keys = self.keys(set);
+        if keys.is_empty() {
+            self.empty += 1;
+        }
+        for &key in &keys[..self.prefix(keys.len())] {
+            self.postings.entry(key).or_default().push(id as u32);
+        }
+        self.docs.push(keys);
+        id
+    }
+
+    /// Number of indexed artifacts
+    pub fn len(&self) -> usize {
+        self.docs.len()
+    }
+
+    /// True if nothing is indexed
+    pub fn is_empty(&self) -> bool {
+        self.docs.is_empty()
+    }
+
+    /// Gate threshold the index was built for
+    pub fn threshold(&self) -> f64 {
+        self.threshold
+    }
+
+    /// Best corpus match scoring at least the threshold
+    ///
+    /// Returns the same artifact and score a linear scan would whenever
+    /// that score reaches the threshold.
+    pub fn best_match(&self, canonical: &[u8]) -> Option<(usize, f64)> {
+        let query = self.keys(shingles(canonical).into_iter().collect());
+        if query.is_empty() {
+            if self.empty == 0 {
+                return None;
+            }
+            return self.docs.iter().position(Vec::is_empty).map(|id| (id, 1.0));
+        }
+
+        let (lo, hi) = self.size_bounds(query.len());
+        let mut candidates: Vec<u32> = query[..self.prefix(query.len())]
+            .iter()
+            .filter_map(|key| self.postings.get(key))
+            .flatten()
+            .copied()
+            .filter(|&id| (lo..=hi).contains(&self.docs[id as usize].len()))
+            .collect();
+        candidates.sort_unstable();
+        candidates.dedup();
+
+        let mut best: Option<(usize, f64)> = None;
+        for id in candidates {
+            let score = jaccard_sorted(&query, &self.docs[id as usize]);
+            if score >= self.threshold && best.is_none_or(|(_, b)| score > b) {
+                best = Some((id as usize, score));
+                if score == 1.0 {
+                    break;
+                }
+            }
+        }
+        best
+    }
+
+    /// Coherence against the indexed corpus
+    ///
+    /// Equal to `scorer::score` over the same corpus whenever either
+    /// reaches the threshold; below it, only the gate decision is kept
+    /// and 0.0 is returned. An empty corpus scores 1.0, as in `scorer`.
+    pub fn score(&self, canonical: &[u8]) -> f64 {
+        let _span = plpprofiler::span(Probe::FilterScore);
+        if self.is_empty() {
+            return 1.0;
+        }
+        self.best_match(canonical).map_or(0.0, |(_, score)| score)
+    }
+
+    /// Persist the index; postings are rebuilt on load
+    pub fn write(&self, mut out: impl Write) -> io::Result<()> {
+        out.write_all(MAGIC)?;
+        out.write_all(&FORMAT_VERSION.to_le_bytes())?;
+        out.write_all(&self.threshold.to_bits().to_le_bytes())?;
+        write_u32s(&mut out, self.ordered.iter().copied())?;
+        out.write_all(&(self.docs.len() as u32).to_le_bytes())?;
+        for doc in &self.docs {
+            write_u32s(&mut out, doc.iter().map(|&key| key as u32))?;
+        }
+        out.flush()
+    }
+
+    /// Load an index written by `write`
+    pub fn read(mut input: impl Read) -> io::Result<Self> {
+        let mut magic = [0u8; 8];
+        input.read_exact(&mut magic)?;
+        if &magic != MAGIC || read_u32(&mut input)? != FORMAT_VERSION {
+            return Err(io::Error::new(io::ErrorKind::InvalidData, "not a corpus index"));
+        }
+        let mut bits = [0u8; 8];
+        input.read_exact(&mut bits)?;
+        let threshold = f64::from_bits(u64::from_le_bytes(bits));
+
+        let mut index = Self::with_order(threshold, read_u32s(&mut input)?);
+        for _ in 0..read_u32(&mut input)? {
+            let set = read_u32s(&mut input)?;
+            index.insert_shingles(set);
+        }
+        Ok(index)
+    }
+
+    /// Order keys for a shingle set, ascending: unseen shingles first,
+    /// then known ones by rank; the low half keeps keys unique
+    fn keys(&self, set: Vec<u32>) -> Vec<u64> {
+        let mut keys: Vec<u64> = set
+            .into_iter()
+            .map(|s| {
+                let slot = self.rank.get(&s).map_or(0, |&r| r as u64 + 1);
+                slot << 32 | s as u64
+            })
+            .collect();
+        keys.sort_unstable();
+        keys
+    }
+
+    /// Posted prefix length for a set of `n` shingles
+    fn prefix(&self, n: usize) -> usize {
+        if n == 0 {
+            return 0;
+        }
+        // Round the required overlap down so float error can only lengthen the prefix
+        let overlap = ((self.threshold * n as f64) - 1e-9).ceil().max(0.0) as usize;
+        (n - overlap.min(n) + 1).min(n)
+    }
+
+    /// Sizes a set can have and still reach the threshold against a set of `n`
+    fn size_bounds(&self, n: usize) -> (usize, usize) {
+        let t = self.threshold.max(f64::MIN_POSITIVE);
+        let lo = ((t * n as f64) - 1e-9).ceil().max(0.0) as usize;
+        let hi = ((n as f64 / t) + 1e-9).floor().min(usize::MAX as f64) as usize;
+        (lo, hi)
+    }
+}
+
+/// Jaccard similarity of two ascending key lists, as `scorer::jaccard` computes it
+fn jaccard_sorted(a: &[u64], b: &[u64]) -> f64 {
+    let (mut i, mut j, mut shared) = (0, 0, 0);
+    while i < a.len() && j < b.len() {
+        match a[i].cmp(&b[j]) {
+            std::cmp::Ordering::Less => i += 1,
+            std::cmp::Ordering::Greater => j += 1,
+            std::cmp::Ordering::Equal => {
+                shared += 1;
+                i += 1;
+                j += 1;
+            }
+        }
+    }
+    let union = a.len() + b.len() - shared;
+    if union == 0 {
+        1.0
+    } else {
+        shared as f64 / union as f64
+    }
+}
+
+fn write_u32s(out: &mut impl Write, values: impl ExactSizeIterator<Item = u32>) -> io::Result<()> {
+    out.write_all(&(values.len() as u32).to_le_bytes())?;
+    for value in values {
+        out.write_all(&value.to_le_bytes())?;
+    }
+    Ok(())
+}
+
+fn read_u32(input: &mut impl Read) -> io::Result<u32> {
+    let mut bytes = [0u8; 4];
+    input.read_exact(&mut bytes)?;
+    Ok(u32::from_le_bytes(bytes))
+}
+
+fn read_u32s(input: &mut impl Read) -> io::Result<Vec<u32>> {
+    let len = read_u32(input)? as usize;
+    let mut values = Vec::with_capacity(len.min(1 << 16));
+    for _ in 0..len {
+        values.push(read_u32(input)?);
+    }
+    Ok(values)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::filterflash::scorer;
+
+    /// Deterministic corpus: a few families of near-duplicate artifacts
+    fn corpus() -> Vec<Vec<u8>> {
+        let mut state = 0x9e37_79b9_7f4a_7c15u64;
+        let mut next = move || {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            state
+        };
+        let bases: Vec<Vec<u8>> = (0..8).map(|_| (0..600).map(|_| next() as u8).collect()).collect();
+        let mut corpus = Vec::new();
+        for base in &bases {
+            for edits in 0..12 {
+                let mut doc = base.clone();
+                for _ in 0..edits {
+                    let at = next() as usize % doc.len();
+                    doc[at] = next() as u8;
+                }
+                corpus.push(doc);
+            }
+        }
+        corpus
+    }
+
+    #[test]
+    fn test_no_false_rejects_against_linear_scan() {
+        let corpus = corpus();
+        let refs: Vec<&[u8]> = corpus.iter().map(Vec::as_slice).collect();
+        let indexed: Vec<&[u8]> = refs.iter().step_by(2).copied().collect();
+        let queries: Vec<&[u8]> = refs.iter().skip(1).step_by(2).copied().collect();
+        let index = CorpusIndex::build(&indexed, COHERENCE_GATE);
+
+        for query in refs.iter().chain([&&b"short"[..], &&b""[..]]) {
+            let linear = scorer::score(query, &indexed);
+            let fast = index.score(query);
+            assert_eq!(linear >= COHERENCE_GATE, fast >= COHERENCE_GATE);
+            if linear >= COHERENCE_GATE {
+                assert_eq!(fast, linear);
+            }
+        }
+        assert!(queries.iter().any(|q| index.score(q) >= COHERENCE_GATE));
+        assert_eq!(index.best_match(indexed[3]), Some((3, 1.0)));
+    }
+
+    #[test]
+    fn test_persisted_index_answers_the_same() {
+        let corpus = corpus();
+        let refs: Vec<&[u8]> = corpus.iter().map(Vec::as_slice).collect();
+        let mut index = CorpusIndex::build(&refs[..40], COHERENCE_GATE);
+        index.insert(refs[60]);
+
+        let mut bytes = Vec::new();
+        index.write(&mut bytes).unwrap();
+        let loaded = CorpusIndex::read(bytes.as_slice()).unwrap();
+        assert_eq!(loaded.len(), 41);
+        for query in &refs {
+            assert_eq!(loaded.best_match(query), index.best_match(query));
+        }
+        assert!(CorpusIndex::read(&bytes[..bytes.len() - 1]).is_err());
+    }
+}
@@ -0,0 +1,227 @@
+//! FilterFlash Functor - Coherence Gating Mechanism
+//! 
+//! Implements:
+//! - F: Artifact → CanonicalArtifact
+//! - Coherence scoring (gate at ≥0.954)
+//! - Idempotent canonicalization
+//! - Cross-language determinism
+//! - Streaming transform in bounded memory
+//! - Sublinear corpus lookup without false rejects
+//! - Staged parallel batch gating
+
+pub mod extractor;
+pub mod canonicalizer;
+pub mod scorer;
+pub mod index;
+pub mod pipeline;
+
+use std::collections::HashMap;
+use std::io::{self, Read};
+use std::sync::mpsc;
+use std::thread;
+
+use crate::core::digest::CHUNK;
+use extractor::FeatureExtractor;
+use index::CorpusIndex;
+pub use pipeline::PipelineConfig;
+
+/// Coherence threshold (95.4%)
+pub const COHERENCE_GATE: f64 = 0.954;
+
+/// Structural features extracted from one artifact
+#[derive(Debug, Clone, PartialEq)]
+pub struct FeatureVector {
+    /// SHA-256 of the whitespace-normalized artifact
+    pub ast_hash: Vec<u8>,
+    /// `{}()[];` skeleton outside string literals
+    pub control_flow: Vec<u8>,
+    /// Occurrence counts of string and numeric literals
+    pub literals: HashMap<String, usize>,
+}
+
+/// Canonical form of an artifact with its coherence score
+#[derive(Debug, Clone, PartialEq)]
+pub struct CanonicalArtifact {
+    /// Digest of the canonical encoding
+    pub canonical_hash: Vec<u8>,
+    /// Score against the corpus, compared with `COHERENCE_GATE`
+    pub coherence: f64,
+    /// Features the canonical form was built from
+    pub features: FeatureVector,
+}
+
+/// Artifact canonicalization shared by every language binding
+pub trait FilterFlashFunctor {
+    /// Scan `artifact` into its structural features
+    fn extract_features(&self, artifact: &[u8]) -> FeatureVector;
+    /// Deterministic byte encoding of `features`
+    fn canonicalize(&self, features: FeatureVector) -> Vec<u8>;
+    /// Coherence of `canonical` against `corpus`, in `[0, 1]`
+    fn score(&self, canonical: &[u8], corpus: &[&[u8]]) -> f64;
+    /// Extract, canonicalize and score in one call
+    fn transform(&self, artifact: &[u8]) -> CanonicalArtifact;
+
+    /// `transform` over an artifact read from `reader`
+    ///
+    /// Must produce exactly what `transform` produces for the same bytes.
+    /// The default buffers the whole artifact; functors with an
+    /// incremental extractor override it to run in bounded memory.
+    fn transform_reader(&self, reader: &mut dyn Read) -> io::Result<CanonicalArtifact> {
+        let mut artifact = Vec::new();
+        reader.read_to_end(&mut artifact)?;
+        Ok(self.transform(&artifact))
+    }
+}
+
+/// Reference functor gating artifacts against a corpus of canonical encodings
+///
+/// `transform` scores through a `CorpusIndex`. It reports the same
+/// coherence as `score` over the whole corpus whenever that reaches
+/// `COHERENCE_GATE`, and 0.0 otherwise.
+#[derive(Debug, Clone, Default)]
+pub struct FilterFlash {
+    index: CorpusIndex,
+}
+
+impl FilterFlash {
+    /// Functor scoring against `corpus` (canonical encodings of accepted artifacts)
+    pub fn new(corpus: Vec<Vec<u8>>) -> Self {
+        let corpus: Vec<&[u8]> = corpus.iter().map(Vec::as_slice).collect();
+        Self::with_index(CorpusIndex::build(&corpus, COHERENCE_GATE))
+    }
+
+    /// Functor scoring against a prebuilt or persisted index
+    pub fn with_index(index: CorpusIndex) -> Self {
+        Self { index }
+    }
+
+    /// The corpus index, e.g. to persist it or add accepted artifacts
+    pub fn index_mut(&mut self) -> &mut CorpusIndex {
+        &mut self.index
+    }
+
+    /// Canonicalize and score already extracted features
+    pub fn assemble(&self, features: FeatureVector) -> CanonicalArtifact {
+        let canonical = canonicalizer::canonicalize(&features);
+        CanonicalArtifact {
+            canonical_hash: canonicalizer::canonical_hash(&canonical),
+            coherence: self.index.score(&canonical),
+            features,
+        }
+    }
+}
+
+impl FilterFlashFunctor for FilterFlash {
+    fn extract_features(&self, artifact: &[u8]) -> FeatureVector {
+        extractor::extract(artifact)
+    }
+
+    fn canonicalize(&self, features: FeatureVector) -> Vec<u8> {
+        canonicalizer::canonicalize(&features)
+    }
+
+    fn score(&self, canonical: &[u8], corpus: &[&[u8]]) -> f64 {
+        scorer::score(canonical, corpus)
+    }
+
+    fn transform(&self, artifact: &[u8]) -> CanonicalArtifact {
+        self.assemble(self.extract_features(artifact))
+    }
+
+    /// Streaming `transform`: O(CHUNK) memory, reads overlap extraction
+    ///
+    /// The calling thread reads chunks while a scoped worker extracts
+    /// features from the previous one; at most three chunk buffers
+    /// exist at a time and are recycled between the two.
+    fn transform_reader(&self, reader: &mut dyn Read) -> io::Result<CanonicalArtifact> {
+        let (full_tx, full_rx) = mpsc::sync_channel::<Vec<u8>>(1);
+        let (empty_tx, empty_rx) = mpsc::channel::<Vec<u8>>();
+
+        let features = thread::scope(|scope| {
+            let worker = scope.spawn(move || {
+                let mut extractor = FeatureExtractor::new();
+                for chunk in full_rx {
+                    extractor.update(&chunk);
+                    let _ = empty_tx.send(chunk);
+                }
+                extractor.finish()
+            });
+
+            let read = pump(reader, &full_tx, &empty_rx);
+            drop(full_tx);
+            let features = worker.join().unwrap();
+            read.map(|()| features)
+        })?;
+        Ok(self.assemble(features))
+    }
+}
+
+/// Read `reader` to the end in chunks, sending each to the extractor
+fn pump(
+    reader: &mut dyn Read,
+    full: &mpsc::SyncSender<Vec<u8>>,
+    empty: &mpsc::Receiver<Vec<u8>>,
+) -> io::Result<()> {
+    loop {
+        let mut buf = empty.try_recv().unwrap_or_default();
+        buf.resize(CHUNK, 0);
+        let n = loop {
+            match reader.read(&mut buf) {
+                Ok(n) => break n,
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+                Err(e) => return Err(e),
+            }
+        };
+        if n == 0 {
+            return Ok(());
+        }
+        buf.truncate(n);
+        if full.send(buf).is_err() {
+            return Ok(());
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Reader yielding `step` bytes per call, then failing if `fail` is set
+    struct Chunked<'a> {
+        data: &'a [u8],
+        step: usize,
+        fail: bool,
+    }
+
+    impl Read for Chunked<'_> {
+        fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+            if self.data.is_empty() && self.fail {
+                return Err(io::Error::new(io::ErrorKind::UnexpectedEof, "cut off"));
+            }
+            let n = self.step.min(buf.len()).min(self.data.len());
+            buf[..n].copy_from_slice(&self.data[..n]);
+            self.data = &self.data[n..];
+            Ok(n)
+        }
+    }
+
+    #[test]
+    fn test_streaming_transform_matches_buffered() {
+        let artifact: Vec<u8> = b"pub fn gate(x: u32) -> bool { x >= 954 && check(\"flash\") }\n"
+            .iter()
+            .cycle()
+            .take(CHUNK * 2 + 123)
+            .copied()
+            .collect();
+        let reference = FilterFlash::new(Vec::new()).transform(&artifact[..CHUNK]);
+        let functor = FilterFlash::new(vec![canonicalizer::canonicalize(&reference.features)]);
+        let buffered = functor.transform(&artifact);
+
+        for step in [1_000, CHUNK, usize::MAX] {
+            let mut reader = Chunked { data: &artifact, step, fail: false };
+            assert_eq!(functor.transform_reader(&mut reader).unwrap(), buffered, "step {}", step);
+        }
+        let mut broken = Chunked { data: &artifact, step: 4096, fail: true };
+        assert!(functor.transform_reader(&mut broken).is_err());
+    }
+}
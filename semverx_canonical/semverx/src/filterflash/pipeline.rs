@@ -0,0 +1,293 @@
+//! Staged batch gating: read → hash/extract → canonicalize → score
+//!
+//! Each stage runs on its own worker pool, and stages hand work over
+//! bounded channels, so a slow stage back-pressures the ones feeding
+//! it instead of buffering without limit. Disk reads, extraction and
+//! scoring of different artifacts overlap; results are still returned
+//! in input order, identical to calling `transform` on each artifact.
+//!
+//! A reader claims whichever extractor lane is free for the whole of
+//! one artifact, so the per-artifact extractor state never crosses
+//! threads mid-stream, yet no lane idles while another has a backlog.
+//! Chunk buffers flow back to the lane's readers once extracted.
+
+use std::collections::HashMap;
+use std::io::{self, Read};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::mpsc::{self, Receiver, Sender, SyncSender};
+use std::sync::{Arc, Mutex};
+use std::thread;
+
+use crate::core::digest::CHUNK;
+use super::extractor::FeatureExtractor;
+use super::{canonicalizer, CanonicalArtifact, FeatureVector, FilterFlash};
+
+/// Worker counts and queue depth for `transform_batch`
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct PipelineConfig {
+    /// Threads reading artifacts; each feeds one lane at a time, so at
+    /// most this many extractor lanes are busy at once
+    pub readers: usize,
+    /// Extractor lanes (SHA-256 plus feature extraction)
+    pub extractors: usize,
+    /// Threads encoding features canonically
+    pub canonicalizers: usize,
+    /// Threads scoring against the corpus index
+    pub scorers: usize,
+    /// Capacity of each inter-stage channel, in messages
+    pub queue_depth: usize,
+}
+
+impl Default for PipelineConfig {
+    /// Extraction gets every core, with one reader per lane to keep
+    /// every lane fed; the last two stages are short, so they get
+    /// smaller pools
+    fn default() -> Self {
+        let cores = thread::available_parallelism().map_or(1, |n| n.get());
+        Self {
+            readers: cores,
+            extractors: cores,
+            canonicalizers: (cores / 4).max(1),
+            scorers: (cores / 2).max(1),
+            queue_depth: 4,
+        }
+    }
+}
+
+/// Read-stage output for one extractor lane
+enum Piece {
+    Data(usize, Vec<u8>),
+    End(usize),
+    Abort(usize),
+}
+
+/// Feeding end of an extractor lane, held by one reader at a time
+struct Lane {
+    chunks: SyncSender<Piece>,
+    /// Buffers the lane's extractor is done with
+    spare: Receiver<Vec<u8>>,
+}
+
+type Outcome = (usize, io::Result<CanonicalArtifact>);
+
+impl FilterFlash {
+    /// `transform` every artifact through the staged pipeline
+    ///
+    /// Results are in input order. Memory is bounded by the queue depth
+    /// times `CHUNK` per lane plus each artifact's features, never by
+    /// artifact sizes. A read error fails only that artifact.
+    pub fn transform_batch<R: Read + Send>(
+        &self,
+        artifacts: Vec<R>,
+        config: &PipelineConfig,
+    ) -> Vec<io::Result<CanonicalArtifact>> {
+        let count = artifacts.len();
+        if count == 0 {
+            return Vec::new();
+        }
+        let depth = config.queue_depth.max(1);
+        let sources: Vec<Mutex<R>> = artifacts.into_iter().map(Mutex::new).collect();
+        let next = AtomicUsize::new(0);
+
+        // Free lanes; dropped with the last reader, which ends the extractors
+        let (free_tx, free_rx) = mpsc::channel::<Lane>();
+        let free_rx = Arc::new(Mutex::new(free_rx));
+        let mut lane_inputs = Vec::new();
+        for _ in 0..config.extractors.max(1) {
+            let (chunks, input) = mpsc::sync_channel(depth);
+            let (recycle, spare) = mpsc::channel();
+            free_tx.send(Lane { chunks, spare }).unwrap();
+            lane_inputs.push((input, recycle));
+        }
+        let (features_tx, features_rx) = mpsc::sync_channel::<(usize, FeatureVector)>(depth);
+        let (canonical_tx, canonical_rx) = mpsc::sync_channel::<(usize, FeatureVector, Vec<u8>)>(depth);
+        let (done_tx, done_rx) = mpsc::sync_channel::<Outcome>(depth);
+        let (features_rx, canonical_rx) = (Mutex::new(features_rx), Mutex::new(canonical_rx));
+
+        let mut results: Vec<Option<io::Result<CanonicalArtifact>>> = (0..count).map(|_| None).collect();
+        thread::scope(|scope| {
+            let (sources, next) = (&sources, &next);
+            for _ in 0..config.readers.clamp(1, count) {
+                let (free, release, done) = (Arc::clone(&free_rx), free_tx.clone(), done_tx.clone());
+                scope.spawn(move || read_stage(sources, next, &free, &release, &done));
+            }
+            drop((free_rx, free_tx));
+
+            for (input, recycle) in lane_inputs {
+                let out = features_tx.clone();
+                scope.spawn(move || extract_stage(input, &recycle, &out));
+            }
+            drop(features_tx);
+
+            for _ in 0..config.canonicalizers.max(1) {
+                let (input, out) = (&features_rx, canonical_tx.clone());
+                scope.spawn(move || {
+                    while let Some((i, features)) = pull(input) {
+                        let canonical = canonicalizer::canonicalize(&features);
+                        if out.send((i, features, canonical)).is_err() {
+                            return;
+                        }
+                    }
+                });
+            }
+            drop(canonical_tx);
+
+            for _ in 0..config.scorers.max(1) {
+                let (input, out) = (&canonical_rx, done_tx.clone());
+                scope.spawn(move || {
+                    while let Some((i, features, canonical)) = pull(input) {
+                        let artifact = CanonicalArtifact {
+                            canonical_hash: canonicalizer::canonical_hash(&canonical),
+                            coherence: self.index.score(&canonical),
+                            features,
+                        };
+                        if out.send((i, Ok(artifact))).is_err() {
+                            return;
+                        }
+                    }
+                });
+            }
+            drop(done_tx);
+
+            for (i, outcome) in done_rx {
+                results[i] = Some(outcome);
+            }
+        });
+
+        results.into_iter().map(|slot| slot.expect("every artifact reaches the last stage")).collect()
+    }
+}
+
+/// Claim artifacts one by one and stream each to a free extractor lane
+fn read_stage<R: Read>(
+    sources: &[Mutex<R>],
+    next: &AtomicUsize,
+    free: &Mutex<Receiver<Lane>>,
+    release: &Sender<Lane>,
+    done: &SyncSender<Outcome>,
+) {
+    loop {
+        let i = next.fetch_add(1, Ordering::Relaxed);
+        let Some(source) = sources.get(i) else { return };
+        let Some(lane) = pull(free) else { return };
+        let alive = stream(i, &mut *source.lock().unwrap(), &lane, done);
+        // Handed back even if dead, so readers waiting on it fail too
+        let _ = release.send(lane);
+        if !alive {
+            return;
+        }
+    }
+}
+
+/// Stream artifact `i` into `lane`; false once the lane is gone
+fn stream(i: usize, source: &mut impl Read, lane: &Lane, done: &SyncSender<Outcome>) -> bool {
+    let end = loop {
+        let mut buf = lane.spare.try_recv().unwrap_or_default();
+        buf.resize(CHUNK, 0);
+        match source.read(&mut buf) {
+            Ok(0) => break Piece::End(i),
+            Ok(n) => {
+                buf.truncate(n);
+                if lane.chunks.send(Piece::Data(i, buf)).is_err() {
+                    return false;
+                }
+            }
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => {
+                let _ = done.send((i, Err(e)));
+                break Piece::Abort(i);
+            }
+        }
+    };
+    lane.chunks.send(end).is_ok()
+}
+
+/// One extractor lane: artifacts in turn, each with its own state
+fn extract_stage(input: Receiver<Piece>, recycle: &Sender<Vec<u8>>, out: &SyncSender<(usize, FeatureVector)>) {
+    let mut open: HashMap<usize, FeatureExtractor> = HashMap::new();
+    for piece in input {
+        match piece {
+            Piece::Data(i, chunk) => {
+                open.entry(i).or_default().update(&chunk);
+                let _ = recycle.send(chunk);
+            }
+            Piece::End(i) => {
+                let features = open.remove(&i).unwrap_or_default().finish();
+                if out.send((i, features)).is_err() {
+                    return;
+                }
+            }
+            Piece::Abort(i) => {
+                open.remove(&i);
+            }
+        }
+    }
+}
+
+/// Next message from a receiver shared by a worker pool
+fn pull<T>(input: &Mutex<Receiver<T>>) -> Option<T> {
+    input.lock().unwrap().recv().ok()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::filterflash::FilterFlashFunctor;
+
+    /// Reader yielding `step` bytes per call, failing at the end if `fail` is set
+    struct Source {
+        data: Vec<u8>,
+        at: usize,
+        step: usize,
+        fail: bool,
+    }
+
+    impl Read for Source {
+        fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+            if self.at == self.data.len() && self.fail {
+                return Err(io::Error::new(io::ErrorKind::BrokenPipe, "disk gone"));
+            }
+            let n = self.step.min(buf.len()).min(self.data.len() - self.at);
+            buf[..n].copy_from_slice(&self.data[self.at..self.at + n]);
+            self.at += n;
+            Ok(n)
+        }
+    }
+
+    #[test]
+    fn test_batch_matches_sequential_in_order() {
+        let artifacts: Vec<Vec<u8>> = (0..24)
+            .map(|i| format!("fn f{}() {{ call({}, \"s{}\"); }}\n", i % 5, i, i % 3).repeat(1 + i * 700).into_bytes())
+            .collect();
+        let functor = FilterFlash::new(vec![canonicalizer::canonicalize(&functor_features(&artifacts[2]))]);
+        let sources: Vec<Source> = artifacts
+            .iter()
+            .enumerate()
+            .map(|(i, data)| Source { data: data.clone(), at: 0, step: 1 + i * 997, fail: i == 7 })
+            .chain([Source { data: Vec::new(), at: 0, step: 1, fail: false }])
+            .collect();
+
+        // More readers than lanes, fewer, and one of each
+        for (readers, extractors) in [(3, 2), (1, 4), (4, 1)] {
+            let sources: Vec<Source> = sources
+                .iter()
+                .map(|s| Source { data: s.data.clone(), at: 0, step: s.step, fail: s.fail })
+                .collect();
+            let config = PipelineConfig { readers, extractors, canonicalizers: 2, scorers: 3, queue_depth: 1 };
+            let results = functor.transform_batch(sources, &config);
+            assert_eq!(results.len(), artifacts.len() + 1);
+            for (i, result) in results.iter().enumerate() {
+                match artifacts.get(i) {
+                    Some(_) if i == 7 => assert!(result.is_err()),
+                    Some(data) => assert_eq!(result.as_ref().unwrap(), &functor.transform(data), "artifact {}", i),
+                    None => assert_eq!(result.as_ref().unwrap(), &functor.transform(b"")),
+                }
+            }
+            assert_eq!(results[2].as_ref().unwrap().coherence, 1.0);
+        }
+    }
+
+    fn functor_features(artifact: &[u8]) -> FeatureVector {
+        FilterFlash::default().extract_features(artifact)
+    }
+}
@@ -0,0 +1,71 @@
+//! Coherence scoring
+//!
+//! An artifact's coherence is its highest Jaccard similarity to any
+//! corpus artifact, over sets of `SHINGLE`-byte windows of the
+//! canonical encodings. An empty corpus accepts everything.
+
+use std::collections::HashSet;
+
+use crate::audit::plpprofiler::{self, Probe};
+
+/// Window width for shingling canonical bytes
+pub const SHINGLE: usize = 4;
+
+/// Distinct `SHINGLE`-byte windows of `bytes`
+///
+/// Inputs shorter than one window become a single shingle.
+pub fn shingles(bytes: &[u8]) -> HashSet<u32> {
+    if bytes.len() < SHINGLE {
+        let mut window = [0u8; SHINGLE];
+        window[..bytes.len()].copy_from_slice(bytes);
+        window[SHINGLE - 1] |= (bytes.len() as u8) << 6;
+        return bytes.first().map(|_| u32::from_le_bytes(window)).into_iter().collect();
+    }
+    bytes.windows(SHINGLE).map(|w| u32::from_le_bytes([w[0], w[1], w[2], w[3]])).collect()
+}
+
+/// |a ∩ b| / |a ∪ b|, 1.0 for two empty sets
+pub fn jaccard(a: &HashSet<u32>, b: &HashSet<u32>) -> f64 {
+    let (small, large) = if a.len() <= b.len() { (a, b) } else { (b, a) };
+    let shared = small.iter().filter(|s| large.contains(s)).count();
+    let union = a.len() + b.len() - shared;
+    if union == 0 {
+        1.0
+    } else {
+        shared as f64 / union as f64
+    }
+}
+
+/// Coherence of `canonical` against `corpus`, in [0.0, 1.0]
+///
+/// O(total corpus size); stops early on an exact match.
+pub fn score(canonical: &[u8], corpus: &[&[u8]]) -> f64 {
+    let _span = plpprofiler::span(Probe::FilterScore);
+    if corpus.is_empty() {
+        return 1.0;
+    }
+    let own = shingles(canonical);
+    let mut best: f64 = 0.0;
+    for reference in corpus {
+        best = best.max(jaccard(&own, &shingles(reference)));
+        if best == 1.0 {
+            break;
+        }
+    }
+    best
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::filterflash::COHERENCE_GATE;
+
+    #[test]
+    fn test_coherence_gate() {
+        let artifact = b"test artifact";
+        assert!(score(artifact, &[b"unrelated", artifact]) >= COHERENCE_GATE);
+        assert!(score(artifact, &[b"unrelated"]) < COHERENCE_GATE);
+        assert_eq!(score(artifact, &[]), 1.0);
+        assert_eq!(jaccard(&shingles(b"ab"), &shingles(b"ab\0")), 0.0, "short inputs keep their length");
+    }
+}
@@ -3,19 +3,24 @@
 //! Implements:
 //! - Extended semantic versioning (major.minor.patch(channel))
 //! - Tri-node BiDAG resolution
+//! - Interned, snapshot-backed dependency graph resolver
 //! - FilterFlash coherence gating
 //! - Observer-mediated recovery
+//! - Feature-gated hot-path profiling and telemetry export
+//! - Parallel whole-lockfile resolution behind the `semverx` binary
 
 #![deny(unsafe_code)]
 #![warn(missing_docs)]
 
+pub mod audit;
+pub mod cli;
 pub mod core;
 pub mod filterflash;
 pub mod bidag;
 pub mod observer_gate;
 pub mod registry;
 pub mod nlm;
-pub mod polycall;
+pub mod resolver;
 
 pub use core::*;
 pub use filterflash::FilterFlashFunctor;
@@ -23,18 +28,150 @@ pub use bidag::{Node, Strategy};
 pub use observer_gate::FaultLevel;
 
 /// SemVerX version tuple
-#[derive(Debug, Clone, PartialEq, Eq)]
+///
+/// Ordered by (major, minor, patch), then by channel, the same order
+/// as its `PackedVersion` key.
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord, Hash)]
 pub struct SemVerX {
+    /// Incompatible API changes
     pub major: u32,
+    /// Backward-compatible features
     pub minor: u32,
+    /// Backward-compatible fixes
     pub patch: u32,
+    /// Release channel, `Stable` when the version string names none
     pub channel: Channel,
 }
 
-#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+/// Release channel of a version, ordered from least to most supported
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
 pub enum Channel {
+    /// Superseded releases kept for old consumers
     Legacy,
+    /// Previews without stability guarantees
     Experimental,
+    /// Regular releases
     Stable,
+    /// Long-term support releases
     LTS,
 }
+
+impl SemVerX {
+    /// Parse `major.minor.patch` with an optional `(channel)` suffix
+    ///
+    /// The channel defaults to `Stable` when omitted. Runs the
+    /// allocation-free NLM parser and falls back to `parse_gated` only
+    /// for input it flags as ambiguous.
+    pub fn parse(input: &str) -> Option<Self> {
+        match nlm::parser::parse_version(input.as_bytes()) {
+            Ok(version) => Some(version),
+            Err(nlm::parser::ParseError::Gated(_)) => Self::parse_gated(input),
+            Err(_) => None,
+        }
+    }
+
+    /// Observer-gated lenient path (signed or zero-padded components, non-ASCII)
+    pub(crate) fn parse_gated(input: &str) -> Option<Self> {
+        let (numbers, channel) = match input.find('(') {
+            Some(open) => {
+                let name = input[open + 1..].strip_suffix(')')?;
+                (&input[..open], Channel::from_name(name)?)
+            }
+            None => (input, Channel::Stable),
+        };
+
+        let mut parts = numbers.split('.');
+        let major = parts.next()?.parse().ok()?;
+        let minor = parts.next()?.parse().ok()?;
+        let patch = parts.next()?.parse().ok()?;
+        if parts.next().is_some() {
+            return None;
+        }
+
+        Some(Self { major, minor, patch, channel })
+    }
+
+    /// Canonical packed key, see `PackedVersion`
+    pub fn pack(&self) -> PackedVersion {
+        PackedVersion::new(self.major, self.minor, self.patch, self.channel)
+    }
+}
+
+/// SemVerX tuple packed into one integer key
+///
+/// Bits from high to low: major (32), minor (32), patch (32), channel
+/// (the low 32, holding `Channel as u8`). Comparing keys is a single
+/// u128 compare and orders exactly as `SemVerX` does.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct PackedVersion(u128);
+
+impl PackedVersion {
+    /// Key for `major.minor.patch(channel)`
+    pub const fn new(major: u32, minor: u32, patch: u32, channel: Channel) -> Self {
+        Self((major as u128) << 96 | (minor as u128) << 64 | (patch as u128) << 32 | channel as u128)
+    }
+
+    /// The raw key
+    pub const fn key(self) -> u128 {
+        self.0
+    }
+
+    /// Major version
+    pub const fn major(self) -> u32 {
+        (self.0 >> 96) as u32
+    }
+
+    /// Minor version
+    pub const fn minor(self) -> u32 {
+        (self.0 >> 64) as u32
+    }
+
+    /// Patch version
+    pub const fn patch(self) -> u32 {
+        (self.0 >> 32) as u32
+    }
+
+    /// Release channel
+    pub const fn channel(self) -> Channel {
+        Channel::from_code(self.0 as u8)
+    }
+
+    /// Unpacked tuple
+    pub fn unpack(self) -> SemVerX {
+        SemVerX { major: self.major(), minor: self.minor(), patch: self.patch(), channel: self.channel() }
+    }
+}
+
+impl From<&SemVerX> for PackedVersion {
+    fn from(version: &SemVerX) -> Self {
+        version.pack()
+    }
+}
+
+impl Channel {
+    /// Channel from its lowercase name, e.g. `stable` or `lts`
+    pub fn from_name(name: &str) -> Option<Self> {
+        match name {
+            "legacy" => Some(Self::Legacy),
+            "experimental" => Some(Self::Experimental),
+            "stable" => Some(Self::Stable),
+            "lts" => Some(Self::LTS),
+            _ => None,
+        }
+    }
+
+    /// Channel from its `Channel as u8` code
+    pub fn try_from_code(code: u8) -> Option<Self> {
+        (code < 4).then(|| Self::from_code(code))
+    }
+
+    /// Channel from its `Channel as u8` code; only the low two bits are read
+    const fn from_code(code: u8) -> Self {
+        match code & 3 {
+            0 => Self::Legacy,
+            1 => Self::Experimental,
+            2 => Self::Stable,
+            _ => Self::LTS,
+        }
+    }
+}
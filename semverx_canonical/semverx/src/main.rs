@@ -0,0 +1,7 @@
+//! `semverx` binary; see `semverx::cli`
+
+fn main() {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let code = semverx::cli::run(&args, std::io::stdout().lock(), std::io::stderr());
+    std::process::exit(code);
+}
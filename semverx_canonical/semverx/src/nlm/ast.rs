@@ -0,0 +1,34 @@
+//! Compact AST for version and range expressions
+//!
+//! Every node is `Copy` and fixed-size: parsing a version or range
+//! never allocates. Versions parse straight into `SemVerX`.
+
+use crate::Channel;
+
+/// Range operator
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum RangeOp {
+    /// `^1.2`: compatible updates
+    Caret,
+    /// `~1.2`: patch-level updates
+    Tilde,
+    /// `=1.2` or bare `1.2`: exact in the components given
+    Exact,
+    /// `>=1.2`: no upper bound
+    AtLeast,
+    /// `*`: every version
+    Any,
+}
+
+/// Range expression such as `^1.2(stable)`
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct RangeAst {
+    /// Operator
+    pub op: RangeOp,
+    /// Major, minor, patch as written; missing components are 0
+    pub parts: [u32; 3],
+    /// How many components were written (0 for `*`)
+    pub given: u8,
+    /// Channel pin from a `(channel)` suffix
+    pub channel: Option<Channel>,
+}
@@ -0,0 +1,260 @@
+//! Table-driven lexer over `&[u8]`
+//!
+//! One 256-entry class table decides every byte; tokens borrow their
+//! text from the input. Digit runs are found eight bytes at a time
+//! (SWAR) and converted with three multiply-shift steps, so a typical
+//! version component costs a single 64-bit load.
+//!
+//! Bytes the fast path cannot judge on its own (`+`, non-ASCII, leading
+//! zeros) move the lexer to `LexState::Gated` instead of guessing.
+
+use super::parser::{Ambiguity, ParseError};
+use super::LexState;
+
+/// Token kinds of version and range expressions
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TokenKind {
+    /// Decimal component, already converted
+    Number(u32),
+    /// `.`
+    Dot,
+    /// `(`
+    Open,
+    /// `)`
+    Close,
+    /// `^`
+    Caret,
+    /// `~`
+    Tilde,
+    /// `=`
+    Eq,
+    /// `>=`
+    Ge,
+    /// `*`
+    Star,
+    /// ASCII letters, e.g. a channel name
+    Word,
+    /// End of input
+    End,
+}
+
+/// Token borrowing its text from the input
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Token<'a> {
+    /// Kind, with the value for numbers
+    pub kind: TokenKind,
+    /// Source bytes of the token
+    pub text: &'a [u8],
+    /// Byte offset in the input
+    pub at: usize,
+}
+
+const OTHER: u8 = 0;
+const DIGIT: u8 = 1;
+const ALPHA: u8 = 2;
+const PUNCT: u8 = 3;
+const GATED: u8 = 4;
+
+/// Byte classes; punctuation is resolved by a second match on the byte
+static CLASS: [u8; 256] = classes();
+
+const fn classes() -> [u8; 256] {
+    let mut table = [OTHER; 256];
+    let mut b = 0;
+    while b < 256 {
+        table[b] = match b as u8 {
+            b'0'..=b'9' => DIGIT,
+            b'a'..=b'z' | b'A'..=b'Z' => ALPHA,
+            b'.' | b'(' | b')' | b'^' | b'~' | b'=' | b'>' | b'*' => PUNCT,
+            b'+' | 0x80..=0xFF => GATED,
+            _ => OTHER,
+        };
+        b += 1;
+    }
+    table
+}
+
+const ONES: u64 = 0x0101_0101_0101_0101;
+
+/// Length of the digit run at the start of `word` (little-endian), 0..=8
+///
+/// A byte is a digit iff `b ^ 0x30` is below 10, i.e. neither it nor
+/// itself plus 6 reaches the high nibble. Only non-digit bytes can carry
+/// into their neighbour, and that neighbour lies past the run.
+fn digit_run(word: u64) -> usize {
+    let t = word ^ (0x30 * ONES);
+    let bad = (t | t.wrapping_add(0x06 * ONES)) & (0xF0 * ONES);
+    (bad.trailing_zeros() / 8) as usize
+}
+
+/// Value of the first `len` (1..=8) ASCII digits of `word`
+fn digits_value(word: u64, len: usize) -> u64 {
+    // Shift the run to the top bytes; the vacated low bytes read as leading zeros
+    let mut v = (word << (64 - 8 * len as u32)) & (0x0F * ONES);
+    v = (v * 10 + (v >> 8)) & 0x00FF_00FF_00FF_00FF;
+    v = (v * 100 + (v >> 16)) & 0x0000_FFFF_0000_FFFF;
+    (v * 10_000 + (v >> 32)) & 0xFFFF_FFFF
+}
+
+/// Eight bytes from `at`, padded with a non-digit past the end
+fn load(input: &[u8], at: usize) -> u64 {
+    match input.get(at..at + 8) {
+        Some(bytes) => u64::from_le_bytes(bytes.try_into().unwrap()),
+        None => {
+            let mut word = [0u8; 8];
+            let tail = &input[at.min(input.len())..];
+            word[..tail.len()].copy_from_slice(tail);
+            u64::from_le_bytes(word)
+        }
+    }
+}
+
+/// Streaming lexer for one expression
+#[derive(Debug, Clone)]
+pub struct Lexer<'a> {
+    input: &'a [u8],
+    pos: usize,
+    state: LexState,
+}
+
+impl<'a> Lexer<'a> {
+    /// Lexer at the start of `input`
+    pub fn new(input: &'a [u8]) -> Self {
+        Self { input, pos: 0, state: LexState::Start }
+    }
+
+    /// Current machine state
+    pub fn state(&self) -> LexState {
+        self.state
+    }
+
+    /// Next token, O(token length)
+    pub fn next_token(&mut self) -> Result<Token<'a>, ParseError> {
+        let at = self.pos;
+        let Some(&b) = self.input.get(at) else {
+            return Ok(Token { kind: TokenKind::End, text: &[], at });
+        };
+        self.state = LexState::Scan;
+
+        let kind = match CLASS[b as usize] {
+            DIGIT => return self.number(at),
+            ALPHA => {
+                let len = self.input[at..].iter().take_while(|b| b.is_ascii_alphabetic()).count();
+                self.pos += len;
+                TokenKind::Word
+            }
+            PUNCT => {
+                self.pos += 1;
+                match b {
+                    b'.' => TokenKind::Dot,
+                    b'(' => TokenKind::Open,
+                    b')' => TokenKind::Close,
+                    b'^' => TokenKind::Caret,
+                    b'~' => TokenKind::Tilde,
+                    b'*' => TokenKind::Star,
+                    b'=' => TokenKind::Eq,
+                    _ if self.input.get(at + 1) == Some(&b'=') => {
+                        self.pos += 1;
+                        TokenKind::Ge
+                    }
+                    _ => return Err(self.fail(ParseError::Unexpected { at })),
+                }
+            }
+            GATED if b == b'+' => return Err(self.gate(Ambiguity::ExplicitSign { at })),
+            GATED => return Err(self.gate(Ambiguity::NonAscii { at })),
+            _ => return Err(self.fail(ParseError::Unexpected { at })),
+        };
+        Ok(Token { kind, text: &self.input[at..self.pos], at })
+    }
+
+    fn number(&mut self, at: usize) -> Result<Token<'a>, ParseError> {
+        let first = load(self.input, at);
+        let mut len = digit_run(first);
+        let mut value = digits_value(first, len);
+        if len == 8 {
+            // u32 has at most 10 digits; a second word finishes or rules out the run
+            let second = load(self.input, at + 8);
+            let more = digit_run(second);
+            if (1..=2).contains(&more) {
+                value = value * 10u64.pow(more as u32) + digits_value(second, more);
+            }
+            len += more;
+        }
+
+        if len > 1 && self.input[at] == b'0' {
+            return Err(self.gate(Ambiguity::LeadingZero { at }));
+        }
+        if len > 10 || value > u32::MAX as u64 {
+            return Err(self.fail(ParseError::Overflow { at }));
+        }
+        self.pos = at + len;
+        Ok(Token { kind: TokenKind::Number(value as u32), text: &self.input[at..self.pos], at })
+    }
+
+    fn fail(&mut self, error: ParseError) -> ParseError {
+        self.state = LexState::Error;
+        error
+    }
+
+    fn gate(&mut self, ambiguity: Ambiguity) -> ParseError {
+        self.state = LexState::Gated;
+        ParseError::Gated(ambiguity)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn kinds(input: &str) -> Vec<TokenKind> {
+        let mut lexer = Lexer::new(input.as_bytes());
+        let mut kinds = Vec::new();
+        loop {
+            let token = lexer.next_token().unwrap();
+            kinds.push(token.kind);
+            if token.kind == TokenKind::End {
+                return kinds;
+            }
+        }
+    }
+
+    #[test]
+    fn test_swar_digit_runs() {
+        for n in [0u64, 7, 42, 12_345_678, 123_456_789, 4_294_967_295] {
+            let text = n.to_string();
+            assert_eq!(kinds(&text), [TokenKind::Number(n as u32), TokenKind::End], "{}", text);
+        }
+        assert_eq!(
+            kinds(">=10.200.3000(lts)"),
+            [
+                TokenKind::Ge,
+                TokenKind::Number(10),
+                TokenKind::Dot,
+                TokenKind::Number(200),
+                TokenKind::Dot,
+                TokenKind::Number(3000),
+                TokenKind::Open,
+                TokenKind::Word,
+                TokenKind::Close,
+                TokenKind::End,
+            ]
+        );
+        assert_eq!(Lexer::new(b"4294967296").next_token(), Err(ParseError::Overflow { at: 0 }));
+        assert_eq!(Lexer::new(b"12345678901").next_token(), Err(ParseError::Overflow { at: 0 }));
+    }
+
+    #[test]
+    fn test_ambiguous_bytes_gate() {
+        let mut lexer = Lexer::new(b"1.02");
+        lexer.next_token().unwrap();
+        lexer.next_token().unwrap();
+        assert_eq!(lexer.next_token(), Err(ParseError::Gated(Ambiguity::LeadingZero { at: 2 })));
+        assert_eq!(lexer.state(), LexState::Gated);
+
+        assert_eq!(Lexer::new(b"+1").next_token(), Err(ParseError::Gated(Ambiguity::ExplicitSign { at: 0 })));
+        assert_eq!(Lexer::new("１".as_bytes()).next_token(), Err(ParseError::Gated(Ambiguity::NonAscii { at: 0 })));
+        let mut lexer = Lexer::new(b" 1");
+        assert_eq!(lexer.next_token(), Err(ParseError::Unexpected { at: 0 }));
+        assert_eq!(lexer.state(), LexState::Error);
+    }
+}
@@ -1,25 +1,36 @@
 //! Neuro-Linguistic Mechanical Layer
 //! 
 //! Lexer → Parser → AST with observer-gated states
+//! Allocation-free fast path for version and range expressions
 
 pub mod lexer;
 pub mod parser;
 pub mod ast;
-pub mod atlas;
 
+/// Lexer state
 #[derive(Debug, Clone, Copy, PartialEq)]
 pub enum LexState {
+    /// Before the first token
     Start,
+    /// Consuming tokens
     Scan,
+    /// Unrecognized input
     Error,
-    Gated,  // Observer required
+    /// Observer required
+    Gated,
 }
 
+/// Parser state
 #[derive(Debug, Clone, Copy, PartialEq)]
 pub enum ParseState {
+    /// Waiting for input
     Ready,
+    /// Building the AST
     Build,
+    /// Input admits more than one reading
     Conflict,
+    /// Settling a conflict
     Resolve,
+    /// Input rejected
     Error,
 }
@@ -0,0 +1,237 @@
+//! Allocation-free parser for versions and ranges
+//!
+//! Fast-path grammar, over the tokens of `lexer`:
+//!
+//! ```text
+//! version := NUM '.' NUM '.' NUM channel?
+//! range   := ( '*' | op? NUM ( '.' NUM ){0,2} ) channel?
+//! op      := '^' | '~' | '=' | '>='
+//! channel := '(' WORD ')'
+//! ```
+//!
+//! Input the fast path will not judge comes back as `ParseError::Gated`;
+//! callers hand it to the observer-gated lenient path instead of
+//! guessing, so both paths together accept exactly what the lenient
+//! path alone accepts.
+
+use std::fmt;
+
+use crate::{Channel, SemVerX};
+use super::ast::{RangeAst, RangeOp};
+use super::lexer::{Lexer, Token, TokenKind};
+
+/// Why the fast path handed input to the observer
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Ambiguity {
+    /// `01`: zero-padded component
+    LeadingZero {
+        /// Offset of the component's first digit
+        at: usize,
+    },
+    /// `+1`: explicitly signed component
+    ExplicitSign {
+        /// Offset of the `+`
+        at: usize,
+    },
+    /// Byte outside ASCII (Unicode digits or whitespace)
+    NonAscii {
+        /// Offset of the first non-ASCII byte; ranges report it
+        /// before trimming, into the input as given
+        at: usize,
+    },
+    /// `(Stable)`: channel name in the wrong case
+    ChannelCase {
+        /// Offset of the name, just past `(`
+        at: usize,
+    },
+}
+
+/// Fast-path parse failure; offsets are into the (trimmed) expression
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ParseError {
+    /// Token not allowed here
+    Unexpected {
+        /// Offset of the token; the input length at end of input
+        at: usize,
+    },
+    /// Component does not fit in `u32`
+    Overflow {
+        /// Offset of the component's first digit
+        at: usize,
+    },
+    /// `(name)` names no channel
+    UnknownChannel {
+        /// Offset of the name, just past `(`
+        at: usize,
+    },
+    /// Needs the observer-gated path
+    Gated(Ambiguity),
+}
+
+impl fmt::Display for ParseError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Unexpected { at } => write!(f, "unexpected input at byte {}", at),
+            Self::Overflow { at } => write!(f, "version component at byte {} overflows u32", at),
+            Self::UnknownChannel { at } => write!(f, "unknown channel at byte {}", at),
+            Self::Gated(ambiguity) => write!(f, "ambiguous input, observer required: {:?}", ambiguity),
+        }
+    }
+}
+
+impl std::error::Error for ParseError {}
+
+/// Parse `major.minor.patch(channel)`; the channel defaults to `Stable`
+pub fn parse_version(input: &[u8]) -> Result<SemVerX, ParseError> {
+    let mut lexer = Lexer::new(input);
+    let major = number(lexer.next_token()?)?;
+    expect(&mut lexer, TokenKind::Dot)?;
+    let minor = number(lexer.next_token()?)?;
+    expect(&mut lexer, TokenKind::Dot)?;
+    let patch = number(lexer.next_token()?)?;
+    let channel = channel_suffix(&mut lexer)?.unwrap_or(Channel::Stable);
+    Ok(SemVerX { major, minor, patch, channel })
+}
+
+/// Parse a range such as `^1.2(stable)`, `>=1.0` or `*`
+///
+/// Surrounding whitespace is ignored.
+pub fn parse_range(input: &[u8]) -> Result<RangeAst, ParseError> {
+    // Unicode whitespace may be trimmed too, so any non-ASCII byte gates up front
+    if let Some(at) = input.iter().position(|b| !b.is_ascii()) {
+        return Err(ParseError::Gated(Ambiguity::NonAscii { at }));
+    }
+    let mut lexer = Lexer::new(trim(input));
+    let first = lexer.next_token()?;
+    let op = match first.kind {
+        TokenKind::Star => {
+            let channel = channel_suffix(&mut lexer)?;
+            return Ok(RangeAst { op: RangeOp::Any, parts: [0; 3], given: 0, channel });
+        }
+        TokenKind::Caret => RangeOp::Caret,
+        TokenKind::Tilde => RangeOp::Tilde,
+        TokenKind::Eq => RangeOp::Exact,
+        TokenKind::Ge => RangeOp::AtLeast,
+        TokenKind::Number(_) => RangeOp::Exact,
+        _ => return Err(unexpected(first)),
+    };
+
+    let mut parts = [0u32; 3];
+    parts[0] = number(if let TokenKind::Number(_) = first.kind { first } else { lexer.next_token()? })?;
+    let mut given = 1;
+    loop {
+        let token = lexer.next_token()?;
+        if token.kind != TokenKind::Dot {
+            let channel = channel_after(&mut lexer, token)?;
+            return Ok(RangeAst { op, parts, given: given as u8, channel });
+        }
+        if given == 3 {
+            return Err(unexpected(token));
+        }
+        parts[given] = number(lexer.next_token()?)?;
+        given += 1;
+    }
+}
+
+/// Whitespace as `str::trim` sees it, restricted to ASCII
+fn trim(input: &[u8]) -> &[u8] {
+    let space = |b: &u8| matches!(b, b'\t' | b'\n' | 0x0B | 0x0C | b'\r' | b' ');
+    let start = input.iter().position(|b| !space(b)).unwrap_or(input.len());
+    let end = input.iter().rposition(|b| !space(b)).map_or(start, |i| i + 1);
+    &input[start..end]
+}
+
+fn number(token: Token<'_>) -> Result<u32, ParseError> {
+    match token.kind {
+        TokenKind::Number(n) => Ok(n),
+        _ => Err(unexpected(token)),
+    }
+}
+
+fn expect(lexer: &mut Lexer<'_>, kind: TokenKind) -> Result<(), ParseError> {
+    let token = lexer.next_token()?;
+    if token.kind == kind {
+        Ok(())
+    } else {
+        Err(unexpected(token))
+    }
+}
+
+fn unexpected(token: Token<'_>) -> ParseError {
+    ParseError::Unexpected { at: token.at }
+}
+
+/// Optional `(channel)` and the end of input
+fn channel_suffix(lexer: &mut Lexer<'_>) -> Result<Option<Channel>, ParseError> {
+    let token = lexer.next_token()?;
+    channel_after(lexer, token)
+}
+
+fn channel_after(lexer: &mut Lexer<'_>, token: Token<'_>) -> Result<Option<Channel>, ParseError> {
+    match token.kind {
+        TokenKind::End => return Ok(None),
+        TokenKind::Open => {}
+        _ => return Err(unexpected(token)),
+    }
+    let word = lexer.next_token()?;
+    if word.kind != TokenKind::Word {
+        return Err(unexpected(word));
+    }
+    expect(lexer, TokenKind::Close)?;
+    expect(lexer, TokenKind::End)?;
+
+    // Words are ASCII letters, so always valid UTF-8
+    let name = std::str::from_utf8(word.text).map_err(|_| unexpected(word))?;
+    match Channel::from_name(name) {
+        Some(channel) => Ok(Some(channel)),
+        None if ["legacy", "experimental", "stable", "lts"].iter().any(|c| c.eq_ignore_ascii_case(name)) => {
+            Err(ParseError::Gated(Ambiguity::ChannelCase { at: word.at }))
+        }
+        None => Err(ParseError::UnknownChannel { at: word.at }),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::registry::VersionReq;
+
+    #[test]
+    fn test_versions_and_ranges() {
+        let lts = parse_version(b"1.20.300(lts)").unwrap();
+        assert_eq!((lts.major, lts.minor, lts.patch, lts.channel), (1, 20, 300, Channel::LTS));
+        assert_eq!(parse_version(b"0.0.0").unwrap().channel, Channel::Stable);
+        assert_eq!(parse_version(b"1.2"), Err(ParseError::Unexpected { at: 3 }));
+        assert_eq!(parse_version(b"1.2.3(nightly)"), Err(ParseError::UnknownChannel { at: 6 }));
+        assert_eq!(parse_version(b"1.2.3(LTS)"), Err(ParseError::Gated(Ambiguity::ChannelCase { at: 6 })));
+
+        let range = parse_range(b" >=1.2(experimental) ").unwrap();
+        assert_eq!(range.op, RangeOp::AtLeast);
+        assert_eq!((range.parts, range.given, range.channel), ([1, 2, 0], 2, Some(Channel::Experimental)));
+        assert_eq!(parse_range(b"*").unwrap().op, RangeOp::Any);
+        assert_eq!(parse_range(b"1.2.3.4"), Err(ParseError::Unexpected { at: 5 }));
+        assert!(parse_range(b"^01").is_err());
+    }
+
+    /// Fast path plus gated fallback must agree with the lenient parsers alone
+    #[test]
+    fn test_matches_lenient_path() {
+        let alphabet: Vec<&str> = vec![
+            "0", "1", "9", "00", "42", "4294967295", "4294967296", ".", "(", ")", "^", "~", "=", ">", ">=", "*",
+            "+", " ", "\u{b}", "stable", "LTS", "lts", "x", "\u{a0}", "１", "-",
+        ];
+        let mut state = 0x2545_f491_4f6c_dd1du64;
+        for _ in 0..20_000 {
+            let mut input = String::new();
+            for _ in 0..(state % 9) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                input.push_str(alphabet[(state % alphabet.len() as u64) as usize]);
+            }
+            state = state.wrapping_mul(0x9e37_79b9_7f4a_7c15) | 1;
+            assert_eq!(SemVerX::parse(&input), SemVerX::parse_gated(&input), "version {:?}", input);
+            assert_eq!(VersionReq::parse(&input), VersionReq::parse_gated(&input), "range {:?}", input);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+//! Fault adjudication
+//!
+//! The adjudicator owns the consuming side of a `FaultRing`. It drains
+//! events in batches and decides on rollback from the ring's atomic
+//! flag, so the decision never waits behind queued events. Between
+//! batches it parks; a rollback-level report unparks it, which bounds
+//! rollback reaction time by a wake-up rather than by the poll interval.
+
+use std::sync::Arc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use super::fault_ring::{FaultEvent, FaultRing};
+use super::FaultLevel;
+
+/// Events drained per batch by default
+pub const DEFAULT_BATCH: usize = 1024;
+
+/// Outcome of one adjudication round
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Verdict {
+    /// Oldest-first events drained this round
+    pub events: Vec<FaultEvent>,
+    /// A rollback-level fault was reported since the previous verdict
+    pub rollback: bool,
+    /// Highest level (by code band) among the drained events
+    pub worst: Option<FaultLevel>,
+}
+
+/// Batch consumer of one fault ring
+#[derive(Debug)]
+pub struct Adjudicator {
+    ring: Arc<FaultRing>,
+    batch: usize,
+}
+
+impl Adjudicator {
+    /// Adjudicator draining `ring` in batches of `DEFAULT_BATCH`
+    pub fn new(ring: Arc<FaultRing>) -> Self {
+        Self::with_batch(ring, DEFAULT_BATCH)
+    }
+
+    /// Adjudicator draining at most `batch` events per round
+    pub fn with_batch(ring: Arc<FaultRing>, batch: usize) -> Self {
+        Self { ring, batch: batch.max(1) }
+    }
+
+    /// The ring producers report into
+    pub fn ring(&self) -> &Arc<FaultRing> {
+        &self.ring
+    }
+
+    /// One round without waiting: drain a batch and take the rollback flag
+    pub fn poll(&mut self) -> Verdict {
+        let mut events = Vec::new();
+        self.ring.drain(&mut events, self.batch);
+        let worst = events.iter().map(FaultEvent::level).max_by_key(|level| *level as u8);
+        Verdict { rollback: self.ring.take_rollback(), events, worst }
+    }
+
+    /// Wait until a rollback is pending or `timeout` lapses, then `poll`
+    ///
+    /// Only a rollback-level report cuts the wait short. Other events
+    /// do not wake the waiter; they are drained when the timeout
+    /// lapses, so `timeout` is their batching window. That keeps
+    /// `FaultRing::report` free of any wake-up check for ordinary events.
+    ///
+    /// The ring has a single waiter: the first thread ever to call this
+    /// (on any adjudicator of the ring). If the adjudicator later moves
+    /// to another thread, rollbacks no longer wake it, and `next`
+    /// degrades to waiting out the full timeout. Call `next` from one
+    /// dedicated thread.
+    pub fn next(&mut self, timeout: Duration) -> Verdict {
+        self.ring.register_waiter(thread::current());
+        let deadline = Instant::now() + timeout;
+        loop {
+            if self.ring.rollback_pending() {
+                break;
+            }
+            let now = Instant::now();
+            if now >= deadline {
+                break;
+            }
+            thread::park_timeout(deadline - now);
+        }
+        self.poll()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_rollback_wakes_parked_adjudicator() {
+        let ring = Arc::new(FaultRing::new(64));
+        let mut adjudicator = Adjudicator::with_batch(Arc::clone(&ring), 4);
+
+        for code in [0, 7, 3, 8, 1] {
+            ring.report(FaultEvent { code, source: 0 });
+        }
+        let verdict = adjudicator.poll();
+        assert_eq!(verdict.events.len(), 4);
+        assert_eq!(verdict.worst, Some(FaultLevel::Danger));
+        assert!(!verdict.rollback);
+
+        let reporter = {
+            let ring = Arc::clone(&ring);
+            thread::spawn(move || {
+                thread::sleep(Duration::from_millis(20));
+                ring.report(FaultEvent { code: 19, source: 9 });
+            })
+        };
+        let started = Instant::now();
+        let verdict = adjudicator.next(Duration::from_secs(30));
+        assert!(started.elapsed() < Duration::from_secs(10));
+        assert!(verdict.rollback);
+        reporter.join().unwrap();
+
+        let rest = adjudicator.poll();
+        let codes: Vec<u8> = verdict.events.iter().chain(&rest.events).map(|e| e.code).collect();
+        assert_eq!(codes, vec![1, 19]);
+    }
+}
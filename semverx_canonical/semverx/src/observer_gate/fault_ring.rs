@@ -0,0 +1,246 @@
+//! Lock-free fault event ingestion
+//!
+//! Resolver and hot-swap threads report faults into a bounded
+//! multi-producer ring (Vyukov's sequenced-slot queue): a report is one
+//! CAS on the shared tail plus two stores, and never waits on the
+//! adjudicator. Per-level counts and the pending-rollback flag are
+//! updated on every report, before the event is queued, so a full ring
+//! drops the event's details but never its rollback signal.
+
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+use std::sync::OnceLock;
+use std::thread::Thread;
+
+use super::FaultLevel;
+
+/// Number of `FaultLevel`s, for per-level counters
+pub const LEVELS: usize = 6;
+
+/// One reported fault
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct FaultEvent {
+    /// Fault code, 0-33
+    pub code: u8,
+    /// Reporting component, e.g. a resolver or hot-swap worker id
+    pub source: u32,
+}
+
+impl FaultEvent {
+    /// Severity of the fault
+    pub fn level(&self) -> FaultLevel {
+        FaultLevel::from_code(self.code)
+    }
+
+    fn pack(self) -> u64 {
+        (self.source as u64) << 8 | self.code as u64
+    }
+
+    fn unpack(bits: u64) -> Self {
+        Self { code: bits as u8, source: (bits >> 8) as u32 }
+    }
+}
+
+/// Keeps the producer and consumer cursors on separate cache lines
+#[derive(Debug, Default)]
+#[repr(align(64))]
+struct Padded<T>(T);
+
+/// Ring slot: `sequence` says whose turn it is, `event` holds the packed event
+#[derive(Debug)]
+struct Slot {
+    sequence: AtomicUsize,
+    event: AtomicU64,
+}
+
+/// Bounded lock-free fault queue with per-level counters
+#[derive(Debug)]
+pub struct FaultRing {
+    slots: Box<[Slot]>,
+    mask: usize,
+    tail: Padded<AtomicUsize>,
+    head: Padded<AtomicUsize>,
+    counts: [AtomicU64; LEVELS],
+    dropped: AtomicU64,
+    rollback: AtomicBool,
+    waiter: OnceLock<Thread>,
+}
+
+impl FaultRing {
+    /// Ring holding `capacity` events, rounded up to a power of two
+    pub fn new(capacity: usize) -> Self {
+        let capacity = capacity.max(2).next_power_of_two();
+        Self {
+            slots: (0..capacity).map(|i| Slot { sequence: AtomicUsize::new(i), event: AtomicU64::new(0) }).collect(),
+            mask: capacity - 1,
+            tail: Padded::default(),
+            head: Padded::default(),
+            counts: Default::default(),
+            dropped: AtomicU64::new(0),
+            rollback: AtomicBool::new(false),
+            waiter: OnceLock::new(),
+        }
+    }
+
+    /// Events the ring holds at most
+    pub fn capacity(&self) -> usize {
+        self.slots.len()
+    }
+
+    /// Report a fault, from any thread
+    ///
+    /// Lock-free and wait-free unless the tail CAS races another
+    /// producer. Returns false if the ring was full and the event was
+    /// dropped; it is still counted, and a rollback-level fault still
+    /// raises the rollback flag and wakes the adjudicator.
+    pub fn report(&self, event: FaultEvent) -> bool {
+        let level = event.level();
+        self.counts[level as usize].fetch_add(1, Ordering::Relaxed);
+        if level.requires_rollback() && !self.rollback.swap(true, Ordering::AcqRel) {
+            if let Some(waiter) = self.waiter.get() {
+                waiter.unpark();
+            }
+        }
+
+        let mut pos = self.tail.0.load(Ordering::Relaxed);
+        loop {
+            let slot = &self.slots[pos & self.mask];
+            let sequence = slot.sequence.load(Ordering::Acquire);
+            match (sequence as isize).wrapping_sub(pos as isize) {
+                0 => match self.tail.0.compare_exchange_weak(pos, pos + 1, Ordering::Relaxed, Ordering::Relaxed) {
+                    Ok(_) => {
+                        slot.event.store(event.pack(), Ordering::Relaxed);
+                        slot.sequence.store(pos + 1, Ordering::Release);
+                        return true;
+                    }
+                    Err(current) => pos = current,
+                },
+                lag if lag < 0 => {
+                    self.dropped.fetch_add(1, Ordering::Relaxed);
+                    return false;
+                }
+                _ => pos = self.tail.0.load(Ordering::Relaxed),
+            }
+        }
+    }
+
+    /// Move up to `max` queued events into `out`, oldest first; returns how many
+    pub fn drain(&self, out: &mut Vec<FaultEvent>, max: usize) -> usize {
+        let mut taken = 0;
+        let mut pos = self.head.0.load(Ordering::Relaxed);
+        while taken < max {
+            let slot = &self.slots[pos & self.mask];
+            let sequence = slot.sequence.load(Ordering::Acquire);
+            match (sequence as isize).wrapping_sub(pos.wrapping_add(1) as isize) {
+                0 => match self.head.0.compare_exchange_weak(pos, pos + 1, Ordering::Relaxed, Ordering::Relaxed) {
+                    Ok(_) => {
+                        out.push(FaultEvent::unpack(slot.event.load(Ordering::Relaxed)));
+                        slot.sequence.store(pos + self.mask + 1, Ordering::Release);
+                        pos += 1;
+                        taken += 1;
+                    }
+                    Err(current) => pos = current,
+                },
+                lag if lag < 0 => break,
+                _ => pos = self.head.0.load(Ordering::Relaxed),
+            }
+        }
+        taken
+    }
+
+    /// Faults reported at `level` so far, dropped ones included
+    pub fn count(&self, level: FaultLevel) -> u64 {
+        self.counts[level as usize].load(Ordering::Relaxed)
+    }
+
+    /// Faults reported at each level, indexed by `FaultLevel as usize`
+    pub fn counts(&self) -> [u64; LEVELS] {
+        std::array::from_fn(|i| self.counts[i].load(Ordering::Relaxed))
+    }
+
+    /// Events lost to a full ring
+    pub fn dropped(&self) -> u64 {
+        self.dropped.load(Ordering::Relaxed)
+    }
+
+    /// Clear and return the pending-rollback flag
+    pub fn take_rollback(&self) -> bool {
+        self.rollback.swap(false, Ordering::AcqRel)
+    }
+
+    /// True if a rollback-level fault arrived since the last `take_rollback`
+    pub fn rollback_pending(&self) -> bool {
+        self.rollback.load(Ordering::Acquire)
+    }
+
+    /// Make `thread` the one woken by rollback-level faults
+    ///
+    /// Only the first registration takes effect, for the life of the
+    /// ring; returns whether this one did.
+    pub fn register_waiter(&self, thread: Thread) -> bool {
+        self.waiter.set(thread).is_ok()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::thread;
+
+    #[test]
+    fn test_storm_loses_nothing_but_details() {
+        let ring = FaultRing::new(1000);
+        assert_eq!(ring.capacity(), 1024);
+        let per_thread = 5_000u32;
+        let mut drained = Vec::new();
+
+        thread::scope(|scope| {
+            for t in 0..8u32 {
+                let ring = &ring;
+                scope.spawn(move || {
+                    for i in 0..per_thread {
+                        ring.report(FaultEvent { code: (i % 12) as u8, source: t << 16 | i });
+                    }
+                });
+            }
+            let mut idle = 0;
+            while idle < 1000 {
+                if ring.drain(&mut drained, 256) == 0 {
+                    idle += 1;
+                    thread::yield_now();
+                } else {
+                    idle = 0;
+                }
+            }
+        });
+        ring.drain(&mut drained, usize::MAX);
+
+        let total = 8 * per_thread as u64;
+        assert_eq!(drained.len() as u64 + ring.dropped(), total);
+        assert_eq!(ring.count(FaultLevel::Warning) + ring.count(FaultLevel::Danger), total);
+        assert!(!ring.rollback_pending());
+
+        // Each producer's surviving events stay in its own report order
+        for t in 0..8u32 {
+            let seen: Vec<u32> = drained.iter().filter(|e| e.source >> 16 == t).map(|e| e.source & 0xffff).collect();
+            assert!(seen.windows(2).all(|w| w[0] < w[1]));
+        }
+    }
+
+    #[test]
+    fn test_full_ring_keeps_rollback_signal() {
+        let ring = FaultRing::new(2);
+        assert!(ring.report(FaultEvent { code: 0, source: 1 }));
+        assert!(ring.report(FaultEvent { code: 1, source: 2 }));
+        assert!(!ring.report(FaultEvent { code: 20, source: 3 }));
+        assert_eq!(ring.dropped(), 1);
+        assert_eq!(ring.count(FaultLevel::Critical), 1);
+        assert!(ring.take_rollback());
+        assert!(!ring.take_rollback());
+
+        let mut out = Vec::new();
+        assert_eq!(ring.drain(&mut out, 1), 1);
+        assert!(ring.report(FaultEvent { code: 33, source: 4 }));
+        assert_eq!(ring.drain(&mut out, 8), 2);
+        assert_eq!(out.iter().map(|e| e.source).collect::<Vec<_>>(), vec![1, 2, 4]);
+    }
+}
@@ -0,0 +1,52 @@
+//! Observer-Mediated Recovery Architecture
+//! 
+//! 34-level fault taxonomy with auto-rollback
+//!
+//! Faults are ingested through a lock-free multi-producer ring and
+//! adjudicated in batches, off the request path. Rollback restores the
+//! last confirmed generation of registry and graph state in one swap.
+
+pub mod adjudicator;
+pub mod fault_ring;
+pub mod recovery;
+
+pub use adjudicator::{Adjudicator, Verdict};
+pub use fault_ring::{FaultEvent, FaultRing};
+pub use recovery::{Recovery, RecoveryState};
+
+/// Severity band of a fault code
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FaultLevel {
+    /// Codes 0-5
+    Warning,
+    /// Codes 6-11
+    Danger,
+    /// Codes 12-17: the observer takes over
+    ObserverActive,
+    /// Codes 18-23
+    Critical,
+    /// Codes 24-29: recovery in progress
+    Healing,
+    /// Codes 30-33
+    Termination,
+}
+
+impl FaultLevel {
+    /// Band of `code`; codes past 33 count as `Termination`
+    pub fn from_code(code: u8) -> Self {
+        match code {
+            0..=5 => Self::Warning,
+            6..=11 => Self::Danger,
+            12..=17 => Self::ObserverActive,
+            18..=23 => Self::Critical,
+            24..=29 => Self::Healing,
+            30..=33 => Self::Termination,
+            _ => Self::Termination,
+        }
+    }
+    
+    /// True for the bands that roll back to the last confirmed generation
+    pub fn requires_rollback(&self) -> bool {
+        matches!(self, Self::ObserverActive | Self::Critical | Self::Termination)
+    }
+}
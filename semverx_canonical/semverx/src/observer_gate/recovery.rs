@@ -0,0 +1,275 @@
+//! Generation ring with O(1) rollback
+//!
+//! Recovery keeps the last few generations of registry and resolver
+//! graph state as immutable snapshots behind one atomic pointer.
+//! Readers load the current generation without locking; a rollback
+//! stores the pointer of the newest confirmed generation, so it costs
+//! one swap no matter how large the registry is.
+//!
+//! Both the registry and the graph only grow, so a generation is fully
+//! described by the delta that produced it. The ring keeps every
+//! retained generation's delta, and a new generation is built by taking
+//! the buffer that just fell out of the ring and replaying the retained
+//! deltas onto it. Snapshot cost is therefore O(changes over the ring)
+//! rather than O(state). As in `RegistryWriter`, a buffer a reader
+//! still pins is not reused; the current state is cloned instead.
+
+use arc_swap::ArcSwap;
+use std::collections::VecDeque;
+use std::fmt;
+use std::sync::{Arc, Mutex};
+
+use crate::registry::{PackageEntry, PackageRegistry};
+use crate::resolver::{DependencyGraph, NodeId};
+use super::adjudicator::Verdict;
+
+/// State that can be brought forward by replaying deltas
+pub trait Generational: Clone {
+    /// Changes from one generation to the next
+    type Delta: fmt::Debug;
+
+    /// Apply one generation's changes, ideally O(delta)
+    fn apply(&mut self, delta: &Self::Delta);
+}
+
+impl Generational for PackageRegistry {
+    type Delta = Vec<PackageEntry>;
+
+    fn apply(&mut self, delta: &Self::Delta) {
+        for entry in delta {
+            self.publish(entry.clone());
+        }
+    }
+}
+
+/// Nodes and edges added to a `DependencyGraph` in one generation
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct GraphDelta {
+    /// Node ids, inserted in order
+    pub nodes: Vec<NodeId>,
+    /// `from -> to` edges, inserted after the nodes
+    pub edges: Vec<(NodeId, NodeId)>,
+}
+
+impl Generational for DependencyGraph {
+    type Delta = GraphDelta;
+
+    fn apply(&mut self, delta: &Self::Delta) {
+        for id in &delta.nodes {
+            self.add_symbol(id);
+        }
+        for (from, to) in &delta.edges {
+            self.add_edge(from, to);
+        }
+    }
+}
+
+impl<A: Generational, B: Generational> Generational for (A, B) {
+    type Delta = (A::Delta, B::Delta);
+
+    fn apply(&mut self, delta: &Self::Delta) {
+        self.0.apply(&delta.0);
+        self.1.apply(&delta.1);
+    }
+}
+
+/// Registry plus resolver graph, recovered together
+pub type RecoveryState = (PackageRegistry, DependencyGraph);
+
+/// One immutable generation of state
+#[derive(Debug)]
+pub struct Generation<T> {
+    generation: u64,
+    state: T,
+}
+
+impl<T> Generation<T> {
+    /// Generation number; numbers are never reused, even after a rollback
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// The state as of this generation
+    pub fn state(&self) -> &T {
+        &self.state
+    }
+}
+
+/// A generation held by the ring, with the delta that produced it
+#[derive(Debug)]
+struct Retained<T: Generational> {
+    snapshot: Arc<Generation<T>>,
+    delta: T::Delta,
+    confirmed: bool,
+}
+
+#[derive(Debug)]
+struct History<T: Generational> {
+    /// Oldest first; the last entry is the current generation
+    ring: VecDeque<Retained<T>>,
+    /// Generation just before `ring[0]`, recycled by the next commit
+    spare: Option<Arc<Generation<T>>>,
+    next: u64,
+}
+
+/// Ring of recent generations with atomic publication and rollback
+///
+/// Any number of threads may read; `commit`, `confirm` and `rollback`
+/// serialize on an internal lock that readers never touch.
+#[derive(Debug)]
+pub struct Recovery<T: Generational> {
+    current: ArcSwap<Generation<T>>,
+    history: Mutex<History<T>>,
+    depth: usize,
+}
+
+impl<T: Generational> Recovery<T> {
+    /// Ring of at most `depth` generations (at least 2), starting at a
+    /// confirmed generation 0 holding `initial`
+    pub fn new(initial: T, depth: usize, empty: T::Delta) -> Self {
+        let snapshot = Arc::new(Generation { generation: 0, state: initial });
+        let mut ring = VecDeque::new();
+        ring.push_back(Retained { snapshot: Arc::clone(&snapshot), delta: empty, confirmed: true });
+        Self {
+            current: ArcSwap::new(snapshot),
+            history: Mutex::new(History { ring, spare: None, next: 1 }),
+            depth: depth.max(2),
+        }
+    }
+
+    /// The current generation, kept alive for as long as the caller holds it
+    pub fn current(&self) -> Arc<Generation<T>> {
+        self.current.load_full()
+    }
+
+    /// Run `f` against the current state
+    pub fn read<R>(&self, f: impl FnOnce(&T) -> R) -> R {
+        f(&self.current.load().state)
+    }
+
+    /// Publish a new generation: the current state plus `delta`
+    ///
+    /// Returns the new generation number. O(sum of the retained deltas)
+    /// when the recycled buffer is free, O(state) when a reader pins it.
+    pub fn commit(&self, delta: T::Delta) -> u64 {
+        let mut history = self.history.lock().unwrap();
+        let mut state = match history.spare.take().map(Arc::try_unwrap) {
+            Some(Ok(recycled)) => {
+                let mut state = recycled.state;
+                for retained in &history.ring {
+                    state.apply(&retained.delta);
+                }
+                state
+            }
+            _ => history.ring.back().expect("ring is never empty").snapshot.state.clone(),
+        };
+        state.apply(&delta);
+
+        let generation = history.next;
+        history.next += 1;
+        let snapshot = Arc::new(Generation { generation, state });
+        history.ring.push_back(Retained { snapshot: Arc::clone(&snapshot), delta, confirmed: false });
+        if history.ring.len() > self.depth {
+            history.spare = history.ring.pop_front().map(|evicted| evicted.snapshot);
+        }
+        self.current.store(snapshot);
+        generation
+    }
+
+    /// Mark the current generation as good, a valid rollback target
+    pub fn confirm(&self) -> u64 {
+        let mut history = self.history.lock().unwrap();
+        let current = history.ring.back_mut().expect("ring is never empty");
+        current.confirmed = true;
+        current.snapshot.generation
+    }
+
+    /// Return to the newest confirmed generation before the current one
+    ///
+    /// Newer generations are discarded and the next commit builds on the
+    /// restored one. Publication is a single atomic store. Returns the
+    /// restored generation, or `None` if the ring holds no older
+    /// confirmed generation.
+    pub fn rollback(&self) -> Option<u64> {
+        let mut history = self.history.lock().unwrap();
+        let last = history.ring.len() - 1;
+        let target = history.ring.iter().take(last).rposition(|retained| retained.confirmed)?;
+        history.ring.truncate(target + 1);
+        let restored = Arc::clone(&history.ring[target].snapshot);
+        self.current.store(Arc::clone(&restored));
+        Some(restored.generation)
+    }
+
+    /// Roll back if the adjudicator's verdict calls for it
+    pub fn adjudicate(&self, verdict: &Verdict) -> Option<u64> {
+        if verdict.rollback {
+            self.rollback()
+        } else {
+            None
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::GraphView;
+
+    fn entry(version: &str) -> PackageEntry {
+        PackageEntry {
+            name: "core".to_string(),
+            version: version.to_string(),
+            tarball_hash: Vec::new(),
+            signature: Vec::new(),
+        }
+    }
+
+    fn delta(minor: u32) -> (Vec<PackageEntry>, GraphDelta) {
+        let id = format!("core@1.{}.0", minor);
+        let previous = format!("core@1.{}.0", minor.saturating_sub(1));
+        (vec![entry(&format!("1.{}.0", minor))], GraphDelta { nodes: vec![id.clone()], edges: vec![(previous, id)] })
+    }
+
+    #[test]
+    fn test_rollback_restores_last_confirmed_generation() {
+        let recovery: Recovery<RecoveryState> = Recovery::new(RecoveryState::default(), 4, Default::default());
+        for minor in 0..10 {
+            recovery.commit(delta(minor));
+            if minor % 3 == 0 {
+                recovery.confirm();
+            }
+        }
+        // Generations 1..=10 hold minors 0..=9; generation 10 (minor 9) is confirmed
+        assert_eq!(recovery.read(|(registry, _)| registry.len()), 10);
+
+        recovery.commit(delta(10));
+        assert_eq!(recovery.rollback(), Some(10));
+        assert_eq!(recovery.rollback(), None, "generation 7 left the ring");
+        let current = recovery.current();
+        assert_eq!(current.generation(), 10);
+        let (registry, graph) = current.state();
+        assert_eq!(registry.len(), 10);
+        assert_eq!(GraphView::node_count(graph), 10);
+
+        // Commits after a rollback build on the restored generation
+        assert_eq!(recovery.commit(delta(10)), 12);
+        let latest = recovery.read(|(registry, _)| registry.max_satisfying("core", "^1").map(|e| e.version.clone()));
+        assert_eq!(latest.as_deref(), Some("1.10.0"));
+    }
+
+    #[test]
+    fn test_recycled_and_cloned_generations_agree() {
+        let recycled: Recovery<PackageRegistry> = Recovery::new(PackageRegistry::new(), 3, Vec::new());
+        let cloned: Recovery<PackageRegistry> = Recovery::new(PackageRegistry::new(), 3, Vec::new());
+        let mut pinned = Vec::new();
+        for minor in 0..20 {
+            recycled.commit(vec![entry(&format!("1.{}.0", minor)), entry("0.1.0")]);
+            cloned.commit(vec![entry(&format!("1.{}.0", minor)), entry("0.1.0")]);
+            pinned.push(cloned.current());
+        }
+        let versions = |r: &PackageRegistry| r.versions("core").map(|e| e.version.clone()).collect::<Vec<_>>();
+        assert_eq!(recycled.read(versions), cloned.read(versions));
+        assert_eq!(recycled.read(|r| r.len()), 21);
+        assert_eq!(pinned[4].state().len(), 6);
+    }
+}
@@ -0,0 +1,328 @@
+//! AuraSeal package signatures
+//!
+//! An AuraSeal is an Ed25519 signature by the registry key over an
+//! entry's tarball hash. Seals must verify before a package is
+//! hot-swapped in. Lockfile installs check hundreds at a time, so
+//! `verify_batch` splits the work across cores, runs Ed25519 batch
+//! verification on each chunk, and remembers recently verified seals
+//! so later installs skip the signature math.
+//!
+//! Every seal is judged by the same rule, the cofactored Ed25519
+//! equation that batch verification checks, whether it is verified
+//! alone, in a batch, or re-checked after its batch failed. A seal's
+//! verdict therefore never depends on which batch it landed in. Weak
+//! (small-order) registry keys are rejected outright, as
+//! `verify_strict` would.
+
+use std::collections::HashSet;
+use std::fmt;
+use std::mem;
+use std::sync::RwLock;
+use std::thread;
+
+use ed25519_dalek::{Signature, Signer, SigningKey, VerifyingKey};
+use sha2::{Digest, Sha256};
+
+use super::PackageEntryRef;
+
+/// Smallest chunk worth a thread of its own
+const MIN_CHUNK: usize = 32;
+
+/// Verified seals remembered per cache generation by default
+pub const DEFAULT_CACHE: usize = 1 << 16;
+
+/// Why a seal was rejected
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SealError {
+    /// The signature is not a 64-byte Ed25519 signature
+    Malformed,
+    /// The signature does not match the tarball hash under the registry key
+    Invalid,
+}
+
+impl fmt::Display for SealError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Malformed => write!(f, "malformed AuraSeal signature"),
+            Self::Invalid => write!(f, "AuraSeal signature does not verify"),
+        }
+    }
+}
+
+impl std::error::Error for SealError {}
+
+/// Seal a tarball hash with the registry signing key
+pub fn seal(key: &SigningKey, tarball_hash: &[u8]) -> Vec<u8> {
+    key.sign(tarball_hash).to_bytes().to_vec()
+}
+
+/// Verifier for one registry key, with a cache of seals already verified
+///
+/// Cache entries are SHA-256 digests of (key, tarball hash, signature),
+/// so a hit gives the same answer the signature check would. The cache
+/// keeps two generations of at most `capacity` digests each: when the
+/// current one fills up it becomes the previous one and the oldest is
+/// dropped, and a hit in the previous generation moves the digest
+/// forward. Memory stays bounded and recently used seals survive.
+#[derive(Debug)]
+pub struct AuraSeal {
+    key: VerifyingKey,
+    weak: bool,
+    verified: RwLock<SealCache>,
+}
+
+impl AuraSeal {
+    /// Verifier trusting `key`, caching up to `DEFAULT_CACHE` seals per generation
+    pub fn new(key: VerifyingKey) -> Self {
+        Self::with_capacity(key, DEFAULT_CACHE)
+    }
+
+    /// Verifier trusting `key`, caching up to `capacity` seals per generation
+    pub fn with_capacity(key: VerifyingKey, capacity: usize) -> Self {
+        Self {
+            weak: key.is_weak(),
+            key,
+            verified: RwLock::new(SealCache::new(capacity.max(1))),
+        }
+    }
+
+    /// Number of seals remembered as verified, at most twice the capacity
+    pub fn cached(&self) -> usize {
+        self.verified.read().unwrap().len()
+    }
+
+    /// Forget every verified seal, e.g. after a registry sync replaced the entries
+    pub fn clear_cache(&self) {
+        self.verified.write().unwrap().clear();
+    }
+
+    /// Verify one entry's seal
+    pub fn verify(&self, entry: PackageEntryRef<'_>) -> Result<(), SealError> {
+        self.verify_batch(&[entry]).pop().unwrap()
+    }
+
+    /// Verify every entry's seal, with results in input order
+    ///
+    /// Cached seals cost one hash. The rest are split into at most one
+    /// chunk per core, and each chunk is batch-verified. Only a chunk
+    /// that fails the batch check falls back to per-signature checks to
+    /// find the bad seals, so an all-valid install does a single batch
+    /// verification per core.
+    pub fn verify_batch(&self, entries: &[PackageEntryRef<'_>]) -> Vec<Result<(), SealError>> {
+        let mut results = vec![Ok(()); entries.len()];
+        let mut pending = Vec::new();
+        let mut aging = Vec::new();
+        {
+            let verified = self.verified.read().unwrap();
+            for (i, entry) in entries.iter().enumerate() {
+                match Signature::from_slice(entry.signature) {
+                    Ok(_) if self.weak => results[i] = Err(SealError::Invalid),
+                    Ok(signature) => {
+                        let digest = self.digest(entry);
+                        if verified.current.contains(&digest) {
+                            continue;
+                        }
+                        if verified.previous.contains(&digest) {
+                            aging.push(digest);
+                        } else {
+                            pending.push(Pending { slot: i, digest, signature });
+                        }
+                    }
+                    Err(_) => results[i] = Err(SealError::Malformed),
+                }
+            }
+        }
+        if pending.is_empty() {
+            if !aging.is_empty() {
+                let mut verified = self.verified.write().unwrap();
+                aging.into_iter().for_each(|digest| verified.insert(digest));
+            }
+            return results;
+        }
+
+        let threads = thread::available_parallelism()
+            .map_or(1, |n| n.get())
+            .min(pending.len().div_ceil(MIN_CHUNK));
+        let chunk = pending.len().div_ceil(threads);
+        let rejected: Vec<usize> = if threads == 1 {
+            self.check(entries, &pending)
+        } else {
+            thread::scope(|scope| {
+                let workers: Vec<_> = pending
+                    .chunks(chunk)
+                    .map(|part| scope.spawn(|| self.check(entries, part)))
+                    .collect();
+                workers.into_iter().flat_map(|worker| worker.join().unwrap()).collect()
+            })
+        };
+        for &slot in &rejected {
+            results[slot] = Err(SealError::Invalid);
+        }
+
+        let mut verified = self.verified.write().unwrap();
+        aging.into_iter().for_each(|digest| verified.insert(digest));
+        for item in &pending {
+            if results[item.slot].is_ok() {
+                verified.insert(item.digest);
+            }
+        }
+        results
+    }
+
+    /// Input slots in `part` whose seal does not verify
+    fn check(&self, entries: &[PackageEntryRef<'_>], part: &[Pending]) -> Vec<usize> {
+        let messages: Vec<&[u8]> = part.iter().map(|item| entries[item.slot].tarball_hash).collect();
+        let signatures: Vec<Signature> = part.iter().map(|item| item.signature).collect();
+        let keys = vec![self.key; part.len()];
+        if ed25519_dalek::verify_batch(&messages, &signatures, &keys).is_ok() {
+            return Vec::new();
+        }
+        // A batch of one, so the fallback applies the same cofactored rule
+        part.iter()
+            .zip(&messages)
+            .filter(|(item, message)| ed25519_dalek::verify_batch(&[message], &[item.signature], &[self.key]).is_err())
+            .map(|(item, _)| item.slot)
+            .collect()
+    }
+
+    fn digest(&self, entry: &PackageEntryRef<'_>) -> [u8; 32] {
+        let mut hasher = Sha256::new();
+        hasher.update(self.key.as_bytes());
+        hasher.update((entry.tarball_hash.len() as u64).to_le_bytes());
+        hasher.update(entry.tarball_hash);
+        hasher.update(entry.signature);
+        hasher.finalize().into()
+    }
+}
+
+/// Two generations of verified-seal digests
+#[derive(Debug)]
+struct SealCache {
+    current: HashSet<[u8; 32]>,
+    previous: HashSet<[u8; 32]>,
+    capacity: usize,
+}
+
+impl SealCache {
+    fn new(capacity: usize) -> Self {
+        Self { current: HashSet::new(), previous: HashSet::new(), capacity }
+    }
+
+    fn len(&self) -> usize {
+        self.current.len() + self.previous.len()
+    }
+
+    /// Remember `digest` in the current generation, aging it out of the previous one
+    fn insert(&mut self, digest: [u8; 32]) {
+        self.previous.remove(&digest);
+        if self.current.len() >= self.capacity {
+            self.previous = mem::take(&mut self.current);
+        }
+        self.current.insert(digest);
+    }
+
+    fn clear(&mut self) {
+        self.current.clear();
+        self.previous.clear();
+    }
+}
+
+/// A seal still to be checked, and where its result goes
+struct Pending {
+    slot: usize,
+    digest: [u8; 32],
+    signature: Signature,
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::registry::PackageEntry;
+
+    fn entries(key: &SigningKey, n: usize) -> Vec<PackageEntry> {
+        (0..n)
+            .map(|i| {
+                let tarball_hash = Sha256::digest(i.to_le_bytes()).to_vec();
+                PackageEntry {
+                    name: format!("pkg{}", i),
+                    version: "1.0.0".to_string(),
+                    signature: seal(key, &tarball_hash),
+                    tarball_hash,
+                }
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_batch_flags_exactly_the_bad_seals() {
+        let key = SigningKey::from_bytes(&[7; 32]);
+        let verifier = AuraSeal::new(key.verifying_key());
+        let mut owned = entries(&key, 200);
+        owned[3].signature[0] ^= 1;
+        owned[150].tarball_hash[0] ^= 1;
+        owned[199].signature.truncate(10);
+
+        let views: Vec<_> = owned.iter().map(PackageEntry::view).collect();
+        let results = verifier.verify_batch(&views);
+        for (i, result) in results.iter().enumerate() {
+            let expected = match i {
+                3 | 150 => Err(SealError::Invalid),
+                199 => Err(SealError::Malformed),
+                _ => Ok(()),
+            };
+            assert_eq!(*result, expected, "entry {}", i);
+        }
+        assert_eq!(verifier.cached(), 197);
+    }
+
+    #[test]
+    fn test_cache_skips_only_identical_seals() {
+        let key = SigningKey::from_bytes(&[7; 32]);
+        let verifier = AuraSeal::new(key.verifying_key());
+        let owned = entries(&key, 4);
+        let views: Vec<_> = owned.iter().map(PackageEntry::view).collect();
+        assert!(verifier.verify_batch(&views).iter().all(Result::is_ok));
+        assert_eq!(verifier.cached(), 4);
+
+        // A cached tarball hash with a foreign signature still gets checked
+        let other = SigningKey::from_bytes(&[8; 32]);
+        let mut forged = owned[0].clone();
+        forged.signature = seal(&other, &forged.tarball_hash);
+        assert_eq!(verifier.verify(forged.view()), Err(SealError::Invalid));
+        assert_eq!(verifier.verify(views[0]), Ok(()));
+        assert_eq!(verifier.cached(), 4);
+    }
+
+    #[test]
+    fn test_cache_is_bounded_and_keeps_recent_seals() {
+        let key = SigningKey::from_bytes(&[7; 32]);
+        let verifier = AuraSeal::with_capacity(key.verifying_key(), 8);
+        let owned = entries(&key, 40);
+        let views: Vec<_> = owned.iter().map(PackageEntry::view).collect();
+
+        assert!(verifier.verify_batch(&views).iter().all(Result::is_ok));
+        assert!(verifier.cached() <= 16, "{} cached", verifier.cached());
+        for view in &views[32..] {
+            assert_eq!(verifier.verify(*view), Ok(()));
+        }
+        assert!(verifier.verify_batch(&views).iter().all(Result::is_ok));
+        assert!(verifier.cached() <= 16);
+
+        verifier.clear_cache();
+        assert_eq!(verifier.cached(), 0);
+        assert_eq!(verifier.verify(views[0]), Ok(()));
+        assert_eq!(verifier.cached(), 1);
+    }
+
+    #[test]
+    fn test_weak_key_rejects_everything() {
+        // The identity point: small order, so it "verifies" almost anything
+        let mut identity = [0u8; 32];
+        identity[0] = 1;
+        let verifier = AuraSeal::new(VerifyingKey::from_bytes(&identity).unwrap());
+        let owned = entries(&SigningKey::from_bytes(&[7; 32]), 2);
+        let views: Vec<_> = owned.iter().map(PackageEntry::view).collect();
+        assert_eq!(verifier.verify_batch(&views), vec![Err(SealError::Invalid); 2]);
+        assert_eq!(verifier.cached(), 0);
+    }
+}
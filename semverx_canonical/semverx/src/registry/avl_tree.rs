@@ -0,0 +1,542 @@
+//! Arena-backed AVL index over (package name, version, channel)
+//!
+//! Nodes live in one contiguous `Vec` linked by `u32` indices. A range
+//! query is one descent to the lower bound followed by an in-order scan,
+//! so `^1.2(stable)` costs O(log n + k) for k versions in range.
+
+use std::cmp::Ordering;
+use std::ops::Bound;
+
+use crate::nlm::ast::{RangeAst, RangeOp};
+use crate::nlm::parser::{parse_range, ParseError};
+use crate::resolver::Symbol;
+use crate::{Channel, PackedVersion, SemVerX};
+
+/// Sentinel child link
+const NIL: u32 = u32::MAX;
+
+/// Index key ordered by interned name, then version tuple, then channel
+///
+/// All versions of one package are contiguous in key order, ascending
+/// by (major, minor, patch) and by channel within a tuple.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+pub struct IndexKey {
+    /// Interned package name
+    pub name: Symbol,
+    /// Major version
+    pub major: u32,
+    /// Minor version
+    pub minor: u32,
+    /// Patch version
+    pub patch: u32,
+    /// Release channel
+    pub channel: Channel,
+}
+
+impl IndexKey {
+    /// Key for `version` of package `name`
+    pub fn new(name: Symbol, version: &SemVerX) -> Self {
+        Self {
+            name,
+            major: version.major,
+            minor: version.minor,
+            patch: version.patch,
+            channel: version.channel,
+        }
+    }
+
+    /// Version tuple carried by the key
+    pub fn version(&self) -> SemVerX {
+        SemVerX {
+            major: self.major,
+            minor: self.minor,
+            patch: self.patch,
+            channel: self.channel,
+        }
+    }
+
+    fn at(name: Symbol, (major, minor, patch): (u32, u32, u32), channel: Channel) -> Self {
+        Self { name, major, minor, patch, channel }
+    }
+}
+
+/// Version requirement: `[lower, upper)` over the tuple, optionally pinned to a channel
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct VersionReq {
+    pub(super) lower: (u32, u32, u32),
+    pub(super) upper: Option<(u32, u32, u32)>,
+    pub(super) channel: Option<Channel>,
+}
+
+impl VersionReq {
+    /// Parse `^1.2`, `~1.2.3`, `=1.2.3`, `1.2`, `>=1.0` or `*`
+    ///
+    /// Any form takes an optional `(channel)` suffix, e.g. `^1.2(stable)`.
+    /// Caret and tilde follow Cargo semantics; a bare version is exact
+    /// in the components it names (`1.2` matches `1.2.x`).
+    ///
+    /// Runs the allocation-free NLM parser and falls back to
+    /// `parse_gated` only for input it flags as ambiguous.
+    pub fn parse(input: &str) -> Option<Self> {
+        match parse_range(input.as_bytes()) {
+            Ok(ast) => Some(Self::from_ast(&ast)),
+            Err(ParseError::Gated(_)) => Self::parse_gated(input),
+            Err(_) => None,
+        }
+    }
+
+    /// Observer-gated lenient path (signed or zero-padded components, non-ASCII)
+    pub(crate) fn parse_gated(input: &str) -> Option<Self> {
+        let input = input.trim();
+        let (body, channel) = match input.find('(') {
+            Some(open) => {
+                let name = input[open + 1..].strip_suffix(')')?;
+                (&input[..open], Some(Channel::from_name(name)?))
+            }
+            None => (input, None),
+        };
+
+        if body == "*" {
+            return Some(Self::from_ast(&RangeAst { op: RangeOp::Any, parts: [0; 3], given: 0, channel }));
+        }
+
+        let (op, numbers) = match body.as_bytes().first()? {
+            b'^' => (RangeOp::Caret, &body[1..]),
+            b'~' => (RangeOp::Tilde, &body[1..]),
+            b'=' => (RangeOp::Exact, &body[1..]),
+            b'>' => (body.get(..2).filter(|op| *op == ">=").map(|_| RangeOp::AtLeast)?, &body[2..]),
+            _ => (RangeOp::Exact, body),
+        };
+
+        let mut parts = [0u32; 3];
+        let mut given = 0;
+        for part in numbers.split('.') {
+            if given == 3 {
+                return None;
+            }
+            parts[given] = part.parse().ok()?;
+            given += 1;
+        }
+        Some(Self::from_ast(&RangeAst { op, parts, given: given as u8, channel }))
+    }
+
+    /// Requirement for a parsed range expression
+    pub fn from_ast(ast: &RangeAst) -> Self {
+        let [major, minor, patch] = ast.parts;
+        let lower = (major, minor, patch);
+
+        // Smallest version past every version sharing lower's first
+        // `keep` components; overflow carries left, only a major past
+        // u32::MAX leaves the range unbounded
+        let next = |keep: usize| match keep {
+            1 => major.checked_add(1).map(|m| (m, 0, 0)),
+            2 => minor.checked_add(1).map(|m| (major, m, 0)).or_else(|| major.checked_add(1).map(|m| (m, 0, 0))),
+            _ => patch
+                .checked_add(1)
+                .map(|p| (major, minor, p))
+                .or_else(|| minor.checked_add(1).map(|m| (major, m, 0)))
+                .or_else(|| major.checked_add(1).map(|m| (m, 0, 0))),
+        };
+        let upper = match (ast.op, ast.given) {
+            (RangeOp::AtLeast, _) | (RangeOp::Any, _) => None,
+            (RangeOp::Caret, _) if major > 0 => next(1),
+            (RangeOp::Caret, 1) => Some((1, 0, 0)),
+            (RangeOp::Caret, given) if minor > 0 || given == 2 => next(2),
+            (RangeOp::Caret, _) => next(3),
+            (RangeOp::Tilde, 1) | (RangeOp::Exact, 1) => next(1),
+            (RangeOp::Tilde, _) | (RangeOp::Exact, 2) => next(2),
+            (_, _) => next(3),
+        };
+
+        Self { lower, upper, channel: ast.channel }
+    }
+
+    /// True if `version` satisfies the requirement
+    pub fn matches(&self, version: &SemVerX) -> bool {
+        let tuple = (version.major, version.minor, version.patch);
+        tuple >= self.lower
+            && self.upper.is_none_or(|upper| tuple < upper)
+            && self.channel.is_none_or(|channel| version.channel == channel)
+    }
+
+    /// Packed-key bounds `[lo, hi)` plus a bit mask of accepted channel codes
+    fn packed_bounds(&self) -> (u128, u128, u32) {
+        let key = |(major, minor, patch)| PackedVersion::new(major, minor, patch, Channel::Legacy).key();
+        let hi = self.upper.map_or(u128::MAX, key);
+        let channels = self.channel.map_or(0b1111, |channel| 1 << channel as u32);
+        (key(self.lower), hi, channels)
+    }
+}
+
+/// Candidates per match mask
+pub const LANES: usize = 64;
+
+/// Positions of the candidates satisfying `req`, ascending
+///
+/// The inner loop over each block of 64 keys is branch-free: two
+/// integer compares and a channel-mask test per key, OR-ed into a
+/// 64-bit match mask that is then walked bit by bit. Candidates need
+/// not be sorted. O(n) with no allocation beyond the result.
+pub fn filter_satisfying(candidates: &[PackedVersion], req: &VersionReq) -> Vec<usize> {
+    let bounds = req.packed_bounds();
+    let mut hits = Vec::new();
+    for (block, keys) in candidates.chunks(LANES).enumerate() {
+        let mut mask = block_mask(keys, bounds);
+        while mask != 0 {
+            hits.push(block * LANES + mask.trailing_zeros() as usize);
+            mask &= mask - 1;
+        }
+    }
+    hits
+}
+
+impl VersionReq {
+    /// Match mask of up to `LANES` keys: bit i is set if `keys[i]` satisfies the requirement
+    pub fn match_mask(&self, keys: &[PackedVersion]) -> u64 {
+        block_mask(keys, self.packed_bounds())
+    }
+}
+
+fn block_mask(keys: &[PackedVersion], (lo, hi, channels): (u128, u128, u32)) -> u64 {
+    debug_assert!(keys.len() <= LANES);
+    let mut mask = 0u64;
+    for (lane, version) in keys.iter().enumerate() {
+        let key = version.key();
+        let hit = (key >= lo) & (key < hi) & (channels >> (key as u32 & 3) & 1 == 1);
+        mask |= (hit as u64) << lane;
+    }
+    mask
+}
+
+#[derive(Debug, Clone)]
+struct AvlNode<V> {
+    key: IndexKey,
+    value: V,
+    left: u32,
+    right: u32,
+    height: u8,
+}
+
+/// Ordered map from `IndexKey` to `V`, stored in a contiguous arena
+///
+/// Published versions are immutable, so the index only grows: there is
+/// no removal and node indices stay stable. Heights are kept balanced
+/// by the usual AVL rotations, bounding a descent at 1.44 log2 n links.
+#[derive(Debug, Clone)]
+pub struct AvlIndex<V> {
+    nodes: Vec<AvlNode<V>>,
+    root: u32,
+}
+
+impl<V> Default for AvlIndex<V> {
+    fn default() -> Self {
+        Self { nodes: Vec::new(), root: NIL }
+    }
+}
+
+impl<V> AvlIndex<V> {
+    /// Empty index
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Number of keys
+    pub fn len(&self) -> usize {
+        self.nodes.len()
+    }
+
+    /// True if no key has been inserted
+    pub fn is_empty(&self) -> bool {
+        self.nodes.is_empty()
+    }
+
+    /// Exact lookup, O(log n)
+    pub fn get(&self, key: &IndexKey) -> Option<&V> {
+        let mut at = self.root;
+        while at != NIL {
+            let node = &self.nodes[at as usize];
+            at = match key.cmp(&node.key) {
+                Ordering::Less => node.left,
+                Ordering::Greater => node.right,
+                Ordering::Equal => return Some(&node.value),
+            };
+        }
+        None
+    }
+
+    /// Insert or replace, returning the previous value, O(log n)
+    pub fn insert(&mut self, key: IndexKey, value: V) -> Option<V> {
+        let (root, previous) = self.insert_at(self.root, key, value);
+        self.root = root;
+        previous
+    }
+
+    /// Keys in `[lo, hi]` / `[lo, hi)` in ascending order
+    pub fn range(&self, lo: IndexKey, hi: Bound<IndexKey>) -> Range<'_, V> {
+        let mut stack = Vec::new();
+        let mut at = self.root;
+        while at != NIL {
+            let node = &self.nodes[at as usize];
+            if node.key >= lo {
+                stack.push(at);
+                at = node.left;
+            } else {
+                at = node.right;
+            }
+        }
+        Range { index: self, stack, hi }
+    }
+
+    /// Every version of package `name`, ascending
+    pub fn versions(&self, name: Symbol) -> Range<'_, V> {
+        let lo = IndexKey::at(name, (0, 0, 0), Channel::Legacy);
+        let hi = IndexKey::at(name, (u32::MAX, u32::MAX, u32::MAX), Channel::LTS);
+        self.range(lo, Bound::Included(hi))
+    }
+
+    /// Versions of `name` satisfying `req`, ascending
+    pub fn satisfying(&self, name: Symbol, req: &VersionReq) -> impl Iterator<Item = (&IndexKey, &V)> {
+        let lo = IndexKey::at(name, req.lower, Channel::Legacy);
+        let hi = match req.upper {
+            Some(upper) => Bound::Excluded(IndexKey::at(name, upper, Channel::Legacy)),
+            None => Bound::Included(IndexKey::at(name, (u32::MAX, u32::MAX, u32::MAX), Channel::LTS)),
+        };
+        let pinned = req.channel;
+        self.range(lo, hi)
+            .filter(move |(key, _)| pinned.is_none_or(|channel| key.channel == channel))
+    }
+
+    /// Highest version of `name` satisfying `req`
+    pub fn max_satisfying(&self, name: Symbol, req: &VersionReq) -> Option<(&IndexKey, &V)> {
+        self.satisfying(name, req).last()
+    }
+
+    fn height(&self, at: u32) -> u8 {
+        if at == NIL {
+            0
+        } else {
+            self.nodes[at as usize].height
+        }
+    }
+
+    fn update(&mut self, at: u32) {
+        let node = &self.nodes[at as usize];
+        let height = 1 + self.height(node.left).max(self.height(node.right));
+        self.nodes[at as usize].height = height;
+    }
+
+    fn insert_at(&mut self, at: u32, key: IndexKey, value: V) -> (u32, Option<V>) {
+        if at == NIL {
+            self.nodes.push(AvlNode { key, value, left: NIL, right: NIL, height: 1 });
+            return ((self.nodes.len() - 1) as u32, None);
+        }
+
+        let slot = at as usize;
+        match key.cmp(&self.nodes[slot].key) {
+            Ordering::Equal => {
+                let previous = std::mem::replace(&mut self.nodes[slot].value, value);
+                (at, Some(previous))
+            }
+            Ordering::Less => {
+                let (child, previous) = self.insert_at(self.nodes[slot].left, key, value);
+                self.nodes[slot].left = child;
+                (self.rebalance(at), previous)
+            }
+            Ordering::Greater => {
+                let (child, previous) = self.insert_at(self.nodes[slot].right, key, value);
+                self.nodes[slot].right = child;
+                (self.rebalance(at), previous)
+            }
+        }
+    }
+
+    fn rebalance(&mut self, at: u32) -> u32 {
+        self.update(at);
+        let (left, right) = (self.nodes[at as usize].left, self.nodes[at as usize].right);
+        let balance = self.height(left) as i32 - self.height(right) as i32;
+
+        if balance > 1 {
+            let inner = self.nodes[left as usize].right;
+            if self.height(self.nodes[left as usize].left) < self.height(inner) {
+                self.nodes[at as usize].left = self.rotate_left(left);
+            }
+            return self.rotate_right(at);
+        }
+        if balance < -1 {
+            let inner = self.nodes[right as usize].left;
+            if self.height(self.nodes[right as usize].right) < self.height(inner) {
+                self.nodes[at as usize].right = self.rotate_right(right);
+            }
+            return self.rotate_left(at);
+        }
+        at
+    }
+
+    fn rotate_left(&mut self, at: u32) -> u32 {
+        let pivot = self.nodes[at as usize].right;
+        self.nodes[at as usize].right = self.nodes[pivot as usize].left;
+        self.nodes[pivot as usize].left = at;
+        self.update(at);
+        self.update(pivot);
+        pivot
+    }
+
+    fn rotate_right(&mut self, at: u32) -> u32 {
+        let pivot = self.nodes[at as usize].left;
+        self.nodes[at as usize].left = self.nodes[pivot as usize].right;
+        self.nodes[pivot as usize].right = at;
+        self.update(at);
+        self.update(pivot);
+        pivot
+    }
+}
+
+/// In-order iterator over a key range; holds at most one root-to-leaf path
+#[derive(Debug, Clone)]
+pub struct Range<'a, V> {
+    index: &'a AvlIndex<V>,
+    stack: Vec<u32>,
+    hi: Bound<IndexKey>,
+}
+
+impl<'a, V> Iterator for Range<'a, V> {
+    type Item = (&'a IndexKey, &'a V);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let nodes = &self.index.nodes;
+        let at = self.stack.pop()?;
+        let node = &nodes[at as usize];
+
+        let in_range = match &self.hi {
+            Bound::Included(hi) => node.key <= *hi,
+            Bound::Excluded(hi) => node.key < *hi,
+            Bound::Unbounded => true,
+        };
+        if !in_range {
+            self.stack.clear();
+            return None;
+        }
+
+        // Successors: leftmost path of the right subtree
+        let mut next = node.right;
+        while next != NIL {
+            self.stack.push(next);
+            next = nodes[next as usize].left;
+        }
+
+        Some((&node.key, &node.value))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::Interner;
+
+    fn key(name: Symbol, version: &str) -> IndexKey {
+        IndexKey::new(name, &SemVerX::parse(version).unwrap())
+    }
+
+    #[test]
+    fn test_insert_keeps_order_and_balance() {
+        let mut names = Interner::new();
+        let pkg = names.intern("pkg");
+        let mut index = AvlIndex::new();
+
+        // Ascending inserts are the worst case for an unbalanced tree
+        for i in 0..1024u32 {
+            index.insert(key(pkg, &format!("{}.{}.{}", i / 100, (i / 10) % 10, i % 10)), i);
+        }
+        assert_eq!(index.len(), 1024);
+        assert!(index.height(index.root) <= 11, "height {}", index.height(index.root));
+
+        let values: Vec<u32> = index.versions(pkg).map(|(_, &v)| v).collect();
+        assert_eq!(values, (0..1024).collect::<Vec<_>>());
+
+        assert_eq!(index.insert(key(pkg, "1.2.3"), 9999), Some(123));
+        assert_eq!(index.get(&key(pkg, "1.2.3")), Some(&9999));
+        assert_eq!(index.get(&key(pkg, "1.2.3(lts)")), None);
+    }
+
+    #[test]
+    fn test_range_queries_per_package_and_channel() {
+        let mut names = Interner::new();
+        let (core, cli) = (names.intern("core"), names.intern("cli"));
+        let mut index = AvlIndex::new();
+        let published = [
+            "1.1.9", "1.2.0", "1.2.5(experimental)", "1.9.0", "1.9.1(lts)", "2.0.0", "0.2.3", "0.2.9",
+        ];
+        for (i, version) in published.iter().enumerate() {
+            index.insert(key(core, version), i);
+            index.insert(key(cli, version), 100 + i);
+        }
+
+        let req = VersionReq::parse("^1.2(stable)").unwrap();
+        let hits: Vec<String> = index
+            .satisfying(core, &req)
+            .map(|(k, _)| format!("{}.{}.{}", k.major, k.minor, k.patch))
+            .collect();
+        assert_eq!(hits, vec!["1.2.0", "1.9.0"]);
+
+        let any = VersionReq::parse("^1.2").unwrap();
+        assert_eq!(index.max_satisfying(core, &any).map(|(_, &v)| v), Some(4));
+        assert_eq!(index.max_satisfying(cli, &any).map(|(_, &v)| v), Some(104));
+
+        let zero = VersionReq::parse("^0.2").unwrap();
+        assert_eq!(index.satisfying(core, &zero).count(), 2);
+        assert_eq!(index.satisfying(core, &VersionReq::parse("~1.9").unwrap()).count(), 2);
+        assert_eq!(index.satisfying(core, &VersionReq::parse("=2.0.0").unwrap()).count(), 1);
+        assert_eq!(index.satisfying(core, &VersionReq::parse(">=1.9.1").unwrap()).count(), 2);
+        assert_eq!(index.satisfying(core, &VersionReq::parse("*(lts)").unwrap()).count(), 1);
+        assert!(VersionReq::parse("^1.2.3.4").is_none());
+    }
+
+    #[test]
+    fn test_upper_bound_carries_at_u32_max() {
+        let max = u32::MAX;
+        let upper = |req: &str| VersionReq::parse(req).unwrap().upper;
+        assert_eq!(upper("~3.4294967295"), Some((4, 0, 0)));
+        assert_eq!(upper("=3.4294967295"), Some((4, 0, 0)));
+        assert_eq!(upper("=3.1.4294967295"), Some((3, 2, 0)));
+        assert_eq!(upper("=3.4294967295.4294967295"), Some((4, 0, 0)));
+        assert_eq!(upper("^0.4294967295"), Some((1, 0, 0)));
+        assert_eq!(upper("^0.0.4294967295"), Some((0, 1, 0)));
+        assert_eq!(upper("^4294967295"), None);
+        assert_eq!(upper("~4294967295.4294967295"), None);
+
+        let req = VersionReq::parse("~3.4294967295").unwrap();
+        let at = |major, minor, patch| SemVerX { major, minor, patch, channel: Channel::Stable };
+        assert!(req.matches(&at(3, max, max)));
+        assert!(!req.matches(&at(4, 0, 0)));
+        assert!(!req.matches(&at(max, 0, 0)));
+    }
+
+    #[test]
+    fn test_packed_filter_matches_scalar() {
+        let channels = [Channel::Legacy, Channel::Experimental, Channel::Stable, Channel::LTS];
+        let mut state = 0x2545_f491_4f6c_dd1du64;
+        let versions: Vec<SemVerX> = (0..1000)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                let pick = |shift: u32| match (state >> shift) % 6 {
+                    5 => u32::MAX,
+                    n => n as u32,
+                };
+                SemVerX { major: pick(0), minor: pick(8), patch: pick(16), channel: channels[(state >> 24) as usize % 4] }
+            })
+            .collect();
+        let packed: Vec<PackedVersion> = versions.iter().map(SemVerX::pack).collect();
+        for (a, b) in versions.iter().zip(&versions[1..]) {
+            assert_eq!(a.cmp(b), a.pack().cmp(&b.pack()));
+            assert_eq!(a.pack().unpack(), *a);
+        }
+
+        for req in ["^1.2", "^0.2(lts)", "~3.1.4", "=0", "2.4294967295", ">=4294967295", "*", "*(legacy)", "^4294967295.1"] {
+            let req = VersionReq::parse(req).unwrap();
+            let expected: Vec<usize> = (0..versions.len()).filter(|&i| req.matches(&versions[i])).collect();
+            assert_eq!(filter_satisfying(&packed, &req), expected, "{:?}", req);
+        }
+    }
+}
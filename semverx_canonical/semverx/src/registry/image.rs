@@ -0,0 +1,456 @@
+//! Memory-mapped on-disk registry image
+//!
+//! A replica cold-starts by mapping an image instead of deserializing
+//! every entry. Lookups binary-search fixed-size tables in place and
+//! return `PackageEntryRef` views borrowing the mapping, so one copy in
+//! the page cache serves every process on the host.
+//!
+//! Layout (format 1, little-endian, sections back to back):
+//!
+//! - header, 32 bytes: magic `SVXIMG\0\0`, format `u32`, name count
+//!   `u32`, record count `u32`, reserved `u32`, blob length `u64`
+//! - name table, 16 bytes per name, sorted by name bytes: blob offset
+//!   `u64`, length `u32`, first record `u32`
+//! - record table, 32 bytes per record, grouped by name and sorted by
+//!   (major, minor, patch, channel) within a group: major, minor, patch
+//!   `u32`, channel `u8`, 3 reserved, blob offset `u64`, then version,
+//!   tarball hash and signature lengths as `u16`, 2 reserved
+//! - blob region: each name followed by its records' version, tarball
+//!   hash and signature bytes; blob offsets are relative to its start
+
+use std::collections::BTreeSet;
+use std::fs::{self, File, OpenOptions};
+use std::io::{self, BufWriter, Write};
+use std::ops::{Deref, Range};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use memmap2::Mmap;
+
+use crate::audit::plpprofiler::{self, Probe};
+use crate::{Channel, SemVerX};
+use super::{PackageEntry, PackageEntryRef, PackageRegistry, VersionReq};
+
+/// Image format version written by `PackageRegistry::write_image`
+pub const FORMAT_VERSION: u32 = 1;
+
+const MAGIC: &[u8; 8] = b"SVXIMG\0\0";
+const HEADER_LEN: usize = 32;
+const NAME_LEN: usize = 16;
+const RECORD_LEN: usize = 32;
+
+/// Read-only registry over an image held in memory or mapped from disk
+///
+/// `open` validates the header, both tables and their sort order,
+/// O(names + records). Of the blob region it reads only the names;
+/// the other blob pages are faulted in only by the lookups that read
+/// them.
+#[derive(Debug)]
+pub struct RegistryImage<B = Mmap> {
+    bytes: B,
+    names: usize,
+    records: usize,
+    blob: usize,
+}
+
+impl RegistryImage<Mmap> {
+    /// Map the image at `path`
+    #[allow(unsafe_code)]
+    pub fn open(path: impl AsRef<Path>) -> io::Result<Self> {
+        let file = File::open(path)?;
+        // SAFETY: images are never modified in place; `save_image` replaces
+        // them by rename, so a live mapping cannot see the file change.
+        let map = unsafe { Mmap::map(&file)? };
+        Self::from_bytes(map)
+    }
+}
+
+impl<B: Deref<Target = [u8]>> RegistryImage<B> {
+    /// Validate an image already in memory
+    pub fn from_bytes(bytes: B) -> io::Result<Self> {
+        let data: &[u8] = &bytes;
+        if data.len() < HEADER_LEN || &data[..8] != MAGIC {
+            return Err(corrupt("not a registry image"));
+        }
+        let format = u32_at(data, 8);
+        if format != FORMAT_VERSION {
+            return Err(corrupt(&format!("unsupported image format {}", format)));
+        }
+
+        let names = u32_at(data, 12) as usize;
+        let records = u32_at(data, 16) as usize;
+        let blob = names
+            .checked_mul(NAME_LEN)
+            .and_then(|n| records.checked_mul(RECORD_LEN)?.checked_add(n))
+            .and_then(|tables| tables.checked_add(HEADER_LEN))
+            .ok_or_else(|| corrupt("table sizes overflow"))?;
+        let blob_len = u64_at(data, 24);
+        if (blob as u64).checked_add(blob_len) != Some(data.len() as u64) {
+            return Err(corrupt("image length does not match its header"));
+        }
+
+        let image = Self { bytes, names, records, blob };
+        if names == 0 && records != 0 {
+            return Err(corrupt("records without a name"));
+        }
+        for n in 0..names {
+            let at = HEADER_LEN + n * NAME_LEN;
+            check_span(u64_at(image.data(), at), u32_at(image.data(), at + 8) as u64, blob_len)?;
+            let (start, end) = (image.name_first(n), if n + 1 < names { image.name_first(n + 1) } else { records });
+            if (n == 0 && start != 0) || start >= end {
+                return Err(corrupt("name table is not grouped by record"));
+            }
+            if n > 0 && image.name_bytes(n - 1) >= image.name_bytes(n) {
+                return Err(corrupt("name table is not sorted"));
+            }
+            if (start + 1..end).any(|r| image.sort_key(r - 1) >= image.sort_key(r)) {
+                return Err(corrupt("records are not sorted"));
+            }
+        }
+        for r in 0..records {
+            let at = image.record_at(r);
+            let data = image.data();
+            let len = u16_at(data, at + 24) as u64 + u16_at(data, at + 26) as u64 + u16_at(data, at + 28) as u64;
+            check_span(u64_at(data, at + 16), len, blob_len)?;
+            if channel_from_code(data[at + 12]).is_none() {
+                return Err(corrupt("unknown channel"));
+            }
+        }
+        Ok(image)
+    }
+
+    /// Number of (name, version) entries
+    pub fn len(&self) -> usize {
+        self.records
+    }
+
+    /// True if the image holds no entries
+    pub fn is_empty(&self) -> bool {
+        self.records == 0
+    }
+
+    /// Exact lookup of one version, O(log n)
+    pub fn get(&self, name: &str, version: &SemVerX) -> Option<PackageEntryRef<'_>> {
+        let _span = plpprofiler::span(Probe::RegistryGet);
+        let (name, group) = self.find_name(name)?;
+        let want = (version.major, version.minor, version.patch, version.channel as u8);
+        let slot = self.search(group.clone(), |r| self.sort_key(r) < want);
+        (slot < group.end && self.sort_key(slot) == want).then(|| self.view(slot, name))?
+    }
+
+    /// All versions of `name`, ascending
+    pub fn versions<'a>(&'a self, name: &str) -> impl Iterator<Item = PackageEntryRef<'a>> + 'a {
+        let found = self.find_name(name);
+        found.into_iter().flat_map(move |(name, group)| group.filter_map(move |r| self.view(r, name)))
+    }
+
+    /// Highest version of `name` satisfying a requirement like `^1.2(stable)`
+    ///
+    /// O(log n + k) for k versions inside the requirement's tuple range.
+    pub fn max_satisfying(&self, name: &str, req: &str) -> Option<PackageEntryRef<'_>> {
+        let _span = plpprofiler::span(Probe::RegistryMaxSatisfying);
+        let req = VersionReq::parse(req)?;
+        let (name, group) = self.find_name(name)?;
+        let tuple = |r: usize| {
+            let (major, minor, patch, _) = self.sort_key(r);
+            (major, minor, patch)
+        };
+        let lo = self.search(group.clone(), |r| tuple(r) < req.lower);
+        let hi = match req.upper {
+            Some(upper) => self.search(lo..group.end, |r| tuple(r) < upper),
+            None => group.end,
+        };
+        (lo..hi)
+            .rev()
+            .find(|&r| req.channel.is_none_or(|channel| self.sort_key(r).3 == channel as u8))
+            .and_then(|r| self.view(r, name))
+    }
+
+    fn data(&self) -> &[u8] {
+        &self.bytes
+    }
+
+    fn blob_slice(&self, offset: u64, len: usize) -> &[u8] {
+        let start = self.blob + offset as usize;
+        &self.data()[start..start + len]
+    }
+
+    fn name_first(&self, n: usize) -> usize {
+        u32_at(self.data(), HEADER_LEN + n * NAME_LEN + 12) as usize
+    }
+
+    fn name_bytes(&self, n: usize) -> &[u8] {
+        let at = HEADER_LEN + n * NAME_LEN;
+        self.blob_slice(u64_at(self.data(), at), u32_at(self.data(), at + 8) as usize)
+    }
+
+    /// Name as stored in the image plus its record range
+    fn find_name(&self, name: &str) -> Option<(&str, Range<usize>)> {
+        let n = self.search(0..self.names, |n| self.name_bytes(n) < name.as_bytes());
+        if n == self.names || self.name_bytes(n) != name.as_bytes() {
+            return None;
+        }
+        let end = if n + 1 < self.names { self.name_first(n + 1) } else { self.records };
+        let stored = std::str::from_utf8(self.name_bytes(n)).ok()?;
+        Some((stored, self.name_first(n)..end))
+    }
+
+    fn record_at(&self, r: usize) -> usize {
+        HEADER_LEN + self.names * NAME_LEN + r * RECORD_LEN
+    }
+
+    fn sort_key(&self, r: usize) -> (u32, u32, u32, u8) {
+        let (data, at) = (self.data(), self.record_at(r));
+        (u32_at(data, at), u32_at(data, at + 4), u32_at(data, at + 8), data[at + 12])
+    }
+
+    /// First index in `range` for which `before` is false
+    fn search(&self, range: Range<usize>, before: impl Fn(usize) -> bool) -> usize {
+        let (mut lo, mut hi) = (range.start, range.end);
+        while lo < hi {
+            let mid = lo + (hi - lo) / 2;
+            if before(mid) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        lo
+    }
+
+    /// Entry view for record `r`; None if its version is not UTF-8
+    fn view<'a>(&'a self, r: usize, name: &'a str) -> Option<PackageEntryRef<'a>> {
+        let (data, at) = (self.data(), self.record_at(r));
+        let lens = [u16_at(data, at + 24), u16_at(data, at + 26), u16_at(data, at + 28)].map(usize::from);
+        let fields = self.blob_slice(u64_at(data, at + 16), lens.iter().sum());
+        let (version, rest) = fields.split_at(lens[0]);
+        let (tarball_hash, signature) = rest.split_at(lens[1]);
+        Some(PackageEntryRef {
+            name,
+            version: std::str::from_utf8(version).ok()?,
+            tarball_hash,
+            signature,
+        })
+    }
+}
+
+impl PackageRegistry {
+    /// Serialize the registry as a `RegistryImage`, O(n log n)
+    ///
+    /// Fails with `InvalidInput` if a version, tarball hash or signature
+    /// exceeds 64 KiB, or the registry holds more than `u32::MAX` entries.
+    pub fn write_image(&self, out: impl Write) -> io::Result<()> {
+        let names: BTreeSet<&str> = self.entries.iter().map(|e| e.name.as_str()).collect();
+        let groups: Vec<(&str, Vec<&PackageEntry>)> =
+            names.into_iter().map(|name| (name, self.versions(name).collect())).collect();
+
+        let mut tables = Vec::with_capacity(groups.len() * NAME_LEN + self.entries.len() * RECORD_LEN);
+        let mut records = Vec::with_capacity(self.entries.len() * RECORD_LEN);
+        let (mut blob_len, mut first) = (0u64, 0usize);
+        for (name, entries) in &groups {
+            tables.extend_from_slice(&blob_len.to_le_bytes());
+            tables.extend_from_slice(&field_len::<u32>(name.as_bytes())?.to_le_bytes());
+            tables.extend_from_slice(&count(first)?.to_le_bytes());
+            blob_len += name.len() as u64;
+
+            for entry in entries {
+                let version = SemVerX::parse(&entry.version).ok_or_else(|| corrupt("unparsable version"))?;
+                let lens = [
+                    field_len::<u16>(entry.version.as_bytes())?,
+                    field_len::<u16>(&entry.tarball_hash)?,
+                    field_len::<u16>(&entry.signature)?,
+                ];
+                for part in [version.major, version.minor, version.patch] {
+                    records.extend_from_slice(&part.to_le_bytes());
+                }
+                records.extend_from_slice(&[version.channel as u8, 0, 0, 0]);
+                records.extend_from_slice(&blob_len.to_le_bytes());
+                for len in lens {
+                    records.extend_from_slice(&len.to_le_bytes());
+                }
+                records.extend_from_slice(&[0, 0]);
+                blob_len += lens.iter().map(|&len| len as u64).sum::<u64>();
+            }
+            first += entries.len();
+        }
+        tables.append(&mut records);
+
+        let mut out = BufWriter::new(out);
+        out.write_all(MAGIC)?;
+        for word in [FORMAT_VERSION, count(groups.len())?, count(self.entries.len())?, 0] {
+            out.write_all(&word.to_le_bytes())?;
+        }
+        out.write_all(&blob_len.to_le_bytes())?;
+        out.write_all(&tables)?;
+        for (name, entries) in &groups {
+            out.write_all(name.as_bytes())?;
+            for entry in entries {
+                out.write_all(entry.version.as_bytes())?;
+                out.write_all(&entry.tarball_hash)?;
+                out.write_all(&entry.signature)?;
+            }
+        }
+        out.flush()
+    }
+
+    /// Write an image to `path`, atomically replacing any existing one
+    ///
+    /// The image is written to a fresh file beside `path` and renamed
+    /// over it, so processes that still map the old image keep a
+    /// consistent view and concurrent saves never share a temp file.
+    pub fn save_image(&self, path: impl AsRef<Path>) -> io::Result<()> {
+        let path = path.as_ref();
+        let (tmp, file) = create_temp(path)?;
+        let saved = self
+            .write_image(&file)
+            .and_then(|()| file.sync_all())
+            .and_then(|()| fs::rename(&tmp, path));
+        if saved.is_err() {
+            let _ = fs::remove_file(&tmp);
+        }
+        saved
+    }
+}
+
+/// Create a new file `<path>.<pid>.<n>.tmp` that no other save uses
+fn create_temp(path: &Path) -> io::Result<(PathBuf, File)> {
+    static NEXT: AtomicU64 = AtomicU64::new(0);
+    loop {
+        let mut tmp = path.as_os_str().to_owned();
+        tmp.push(format!(".{}.{}.tmp", std::process::id(), NEXT.fetch_add(1, Ordering::Relaxed)));
+        match OpenOptions::new().write(true).create_new(true).open(&tmp) {
+            Ok(file) => return Ok((tmp.into(), file)),
+            Err(e) if e.kind() == io::ErrorKind::AlreadyExists => continue,
+            Err(e) => return Err(e),
+        }
+    }
+}
+
+fn corrupt(reason: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, reason)
+}
+
+fn check_span(offset: u64, len: u64, blob_len: u64) -> io::Result<()> {
+    match offset.checked_add(len) {
+        Some(end) if end <= blob_len => Ok(()),
+        _ => Err(corrupt("blob reference out of range")),
+    }
+}
+
+fn field_len<T: TryFrom<usize>>(field: &[u8]) -> io::Result<T> {
+    T::try_from(field.len()).map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "field too long for image"))
+}
+
+fn count(n: usize) -> io::Result<u32> {
+    u32::try_from(n).map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "too many entries for image"))
+}
+
+fn channel_from_code(code: u8) -> Option<Channel> {
+    match code {
+        0 => Some(Channel::Legacy),
+        1 => Some(Channel::Experimental),
+        2 => Some(Channel::Stable),
+        3 => Some(Channel::LTS),
+        _ => None,
+    }
+}
+
+fn u16_at(data: &[u8], at: usize) -> u16 {
+    u16::from_le_bytes([data[at], data[at + 1]])
+}
+
+fn u32_at(data: &[u8], at: usize) -> u32 {
+    u32::from_le_bytes(data[at..at + 4].try_into().unwrap())
+}
+
+fn u64_at(data: &[u8], at: usize) -> u64 {
+    u64::from_le_bytes(data[at..at + 8].try_into().unwrap())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn registry() -> PackageRegistry {
+        let mut registry = PackageRegistry::new();
+        for (name, version) in [
+            ("core", "1.0.0"),
+            ("core", "1.2.0"),
+            ("core", "1.3.1(experimental)"),
+            ("core", "2.0.0"),
+            ("cli", "0.1.0"),
+        ] {
+            registry.publish(PackageEntry {
+                name: name.to_string(),
+                version: version.to_string(),
+                tarball_hash: version.as_bytes().to_vec(),
+                signature: vec![0xAA; 64],
+            });
+        }
+        registry
+    }
+
+    #[test]
+    fn test_image_matches_registry() {
+        let registry = registry();
+        let mut bytes = Vec::new();
+        registry.write_image(&mut bytes).unwrap();
+        let image = RegistryImage::from_bytes(bytes).unwrap();
+
+        assert_eq!(image.len(), registry.len());
+        let v12 = SemVerX::parse("1.2.0").unwrap();
+        assert_eq!(image.get("core", &v12), registry.get("core", &v12).map(PackageEntry::view));
+        assert_eq!(image.get("core", &SemVerX::parse("1.2.0(lts)").unwrap()), None);
+        assert_eq!(image.get("missing", &v12), None);
+
+        let versions: Vec<_> = image.versions("core").map(|e| e.version).collect();
+        assert_eq!(versions, ["1.0.0", "1.2.0", "1.3.1(experimental)", "2.0.0"]);
+        for req in ["^1.0(stable)", "^1", "~1.3", ">=0.0", "=3", "*(lts)"] {
+            let expected = registry.max_satisfying("core", req).map(PackageEntry::view);
+            assert_eq!(image.max_satisfying("core", req), expected, "{}", req);
+        }
+        assert_eq!(image.max_satisfying("cli", "*").unwrap().to_entry().version, "0.1.0");
+    }
+
+    #[test]
+    fn test_open_mapped_file_and_reject_corruption() {
+        let path = std::env::temp_dir().join(format!("semverx-image-{}.idx", std::process::id()));
+        registry().save_image(&path).unwrap();
+        let image = RegistryImage::open(&path).unwrap();
+        assert_eq!(image.versions("cli").count(), 1);
+        let bytes = fs::read(&path).unwrap();
+        fs::remove_file(&path).unwrap();
+
+        assert!(RegistryImage::from_bytes(&bytes[..bytes.len() - 1]).is_err(), "truncated");
+        let mut bad = bytes.clone();
+        bad[8] = 9;
+        assert!(RegistryImage::from_bytes(bad).is_err(), "future format");
+        let first_record = HEADER_LEN + 2 * NAME_LEN;
+        let mut bad = bytes.clone();
+        bad[first_record + 16..first_record + 24].copy_from_slice(&u64::MAX.to_le_bytes());
+        assert!(RegistryImage::from_bytes(bad).is_err(), "dangling blob offset");
+
+        // Tables sorted by name and version, every name with a record
+        let mut bad = bytes.clone();
+        bad[HEADER_LEN + NAME_LEN + 12..HEADER_LEN + NAME_LEN + 16].copy_from_slice(&0u32.to_le_bytes());
+        assert!(RegistryImage::from_bytes(bad).is_err(), "empty name group");
+        let mut bad = bytes.clone();
+        bad[first_record + RECORD_LEN..first_record + RECORD_LEN + 4].copy_from_slice(&9u32.to_le_bytes());
+        assert!(RegistryImage::from_bytes(bad).is_err(), "unsorted records");
+        let mut bad = bytes;
+        bad[first_record + 5 * RECORD_LEN] = b'd';
+        assert!(RegistryImage::from_bytes(bad).is_err(), "unsorted names");
+    }
+
+    #[test]
+    fn test_save_leaves_no_temp_files() {
+        let dir = std::env::temp_dir().join(format!("semverx-image-save-{}", std::process::id()));
+        fs::create_dir_all(&dir).unwrap();
+        let path = dir.join("registry.img");
+        registry().save_image(&path).unwrap();
+        registry().save_image(&path).unwrap();
+        assert!(RegistryImage::open(&path).is_ok());
+        assert_eq!(fs::read_dir(&dir).unwrap().count(), 1);
+        fs::remove_dir_all(&dir).unwrap();
+    }
+}
@@ -0,0 +1,191 @@
+//! AVL-Backed Package Registry
+//! 
+//! Features:
+//! - O(log n) lookups
+//! - AuraSeal cryptographic signing
+//! - Rate-limited observer pattern (5-10 updates/sec)
+//! - Lock-free readers over RCU-published snapshots
+//! - Zero-copy cold start from memory-mapped images
+//! - Branch-free bulk range matching over packed version keys
+
+pub mod avl_tree;
+pub mod aura_seal;
+pub mod image;
+pub mod rate_limiter;
+pub mod snapshot;
+
+use crate::audit::plpprofiler::{self, Probe};
+use crate::resolver::Interner;
+use crate::SemVerX;
+
+pub use aura_seal::{AuraSeal, SealError};
+pub use avl_tree::{filter_satisfying, AvlIndex, IndexKey, VersionReq};
+pub use image::RegistryImage;
+pub use rate_limiter::RateLimiter;
+pub use snapshot::{RegistryWriter, SharedRegistry};
+
+/// Published packages indexed by (name, version, channel)
+///
+/// Entries are stored once in publish order; the AVL index maps each
+/// key to its slot, so per-name and range queries never touch entries
+/// outside the answer.
+#[derive(Debug, Clone, Default)]
+pub struct PackageRegistry {
+    names: Interner,
+    index: AvlIndex<u32>,
+    entries: Vec<PackageEntry>,
+}
+
+/// One published package version
+#[derive(Debug, Clone)]
+pub struct PackageEntry {
+    /// Package name
+    pub name: String,
+    /// SemVerX version string, e.g. `1.2.0(stable)`
+    pub version: String,
+    /// Content digest of the package tarball
+    pub tarball_hash: Vec<u8>,
+    /// AuraSeal: Ed25519 signature by the registry key over `tarball_hash`
+    pub signature: Vec<u8>,
+}
+
+/// Borrowed view of a `PackageEntry`, e.g. into a mapped `RegistryImage`
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct PackageEntryRef<'a> {
+    /// Package name
+    pub name: &'a str,
+    /// SemVerX version string
+    pub version: &'a str,
+    /// Tarball digest
+    pub tarball_hash: &'a [u8],
+    /// AuraSeal signature over the tarball
+    pub signature: &'a [u8],
+}
+
+impl PackageEntry {
+    /// Borrow as a view
+    pub fn view(&self) -> PackageEntryRef<'_> {
+        PackageEntryRef {
+            name: &self.name,
+            version: &self.version,
+            tarball_hash: &self.tarball_hash,
+            signature: &self.signature,
+        }
+    }
+}
+
+impl PackageEntryRef<'_> {
+    /// Copy into an owned entry
+    pub fn to_entry(&self) -> PackageEntry {
+        PackageEntry {
+            name: self.name.to_string(),
+            version: self.version.to_string(),
+            tarball_hash: self.tarball_hash.to_vec(),
+            signature: self.signature.to_vec(),
+        }
+    }
+}
+
+impl PackageRegistry {
+    /// Empty registry
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Number of published (name, version) entries
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    /// True if nothing has been published
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Every entry in publish order
+    pub fn entries(&self) -> &[PackageEntry] {
+        &self.entries
+    }
+
+    /// Publish an entry, O(log n)
+    ///
+    /// Published versions are immutable: returns false, keeping the
+    /// existing entry, if `entry.name` already has `entry.version`.
+    /// Also returns false if `entry.version` is not a SemVerX version.
+    pub fn publish(&mut self, entry: PackageEntry) -> bool {
+        let version = match SemVerX::parse(&entry.version) {
+            Some(version) => version,
+            None => return false,
+        };
+        let key = IndexKey::new(self.names.intern(&entry.name), &version);
+
+        if self.index.get(&key).is_some() {
+            return false;
+        }
+        self.index.insert(key, self.entries.len() as u32);
+        self.entries.push(entry);
+        true
+    }
+
+    /// Exact lookup of one published version, O(log n)
+    pub fn get(&self, name: &str, version: &SemVerX) -> Option<&PackageEntry> {
+        let _span = plpprofiler::span(Probe::RegistryGet);
+        let key = IndexKey::new(self.names.get(name)?, version);
+        self.index.get(&key).map(|&slot| &self.entries[slot as usize])
+    }
+
+    /// All published versions of `name`, ascending
+    pub fn versions<'a>(&'a self, name: &str) -> impl Iterator<Item = &'a PackageEntry> + 'a {
+        let range = self.names.get(name).map(|sym| self.index.versions(sym));
+        range.into_iter().flatten().map(move |(_, &slot)| &self.entries[slot as usize])
+    }
+
+    /// Highest version of `name` satisfying a requirement like `^1.2(stable)`
+    ///
+    /// O(log n + k) for k versions inside the requirement's tuple range.
+    pub fn max_satisfying(&self, name: &str, req: &str) -> Option<&PackageEntry> {
+        let _span = plpprofiler::span(Probe::RegistryMaxSatisfying);
+        let req = VersionReq::parse(req)?;
+        let (_, &slot) = self.index.max_satisfying(self.names.get(name)?, &req)?;
+        Some(&self.entries[slot as usize])
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn entry(name: &str, version: &str) -> PackageEntry {
+        PackageEntry {
+            name: name.to_string(),
+            version: version.to_string(),
+            tarball_hash: Vec::new(),
+            signature: Vec::new(),
+        }
+    }
+
+    #[test]
+    fn test_publish_and_query() {
+        let mut registry = PackageRegistry::new();
+        for version in ["1.0.0", "1.2.0", "1.3.1(experimental)", "2.0.0"] {
+            assert!(registry.publish(entry("core", version)));
+        }
+        assert!(registry.publish(entry("cli", "0.1.0")));
+        assert!(!registry.publish(entry("core", "latest")));
+
+        let best = registry.max_satisfying("core", "^1.0(stable)").unwrap();
+        assert_eq!(best.version, "1.2.0");
+        assert_eq!(registry.versions("core").count(), 4);
+        assert_eq!(registry.versions("missing").count(), 0);
+
+        let v2 = SemVerX::parse("2.0.0").unwrap();
+        assert_eq!(registry.get("core", &v2).unwrap().version, "2.0.0");
+
+        // Republishing a version is rejected and keeps the original
+        let mut patched = entry("core", "2.0.0");
+        patched.tarball_hash = vec![1];
+        assert!(!registry.publish(patched));
+        assert_eq!(registry.len(), 5);
+        assert!(registry.get("core", &v2).unwrap().tarball_hash.is_empty());
+    }
+}
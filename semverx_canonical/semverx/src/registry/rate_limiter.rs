@@ -0,0 +1,60 @@
+//! Writer-side rate limiting for registry publications
+//!
+//! The registry publishes at most one snapshot per tick (5-10 per
+//! second); publishes arriving in between are batched into the next one.
+
+use std::time::{Duration, Instant};
+
+/// Fixed-interval tick gate
+#[derive(Debug, Clone)]
+pub struct RateLimiter {
+    interval: Duration,
+    next_tick: Option<Instant>,
+}
+
+impl RateLimiter {
+    /// Gate opening at most once per `interval`
+    pub fn new(interval: Duration) -> Self {
+        Self { interval, next_tick: None }
+    }
+
+    /// Gate opening at most `updates` times per second
+    pub fn per_second(updates: u32) -> Self {
+        Self::new(Duration::from_secs(1) / updates.max(1))
+    }
+
+    /// Minimum time between two ticks
+    pub fn interval(&self) -> Duration {
+        self.interval
+    }
+
+    /// Take the tick if one is due at `now`
+    ///
+    /// The first call always succeeds; afterwards at most one call per
+    /// interval does.
+    pub fn try_acquire(&mut self, now: Instant) -> bool {
+        match self.next_tick {
+            Some(tick) if now < tick => false,
+            _ => {
+                self.next_tick = Some(now + self.interval);
+                true
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_one_tick_per_interval() {
+        let mut limiter = RateLimiter::per_second(10);
+        let t0 = Instant::now();
+
+        assert!(limiter.try_acquire(t0));
+        assert!(!limiter.try_acquire(t0 + Duration::from_millis(50)));
+        assert!(limiter.try_acquire(t0 + Duration::from_millis(100)));
+        assert!(!limiter.try_acquire(t0 + Duration::from_millis(150)));
+    }
+}
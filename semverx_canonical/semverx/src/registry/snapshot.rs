@@ -0,0 +1,202 @@
+//! RCU-style publication of registry snapshots
+//!
+//! Readers load the current `Arc<PackageRegistry>` through an atomic
+//! pointer and never take a lock. The single writer queues publishes and
+//! folds each rate-limiter tick's batch into one new immutable snapshot.
+
+use arc_swap::ArcSwap;
+use std::sync::Arc;
+use std::time::Instant;
+
+use crate::SemVerX;
+use super::rate_limiter::RateLimiter;
+use super::{PackageEntry, PackageRegistry};
+
+/// Publication point shared by one writer and any number of readers
+#[derive(Debug)]
+pub struct SharedRegistry {
+    current: ArcSwap<PackageRegistry>,
+}
+
+impl SharedRegistry {
+    /// Publication point starting at `initial`
+    pub fn new(initial: PackageRegistry) -> Self {
+        Self { current: ArcSwap::from_pointee(initial) }
+    }
+
+    /// The latest snapshot, kept alive for as long as the caller holds it
+    ///
+    /// Lock-free: one atomic load plus a reference-count increment.
+    pub fn snapshot(&self) -> Arc<PackageRegistry> {
+        self.current.load_full()
+    }
+
+    /// Run `f` against the latest snapshot
+    ///
+    /// Cheaper than `snapshot` for short reads such as a single lookup.
+    pub fn read<R>(&self, f: impl FnOnce(&PackageRegistry) -> R) -> R {
+        f(&self.current.load())
+    }
+}
+
+/// Batching writer for a `SharedRegistry`
+///
+/// `publish` only queues; `tick` turns everything queued since the last
+/// tick into one snapshot. Building a snapshot normally costs O(batch):
+/// the buffer replaced two publications ago is recycled once no reader
+/// holds it any more, and only needs the previous batch replayed. If a
+/// reader still pins it, the current snapshot is cloned instead.
+///
+/// There must be one writer per `SharedRegistry`; share it behind a
+/// `Mutex` if several threads publish.
+#[derive(Debug)]
+pub struct RegistryWriter {
+    shared: Arc<SharedRegistry>,
+    limiter: RateLimiter,
+    pending: Vec<PackageEntry>,
+    /// Snapshot replaced by the last publication, and the batch it lacks
+    spare: Option<Arc<PackageRegistry>>,
+    lagging: Vec<PackageEntry>,
+    publications: u64,
+}
+
+impl RegistryWriter {
+    /// Writer publishing into `shared` at most once per `limiter` tick
+    pub fn new(shared: Arc<SharedRegistry>, limiter: RateLimiter) -> Self {
+        Self {
+            shared,
+            limiter,
+            pending: Vec::new(),
+            spare: None,
+            lagging: Vec::new(),
+            publications: 0,
+        }
+    }
+
+    /// Queue an entry for the next snapshot
+    ///
+    /// Returns false (and drops the entry) if its version does not parse
+    /// or is already published; of duplicates within one batch the first
+    /// queued wins.
+    pub fn publish(&mut self, entry: PackageEntry) -> bool {
+        let version = match SemVerX::parse(&entry.version) {
+            Some(version) => version,
+            None => return false,
+        };
+        if self.shared.read(|r| r.get(&entry.name, &version).is_some()) {
+            return false;
+        }
+        self.pending.push(entry);
+        true
+    }
+
+    /// Entries waiting for the next tick
+    pub fn pending(&self) -> usize {
+        self.pending.len()
+    }
+
+    /// Snapshots published so far
+    pub fn publications(&self) -> u64 {
+        self.publications
+    }
+
+    /// Publish the queued batch if a limiter tick is due at `now`
+    ///
+    /// Returns true if a new snapshot was published.
+    pub fn tick(&mut self, now: Instant) -> bool {
+        if self.pending.is_empty() || !self.limiter.try_acquire(now) {
+            return false;
+        }
+        self.flush();
+        true
+    }
+
+    /// Publish the queued batch now, bypassing the limiter
+    pub fn flush(&mut self) {
+        if self.pending.is_empty() {
+            return;
+        }
+
+        let mut next = match self.spare.take().map(Arc::try_unwrap) {
+            Some(Ok(mut recycled)) => {
+                for entry in self.lagging.drain(..) {
+                    recycled.publish(entry);
+                }
+                recycled
+            }
+            _ => {
+                self.lagging.clear();
+                PackageRegistry::clone(&self.shared.snapshot())
+            }
+        };
+        for entry in &self.pending {
+            next.publish(entry.clone());
+        }
+
+        self.spare = Some(self.shared.current.swap(Arc::new(next)));
+        self.lagging = std::mem::take(&mut self.pending);
+        self.publications += 1;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::time::Duration;
+
+    fn entry(version: &str) -> PackageEntry {
+        PackageEntry {
+            name: "core".to_string(),
+            version: version.to_string(),
+            tarball_hash: Vec::new(),
+            signature: Vec::new(),
+        }
+    }
+
+    #[test]
+    fn test_batches_publish_once_per_tick() {
+        let shared = Arc::new(SharedRegistry::new(PackageRegistry::new()));
+        let mut writer = RegistryWriter::new(Arc::clone(&shared), RateLimiter::per_second(5));
+        let t0 = Instant::now();
+
+        for patch in 0..4 {
+            assert!(writer.publish(entry(&format!("1.0.{}", patch))));
+        }
+        assert!(!writer.publish(entry("nightly")));
+        assert_eq!(shared.read(|r| r.len()), 0, "nothing visible before the tick");
+
+        assert!(writer.tick(t0));
+        assert_eq!(shared.read(|r| r.len()), 4);
+        assert!(!writer.publish(entry("1.0.2")), "published versions are immutable");
+
+        writer.publish(entry("1.1.0"));
+        assert!(!writer.tick(t0 + Duration::from_millis(100)), "within the same interval");
+        assert!(writer.tick(t0 + Duration::from_millis(200)));
+        assert_eq!(writer.publications(), 2);
+        let latest = shared.read(|r| r.max_satisfying("core", "^1").map(|e| e.version.clone()));
+        assert_eq!(latest.as_deref(), Some("1.1.0"));
+    }
+
+    #[test]
+    fn test_pinned_readers_keep_their_snapshot() {
+        let shared = Arc::new(SharedRegistry::new(PackageRegistry::new()));
+        let mut writer = RegistryWriter::new(Arc::clone(&shared), RateLimiter::per_second(10));
+
+        let empty = shared.snapshot();
+        writer.publish(entry("1.0.0"));
+        writer.flush();
+        let first = shared.snapshot();
+
+        // Spares pinned by `empty` / `first` force clones; the last flush recycles
+        writer.publish(entry("1.1.0"));
+        writer.flush();
+        drop(empty);
+        writer.publish(entry("1.2.0"));
+        writer.flush();
+        writer.publish(entry("1.3.0"));
+        writer.flush();
+
+        assert_eq!(first.len(), 1);
+        assert_eq!(shared.read(|r| r.versions("core").count()), 4);
+    }
+}
@@ -0,0 +1,36 @@
+// src/resolver/bitset.rs
+// Dense bitset over node indices, shared by the search engines
+
+/// Fixed-width bitset over dense node indices
+#[derive(Debug, Clone)]
+pub struct BitSet {
+    words: Vec<u64>,
+}
+
+impl BitSet {
+    /// Empty set with room for bits `0..bits`
+    pub fn new(bits: usize) -> Self {
+        Self { words: vec![0; bits.div_ceil(64)] }
+    }
+
+    /// Bits past the end read as unset, so a set sized for an older
+    /// graph can be probed with indices of nodes added since
+    #[inline]
+    pub fn contains(&self, bit: u32) -> bool {
+        self.words
+            .get((bit / 64) as usize)
+            .is_some_and(|word| word & (1u64 << (bit % 64)) != 0)
+    }
+
+    /// Set `bit`; panics past the width given to `new`
+    #[inline]
+    pub fn insert(&mut self, bit: u32) {
+        self.words[(bit / 64) as usize] |= 1u64 << (bit % 64);
+    }
+
+    /// Clear `bit`; panics past the width given to `new`
+    #[inline]
+    pub fn remove(&mut self, bit: u32) {
+        self.words[(bit / 64) as usize] &= !(1u64 << (bit % 64));
+    }
+}
@@ -0,0 +1,459 @@
+// src/resolver/cache.rs
+// Bounded, concurrent LRU cache of resolution results
+// Entries are stamped with the graph generation and revalidated lazily
+
+use petgraph::graph::NodeIndex;
+use std::collections::hash_map::DefaultHasher;
+use std::collections::{HashMap, HashSet};
+use std::hash::{Hash, Hasher};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Mutex;
+use std::time::Duration;
+
+use super::errors::ResolverError;
+use super::graph::GraphView;
+use super::intern::Symbol;
+use super::planner::Planner;
+use super::strategies::{
+    astar_resolve_symbols, bidirectional_resolve_symbols, find_hamiltonian_path_between_symbols,
+    is_eulerian, materialize,
+};
+use super::types::{NodeId, Path, ResolutionStrategy, SymbolPath, Unresolved};
+
+/// Number of independently locked shards
+const SHARD_COUNT: usize = 16;
+
+/// Stale entries are recomputed outright past this many new edges
+const MAX_REVALIDATION_EDGES: usize = 4096;
+
+/// Budget for cached Hamiltonian resolutions (same as the hybrid fallback)
+const HAMILTONIAN_TIMEOUT: Duration = Duration::from_millis(500);
+
+/// Sentinel link in the intrusive LRU list
+const NIL: usize = usize::MAX;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+struct CacheKey {
+    start: Symbol,
+    goal: Symbol,
+    strategy: ResolutionStrategy,
+}
+
+/// Cached outcome and the generation it is known valid at
+#[derive(Debug, Clone)]
+struct CachedResult {
+    /// Graph generation the result was last known valid at
+    generation: u64,
+    /// None records `NoPathFound`; strings are only built on the way out
+    result: Option<SymbolPath>,
+}
+
+#[derive(Debug)]
+struct Entry {
+    key: CacheKey,
+    value: CachedResult,
+    prev: usize,
+    next: usize,
+}
+
+/// One LRU shard: hash index into a slab threaded by a doubly linked list
+#[derive(Debug)]
+struct LruShard {
+    map: HashMap<CacheKey, usize>,
+    entries: Vec<Entry>,
+    head: usize, // most recently used
+    tail: usize, // least recently used
+    capacity: usize,
+}
+
+impl LruShard {
+    fn new(capacity: usize) -> Self {
+        Self {
+            map: HashMap::with_capacity(capacity),
+            entries: Vec::with_capacity(capacity),
+            head: NIL,
+            tail: NIL,
+            capacity,
+        }
+    }
+
+    fn get(&mut self, key: &CacheKey) -> Option<&mut CachedResult> {
+        let slot = *self.map.get(key)?;
+        self.unlink(slot);
+        self.push_front(slot);
+        Some(&mut self.entries[slot].value)
+    }
+
+    fn insert(&mut self, key: CacheKey, value: CachedResult) {
+        if let Some(&slot) = self.map.get(&key) {
+            self.entries[slot].value = value;
+            self.unlink(slot);
+            self.push_front(slot);
+            return;
+        }
+
+        let slot = if self.entries.len() < self.capacity {
+            self.entries.push(Entry { key, value, prev: NIL, next: NIL });
+            self.entries.len() - 1
+        } else {
+            // Recycle the least recently used slot
+            let slot = self.tail;
+            self.unlink(slot);
+            self.map.remove(&self.entries[slot].key);
+            self.entries[slot].key = key;
+            self.entries[slot].value = value;
+            slot
+        };
+
+        self.map.insert(key, slot);
+        self.push_front(slot);
+    }
+
+    fn unlink(&mut self, slot: usize) {
+        let (prev, next) = (self.entries[slot].prev, self.entries[slot].next);
+        match prev {
+            NIL => self.head = next,
+            p => self.entries[p].next = next,
+        }
+        match next {
+            NIL => self.tail = prev,
+            n => self.entries[n].prev = prev,
+        }
+    }
+
+    fn push_front(&mut self, slot: usize) {
+        self.entries[slot].prev = NIL;
+        self.entries[slot].next = self.head;
+        match self.head {
+            NIL => self.tail = slot,
+            h => self.entries[h].prev = slot,
+        }
+        self.head = slot;
+    }
+}
+
+/// Snapshot of cache counters
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    /// Lookups answered from the cache (including revalidated ones)
+    pub hits: u64,
+    /// Lookups that ran a graph search
+    pub misses: u64,
+    /// Stale entries kept because no new edge touched their subgraph
+    pub revalidated: u64,
+    /// Stale entries dropped because a new edge did
+    pub invalidated: u64,
+}
+
+/// Resolution result cache keyed by (start, goal, strategy)
+///
+/// Each entry is stamped with the `DependencyGraph::generation` it was
+/// computed at. A lookup at a newer generation replays only the edges
+/// added since: if none of their sources is reachable from `start`, the
+/// result cannot have changed and the entry is restamped; otherwise it is
+/// recomputed. Reachability is checked on demand, by a search of the
+/// current graph that stops at the first new source it meets, so misses
+/// pay nothing extra and entries hold no per-node state.
+///
+/// Eulerian and Hamiltonian results depend on the whole graph (degree
+/// balance, every node on the path), so they are reused only at the
+/// exact generation they were computed at.
+///
+/// A cache belongs to a single graph and the snapshots frozen from it;
+/// sharing one across unrelated graphs is a logic error.
+#[derive(Debug)]
+pub struct ResolutionCache {
+    shards: Vec<Mutex<LruShard>>,
+    hits: AtomicU64,
+    misses: AtomicU64,
+    revalidated: AtomicU64,
+    invalidated: AtomicU64,
+    planner: Planner,
+}
+
+impl ResolutionCache {
+    /// Cache holding roughly `capacity` results across all shards
+    pub fn new(capacity: usize) -> Self {
+        let per_shard = capacity.div_ceil(SHARD_COUNT);
+        Self {
+            shards: (0..SHARD_COUNT)
+                .map(|_| Mutex::new(LruShard::new(per_shard.max(1))))
+                .collect(),
+            hits: AtomicU64::new(0),
+            misses: AtomicU64::new(0),
+            revalidated: AtomicU64::new(0),
+            invalidated: AtomicU64::new(0),
+            planner: Planner::default(),
+        }
+    }
+
+    /// Resolve through the cache with the given strategy
+    ///
+    /// Only successful paths and `NoPathFound` are cached; timeouts and
+    /// unknown nodes always go to the graph.
+    pub fn resolve<G: GraphView>(
+        &self,
+        graph: &G,
+        start: NodeId,
+        goal: NodeId,
+        strategy: ResolutionStrategy,
+    ) -> Result<Path, ResolverError> {
+        let start_sym = match graph.symbols().get(&start) {
+            Some(sym) => sym,
+            None => return Err(ResolverError::NodeNotFound(start)),
+        };
+        let goal_sym = match graph.symbols().get(&goal) {
+            Some(sym) => sym,
+            None => return Err(ResolverError::NodeNotFound(goal)),
+        };
+
+        match self.resolve_symbols(graph, start_sym, goal_sym, strategy) {
+            Ok(Some(path)) => Ok(materialize(graph, &path)),
+            Ok(None) => Err(ResolverError::NoPathFound { start, goal }),
+            Err(reason) => Err(ResolverError::ResolutionFailed {
+                strategy,
+                reason: reason.to_string(),
+            }),
+        }
+    }
+
+    /// Handle-level `resolve`: `Ok(None)` is a cached `NoPathFound`,
+    /// `Err` carries the failure reason of an uncacheable outcome
+    ///
+    /// Both handles must come from `graph`'s arena.
+    pub fn resolve_symbols<G: GraphView>(
+        &self,
+        graph: &G,
+        start: Symbol,
+        goal: Symbol,
+        strategy: ResolutionStrategy,
+    ) -> Result<Option<SymbolPath>, &'static str> {
+        let key = CacheKey { start, goal, strategy };
+
+        if let Some(result) = self.lookup(graph, &key) {
+            self.hits.fetch_add(1, Ordering::Relaxed);
+            return Ok(result);
+        }
+        self.misses.fetch_add(1, Ordering::Relaxed);
+
+        let result = run_strategy(graph, start, goal, strategy, &self.planner)?;
+        let value = CachedResult {
+            generation: graph.generation(),
+            result: result.clone(),
+        };
+        self.shard(&key).lock().unwrap().insert(key, value);
+
+        Ok(result)
+    }
+
+    /// Current hit/miss counters
+    pub fn stats(&self) -> CacheStats {
+        CacheStats {
+            hits: self.hits.load(Ordering::Relaxed),
+            misses: self.misses.load(Ordering::Relaxed),
+            revalidated: self.revalidated.load(Ordering::Relaxed),
+            invalidated: self.invalidated.load(Ordering::Relaxed),
+        }
+    }
+
+    fn lookup<G: GraphView>(&self, graph: &G, key: &CacheKey) -> Option<Option<SymbolPath>> {
+        let (generation, result) = {
+            let mut shard = self.shard(key).lock().unwrap();
+            let entry = shard.get(key)?;
+            (entry.generation, entry.result.clone())
+        };
+
+        // Computed on a newer snapshot than the one asking
+        if generation > graph.generation() {
+            return None;
+        }
+
+        if generation != graph.generation() {
+            // Searched without the shard lock held
+            let changed = graph.edges_since(generation);
+            if depends_on_whole_graph(key.strategy)
+                || changed.len() > MAX_REVALIDATION_EDGES
+                || reaches_any(graph, key.start.into(), changed)
+            {
+                self.invalidated.fetch_add(1, Ordering::Relaxed);
+                return None;
+            }
+
+            if let Some(entry) = self.shard(key).lock().unwrap().get(key) {
+                if entry.generation == generation {
+                    entry.generation = graph.generation();
+                }
+            }
+            self.revalidated.fetch_add(1, Ordering::Relaxed);
+        }
+
+        Some(result)
+    }
+
+    fn shard(&self, key: &CacheKey) -> &Mutex<LruShard> {
+        let mut hasher = DefaultHasher::new();
+        key.hash(&mut hasher);
+        &self.shards[hasher.finish() as usize % SHARD_COUNT]
+    }
+}
+
+/// Run `strategy` uncached; `Ok(None)` means the goal is unreachable
+///
+/// Hybrid misses share `planner`, so its graph statistics are built
+/// once per generation rather than once per miss.
+fn run_strategy<G: GraphView>(
+    graph: &G,
+    start: Symbol,
+    goal: Symbol,
+    strategy: ResolutionStrategy,
+    planner: &Planner,
+) -> Result<Option<SymbolPath>, &'static str> {
+    match strategy {
+        ResolutionStrategy::AStar => Ok(astar_resolve_symbols(graph, start, goal)),
+        ResolutionStrategy::Bidirectional => Ok(bidirectional_resolve_symbols(graph, start, goal)),
+        ResolutionStrategy::Eulerian if is_eulerian(graph) => {
+            Ok(astar_resolve_symbols(graph, start, goal))
+        }
+        ResolutionStrategy::Eulerian => Err("Graph is not Eulerian"),
+        ResolutionStrategy::Hybrid => {
+            match planner.resolve(graph, start, goal) {
+                Ok(path) => Ok(Some(path)),
+                Err(Unresolved::Unreachable) => Ok(None),
+                Err(Unresolved::Failed(reason)) => Err(reason),
+            }
+        }
+        ResolutionStrategy::Hamiltonian => {
+            find_hamiltonian_path_between_symbols(graph, start, goal, HAMILTONIAN_TIMEOUT)
+                .map(Some)
+                .ok_or("No Hamiltonian path within budget")
+        }
+    }
+}
+
+/// True for strategies whose answer can change with any edge or node
+fn depends_on_whole_graph(strategy: ResolutionStrategy) -> bool {
+    matches!(strategy, ResolutionStrategy::Eulerian | ResolutionStrategy::Hamiltonian)
+}
+
+/// True if the source of any edge in `changed` is reachable from `start`
+///
+/// Depth-first over the reachable part only, with a sparse visited set,
+/// returning at the first hit. Reachability in the current graph is a
+/// superset of the one the entry was computed on, so this errs towards
+/// invalidating.
+fn reaches_any<G: GraphView>(graph: &G, start: NodeIndex, changed: &[(u64, NodeIndex)]) -> bool {
+    let sources: HashSet<NodeIndex> = changed.iter().map(|&(_, source)| source).collect();
+    let mut visited = HashSet::new();
+    let mut stack = vec![start];
+    visited.insert(start);
+
+    while let Some(node) = stack.pop() {
+        if sources.contains(&node) {
+            return true;
+        }
+        for neighbor in graph.successors(node) {
+            if visited.insert(neighbor) {
+                stack.push(neighbor);
+            }
+        }
+    }
+
+    false
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::graph::DependencyGraph;
+
+    fn chain(graph: &mut DependencyGraph, ids: &[&str]) -> Vec<NodeId> {
+        let ids: Vec<NodeId> = ids.iter().map(|s| graph.add_node(s.to_string())).collect();
+        for pair in ids.windows(2) {
+            graph.add_edge(&pair[0], &pair[1]);
+        }
+        ids
+    }
+
+    #[test]
+    fn test_repeat_resolution_hits() {
+        let mut graph = DependencyGraph::new();
+        let ids = chain(&mut graph, &["1.0.0", "1.1.0", "1.2.0"]);
+        let cache = ResolutionCache::new(64);
+
+        let first = cache.resolve(&graph, ids[0].clone(), ids[2].clone(), ResolutionStrategy::AStar);
+        let second = cache.resolve(&graph, ids[0].clone(), ids[2].clone(), ResolutionStrategy::AStar);
+        assert_eq!(first, second);
+
+        let stats = cache.stats();
+        assert_eq!((stats.hits, stats.misses), (1, 1));
+    }
+
+    #[test]
+    fn test_invalidation_is_scoped_to_reachable_subgraph() {
+        let mut graph = DependencyGraph::new();
+        let ids = chain(&mut graph, &["1.0.0", "1.1.0", "1.2.0", "1.3.0"]);
+        let other = chain(&mut graph, &["9.0.0", "9.1.0"]);
+        let cache = ResolutionCache::new(64);
+
+        let path = cache.resolve(&graph, ids[0].clone(), ids[3].clone(), ResolutionStrategy::AStar);
+        assert_eq!(path.unwrap().cost, 3.0);
+
+        // Unrelated edge: entry survives
+        graph.add_edge(&other[1], &other[0]);
+        let path = cache.resolve(&graph, ids[0].clone(), ids[3].clone(), ResolutionStrategy::AStar);
+        assert_eq!(path.unwrap().cost, 3.0);
+        assert_eq!(cache.stats().revalidated, 1);
+
+        // Shortcut inside the reachable subgraph: entry recomputed
+        graph.add_edge(&ids[0], &ids[3]);
+        let path = cache.resolve(&graph, ids[0].clone(), ids[3].clone(), ResolutionStrategy::AStar);
+        assert_eq!(path.unwrap().cost, 1.0);
+
+        let stats = cache.stats();
+        assert_eq!((stats.hits, stats.misses, stats.invalidated), (1, 2, 1));
+    }
+
+    #[test]
+    fn test_whole_graph_strategies_drop_on_any_change() {
+        let mut graph = DependencyGraph::new();
+        let ids = chain(&mut graph, &["1.0.0", "1.1.0", "1.2.0"]);
+        graph.add_edge(&ids[2], &ids[0]);
+        let cache = ResolutionCache::new(64);
+
+        let euler = |graph: &DependencyGraph| {
+            cache.resolve(graph, ids[0].clone(), ids[2].clone(), ResolutionStrategy::Eulerian)
+        };
+        assert!(euler(&graph).is_ok());
+        assert!(euler(&graph).is_ok());
+        assert_eq!(cache.stats().hits, 1);
+
+        // Source unreachable from start, but the graph is no longer balanced
+        let stray = graph.add_node("0.9.0".to_string());
+        graph.add_edge(&stray, &ids[0]);
+        assert!(euler(&graph).is_err());
+        assert_eq!(cache.stats().invalidated, 1);
+    }
+
+    #[test]
+    fn test_lru_evicts_least_recent() {
+        let key = |i: usize| CacheKey {
+            start: Symbol::from(NodeIndex::new(i)),
+            goal: Symbol::from(NodeIndex::new(i)),
+            strategy: ResolutionStrategy::AStar,
+        };
+        let value = || CachedResult {
+            generation: 0,
+            result: Some(SymbolPath { nodes: vec![], cost: 0.0 }),
+        };
+
+        let mut shard = LruShard::new(2);
+        shard.insert(key(0), value());
+        shard.insert(key(1), value());
+        assert!(shard.get(&key(0)).is_some());
+
+        shard.insert(key(2), value());
+        assert!(shard.get(&key(1)).is_none(), "LRU entry evicted");
+        assert!(shard.get(&key(0)).is_some());
+        assert!(shard.get(&key(2)).is_some());
+    }
+}
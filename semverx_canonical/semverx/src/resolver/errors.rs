@@ -0,0 +1,43 @@
+// src/resolver/errors.rs
+// Resolver error taxonomy
+
+use std::fmt;
+
+use super::types::{NodeId, ResolutionStrategy};
+
+/// Why a string-level resolution failed
+#[derive(Debug, Clone, PartialEq)]
+pub enum ResolverError {
+    /// Node is not present in the dependency graph
+    NodeNotFound(NodeId),
+    /// Both nodes exist but no path connects them
+    NoPathFound {
+        /// Requested start node
+        start: NodeId,
+        /// Requested goal node
+        goal: NodeId,
+    },
+    /// A strategy gave up (timeout, exhausted search space, ...)
+    ResolutionFailed {
+        /// Strategy that gave up
+        strategy: ResolutionStrategy,
+        /// Why it gave up
+        reason: String,
+    },
+}
+
+impl fmt::Display for ResolverError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::NodeNotFound(id) => write!(f, "node not found: {}", id),
+            Self::NoPathFound { start, goal } => {
+                write!(f, "no path from {} to {}", start, goal)
+            }
+            Self::ResolutionFailed { strategy, reason } => {
+                write!(f, "{:?} resolution failed: {}", strategy, reason)
+            }
+        }
+    }
+}
+
+impl std::error::Error for ResolverError {}
@@ -0,0 +1,244 @@
+// src/resolver/frozen.rs
+// Immutable CSR snapshot of a DependencyGraph
+// Read-heavy resolution runs on flat offset/target arrays
+
+use arc_swap::ArcSwap;
+use petgraph::graph::NodeIndex;
+use std::iter::Map;
+use std::slice::Iter;
+use std::sync::Arc;
+
+use crate::SemVerX;
+use super::graph::{DependencyGraph, GraphView};
+use super::intern::Interner;
+
+type IndexIter<'a> = Map<Iter<'a, u32>, fn(&u32) -> NodeIndex>;
+
+/// Compressed sparse row snapshot
+///
+/// The successors of node `v` are `out_targets[out_offsets[v]..out_offsets[v + 1]]`
+/// (and likewise for predecessors), so a hop is one contiguous slice
+/// instead of a walk through petgraph's linked edge lists. Successors
+/// keep the source graph's iteration order, so every strategy returns
+/// the same path on a snapshot as on the graph it was frozen from.
+///
+/// Parsed versions and the cached graph statistics are copied once at
+/// freeze time; the id arena is shared with the source graph's strings
+/// (reference counts only). The snapshot never changes afterwards.
+#[derive(Debug, Clone)]
+pub struct FrozenGraph {
+    out_offsets: Vec<u32>,
+    out_targets: Vec<u32>,
+    in_offsets: Vec<u32>,
+    in_sources: Vec<u32>,
+    symbols: Interner,
+    versions: Vec<Option<SemVerX>>,
+    heuristic_scale: f64,
+    degree_imbalance: usize,
+    edge_components: usize,
+    generation: u64,
+    edge_log: Vec<(u64, NodeIndex)>,
+}
+
+impl FrozenGraph {
+    /// Build the CSR arrays, O(V + E)
+    pub fn from_graph(graph: &DependencyGraph) -> Self {
+        let n = GraphView::node_count(graph);
+        let mut out_offsets = Vec::with_capacity(n + 1);
+        let mut out_targets = Vec::with_capacity(graph.edge_count());
+        let mut in_counts = vec![0u32; n + 1];
+
+        out_offsets.push(0);
+        for v in 0..n {
+            for w in GraphView::successors(graph, NodeIndex::new(v)) {
+                out_targets.push(w.index() as u32);
+                in_counts[w.index() + 1] += 1;
+            }
+            out_offsets.push(out_targets.len() as u32);
+        }
+
+        // Counting sort of edges by target for the reverse direction
+        for v in 0..n {
+            in_counts[v + 1] += in_counts[v];
+        }
+        let in_offsets = in_counts.clone();
+        let mut cursor = in_counts;
+        let mut in_sources = vec![0u32; out_targets.len()];
+        for v in 0..n {
+            for &w in &out_targets[out_offsets[v] as usize..out_offsets[v + 1] as usize] {
+                in_sources[cursor[w as usize] as usize] = v as u32;
+                cursor[w as usize] += 1;
+            }
+        }
+
+        let versions = (0..n).map(|v| graph.version(NodeIndex::new(v)).cloned()).collect();
+
+        Self {
+            out_offsets,
+            out_targets,
+            in_offsets,
+            in_sources,
+            symbols: graph.symbols().clone(),
+            versions,
+            heuristic_scale: graph.heuristic_scale(),
+            degree_imbalance: graph.degree_imbalance(),
+            edge_components: graph.edge_components(),
+            generation: graph.generation(),
+            edge_log: graph.edge_log().to_vec(),
+        }
+    }
+
+    /// Number of edges in the snapshot
+    pub fn edge_count(&self) -> usize {
+        self.out_targets.len()
+    }
+
+    fn slice<'a>(offsets: &[u32], values: &'a [u32], idx: NodeIndex) -> IndexIter<'a> {
+        let v = idx.index();
+        let to_index: fn(&u32) -> NodeIndex = |&w| NodeIndex::new(w as usize);
+        values[offsets[v] as usize..offsets[v + 1] as usize].iter().map(to_index)
+    }
+}
+
+impl GraphView for FrozenGraph {
+    type Successors<'a> = IndexIter<'a>;
+    type Predecessors<'a> = IndexIter<'a>;
+
+    fn node_count(&self) -> usize {
+        self.versions.len()
+    }
+
+    fn symbols(&self) -> &Interner {
+        &self.symbols
+    }
+
+    fn version(&self, idx: NodeIndex) -> Option<&SemVerX> {
+        self.versions.get(idx.index()).and_then(Option::as_ref)
+    }
+
+    fn successors(&self, idx: NodeIndex) -> Self::Successors<'_> {
+        Self::slice(&self.out_offsets, &self.out_targets, idx)
+    }
+
+    fn predecessors(&self, idx: NodeIndex) -> Self::Predecessors<'_> {
+        Self::slice(&self.in_offsets, &self.in_sources, idx)
+    }
+
+    fn heuristic_scale(&self) -> f64 {
+        self.heuristic_scale
+    }
+
+    fn degree_imbalance(&self) -> usize {
+        self.degree_imbalance
+    }
+
+    fn edge_components(&self) -> usize {
+        self.edge_components
+    }
+
+    fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    fn edge_log(&self) -> &[(u64, NodeIndex)] {
+        &self.edge_log
+    }
+}
+
+/// Publication point for the current snapshot
+///
+/// The writer freezes a new snapshot and `store`s it with one atomic
+/// pointer swap, as `SharedRegistry` does for registry snapshots.
+/// Readers never take a lock, and resolutions already running keep
+/// their old snapshot alive until they finish.
+#[derive(Debug)]
+pub struct SnapshotSlot {
+    current: ArcSwap<FrozenGraph>,
+}
+
+impl SnapshotSlot {
+    /// Publication point starting at `initial`
+    pub fn new(initial: Arc<FrozenGraph>) -> Self {
+        Self { current: ArcSwap::new(initial) }
+    }
+
+    /// The latest published snapshot
+    ///
+    /// Lock-free: one atomic load plus a reference-count increment.
+    pub fn load(&self) -> Arc<FrozenGraph> {
+        self.current.load_full()
+    }
+
+    /// Publish `next`, returning the snapshot it replaces
+    pub fn store(&self, next: Arc<FrozenGraph>) -> Arc<FrozenGraph> {
+        self.current.swap(next)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::strategies::{astar_resolve, is_eulerian, resolve_batch};
+    use crate::resolver::types::NodeId;
+
+    fn sample() -> (DependencyGraph, Vec<NodeId>) {
+        let mut graph = DependencyGraph::new();
+        let ids: Vec<NodeId> = ["1.0.0", "1.1.0", "1.2.0", "2.0.0"]
+            .iter()
+            .map(|s| graph.add_node(s.to_string()))
+            .collect();
+        graph.add_edge(&ids[0], &ids[1]);
+        graph.add_edge(&ids[0], &ids[2]);
+        graph.add_edge(&ids[1], &ids[3]);
+        graph.add_edge(&ids[2], &ids[3]);
+        (graph, ids)
+    }
+
+    #[test]
+    fn test_csr_matches_source_graph() {
+        let (graph, _) = sample();
+        let frozen = graph.freeze();
+
+        assert_eq!(frozen.node_count(), 4);
+        assert_eq!(frozen.edge_count(), 4);
+        for v in 0..4 {
+            let idx = NodeIndex::new(v);
+            let expected: Vec<_> = GraphView::successors(&graph, idx).collect();
+            assert_eq!(frozen.successors(idx).collect::<Vec<_>>(), expected);
+
+            let mut expected: Vec<_> = GraphView::predecessors(&graph, idx).collect();
+            let mut actual: Vec<_> = frozen.predecessors(idx).collect();
+            expected.sort();
+            actual.sort();
+            assert_eq!(actual, expected);
+        }
+    }
+
+    #[test]
+    fn test_strategies_run_on_snapshot() {
+        let (graph, ids) = sample();
+        let frozen = graph.freeze();
+
+        let live = astar_resolve(&graph, ids[0].clone(), ids[3].clone()).unwrap();
+        let snap = astar_resolve(&*frozen, ids[0].clone(), ids[3].clone()).unwrap();
+        assert_eq!(live, snap);
+        assert_eq!(is_eulerian(&graph), is_eulerian(&*frozen));
+
+        let batch = resolve_batch(&*frozen, &ids[..1], ids[3].clone()).unwrap();
+        assert_eq!(batch[0].as_ref().unwrap().cost, 2.0);
+    }
+
+    #[test]
+    fn test_snapshot_slot_swap_keeps_old_readers() {
+        let (mut graph, ids) = sample();
+        let slot = SnapshotSlot::new(graph.freeze());
+        let reader = slot.load();
+
+        graph.add_edge(&ids[0], &ids[3]);
+        let previous = slot.store(graph.freeze());
+
+        assert!(Arc::ptr_eq(&previous, &reader));
+        assert_eq!(reader.edge_count(), 4);
+        assert_eq!(slot.load().edge_count(), 5);
+    }
+}
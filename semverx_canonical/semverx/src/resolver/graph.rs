@@ -0,0 +1,483 @@
+// src/resolver/graph.rs
+// Dependency graph for DAG resolution
+// Nodes carry their SemVerX tuple, parsed once at insertion time
+
+use petgraph::graph::{Edge, Graph, Neighbors, NodeIndex};
+use petgraph::{Directed, Direction};
+use std::sync::Arc;
+
+use crate::registry::{filter_satisfying, VersionReq};
+use crate::{PackedVersion, SemVerX};
+use super::frozen::FrozenGraph;
+use super::intern::{Interner, Symbol};
+use super::types::NodeId;
+
+/// Read-only graph interface the resolution strategies run on
+///
+/// Implemented by the mutable `DependencyGraph` and by its frozen CSR
+/// snapshot. Node indices are dense `0..node_count()` and identical
+/// between a graph and every snapshot taken from it; they coincide with
+/// the symbols of the graph's id arena.
+pub trait GraphView {
+    /// Iterator over the targets of a node's outgoing edges
+    type Successors<'a>: Iterator<Item = NodeIndex>
+    where
+        Self: 'a;
+    /// Iterator over the sources of a node's incoming edges
+    type Predecessors<'a>: Iterator<Item = NodeIndex>
+    where
+        Self: 'a;
+
+    /// Number of nodes; indices run `0..node_count()`
+    fn node_count(&self) -> usize;
+    /// Arena of node ids; symbol `i` names node index `i`
+    fn symbols(&self) -> &Interner;
+    /// Parsed version of a node, if its id carries one
+    fn version(&self, idx: NodeIndex) -> Option<&SemVerX>;
+    /// Targets of `idx`'s outgoing edges
+    fn successors(&self, idx: NodeIndex) -> Self::Successors<'_>;
+    /// Sources of `idx`'s incoming edges
+    fn predecessors(&self, idx: NodeIndex) -> Self::Predecessors<'_>;
+
+    /// See `DependencyGraph::heuristic_scale`
+    fn heuristic_scale(&self) -> f64;
+    /// See `DependencyGraph::degree_imbalance`
+    fn degree_imbalance(&self) -> usize;
+    /// See `DependencyGraph::edge_components`
+    fn edge_components(&self) -> usize;
+    /// See `DependencyGraph::generation`
+    fn generation(&self) -> u64;
+    /// `(generation, source)` of every edge, in insertion order
+    fn edge_log(&self) -> &[(u64, NodeIndex)];
+
+    /// String edge: O(1) average lookup of a node's index
+    fn find_node(&self, id: &str) -> Option<NodeIndex> {
+        self.symbols().get(id).map(NodeIndex::from)
+    }
+
+    /// String edge: the id a node was inserted under
+    fn node_id(&self, idx: NodeIndex) -> &str {
+        self.symbols().resolve(idx.into())
+    }
+
+    /// Log entries of the edges added after generation `since`
+    ///
+    /// A new edge `u -> v` can only change resolutions that reach `u`.
+    fn edges_since(&self, since: u64) -> &[(u64, NodeIndex)] {
+        let log = self.edge_log();
+        &log[log.partition_point(|&(generation, _)| generation <= since)..]
+    }
+}
+
+/// Directed dependency graph keyed by `NodeId`
+///
+/// Ids are interned once on `add_node`; the petgraph nodes only carry
+/// their `Symbol`, and every strategy works on indices until it hands a
+/// result back across the string API.
+///
+/// Alongside the petgraph storage it keeps dense per-node vectors that
+/// are maintained incrementally on `add_node` / `add_edge`:
+/// - parsed versions plus the widest version span of a single edge,
+///   which together bound the A* heuristic
+/// - packed keys of the versioned nodes, for bulk range selection
+/// - in/out degrees and the count of imbalanced nodes
+/// - a union-find over nodes with edges, counting their weak components
+/// - a generation counter plus a log of edge sources per generation,
+///   which lets caches tell whether a change touches their subgraph
+#[derive(Debug, Clone, Default)]
+pub struct DependencyGraph {
+    graph: Graph<Symbol, (), Directed>,
+    symbols: Interner,
+    versions: Vec<Option<SemVerX>>,
+    packed: Vec<PackedVersion>,
+    packed_nodes: Vec<u32>,
+    max_edge_span: u64,
+    unversioned_edges: usize,
+    in_degree: Vec<u32>,
+    out_degree: Vec<u32>,
+    imbalanced: usize,
+    components: DisjointSet,
+    edge_components: usize,
+    generation: u64,
+    edge_log: Vec<(u64, NodeIndex)>,
+}
+
+impl DependencyGraph {
+    /// Empty graph
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Insert a node (idempotent) and return its id
+    ///
+    /// The version is parsed from the id here, so resolution never has
+    /// to touch the string again.
+    pub fn add_node(&mut self, id: NodeId) -> NodeId {
+        self.add_symbol(&id);
+        id
+    }
+
+    /// Insert a node (idempotent) and return its interned handle
+    pub fn add_symbol(&mut self, id: &str) -> Symbol {
+        if let Some(sym) = self.symbols.get(id) {
+            return sym;
+        }
+        let sym = self.symbols.intern(id);
+        let idx = self.graph.add_node(sym);
+        let version = parse_node_version(id);
+        if let Some(version) = &version {
+            self.packed.push(version.pack());
+            self.packed_nodes.push(idx.index() as u32);
+        }
+        self.versions.push(version);
+        self.in_degree.push(0);
+        self.out_degree.push(0);
+        self.components.push();
+        self.generation += 1;
+        sym
+    }
+
+    /// Insert a dependency edge `from -> to`
+    ///
+    /// Returns false if either endpoint is unknown.
+    pub fn add_edge(&mut self, from: &str, to: &str) -> bool {
+        match (self.symbols.get(from), self.symbols.get(to)) {
+            (Some(a), Some(b)) => self.add_edge_symbols(a, b),
+            _ => false,
+        }
+    }
+
+    /// Insert a dependency edge between interned nodes, no string hashing
+    ///
+    /// Returns false if either handle is not a node of this graph.
+    pub fn add_edge_symbols(&mut self, from: Symbol, to: Symbol) -> bool {
+        let count = self.symbols.len();
+        if from.index() >= count || to.index() >= count {
+            return false;
+        }
+        let (from_idx, to_idx) = (NodeIndex::from(from), NodeIndex::from(to));
+
+        match (self.version(from_idx), self.version(to_idx)) {
+            (Some(a), Some(b)) => {
+                self.max_edge_span = self.max_edge_span.max(version_distance(a, b));
+            }
+            _ => self.unversioned_edges += 1,
+        }
+
+        let (from_slot, to_slot) = (from_idx.index(), to_idx.index());
+        let was_balanced = self.is_balanced(from_slot) as usize + self.is_balanced(to_slot) as usize;
+
+        // Isolated endpoints join the edge-carrying set as new components
+        if self.degree(from_slot) == 0 {
+            self.edge_components += 1;
+        }
+        if self.degree(to_slot) == 0 && to_slot != from_slot {
+            self.edge_components += 1;
+        }
+
+        self.out_degree[from_slot] += 1;
+        self.in_degree[to_slot] += 1;
+
+        let now_balanced = self.is_balanced(from_slot) as usize + self.is_balanced(to_slot) as usize;
+        self.imbalanced = self.imbalanced + was_balanced - now_balanced;
+
+        if self.components.union(from_slot, to_slot) {
+            self.edge_components -= 1;
+        }
+
+        self.graph.add_edge(from_idx, to_idx, ());
+        self.generation += 1;
+        self.edge_log.push((self.generation, from_idx));
+        true
+    }
+
+    /// Versioned nodes satisfying `req`, in insertion order
+    ///
+    /// One pass of the packed `filter_satisfying` kernel over every
+    /// versioned node; unversioned nodes never match.
+    pub fn select(&self, req: &VersionReq) -> Vec<NodeIndex> {
+        filter_satisfying(&self.packed, req)
+            .into_iter()
+            .map(|i| NodeIndex::new(self.packed_nodes[i] as usize))
+            .collect()
+    }
+
+    /// O(1) average lookup of a node's index
+    pub fn find_node(&self, id: &str) -> Option<NodeIndex> {
+        self.symbols.get(id).map(NodeIndex::from)
+    }
+
+    /// Interned handle of a node id
+    pub fn symbol(&self, id: &str) -> Option<Symbol> {
+        self.symbols.get(id)
+    }
+
+    /// Parsed version of a node, if its id carries one
+    pub fn version(&self, idx: NodeIndex) -> Option<&SemVerX> {
+        self.versions.get(idx.index()).and_then(Option::as_ref)
+    }
+
+    /// Number of dependency edges, O(1)
+    pub fn edge_count(&self) -> usize {
+        self.graph.edge_count()
+    }
+
+    /// Every dependency edge, in insertion order
+    pub fn raw_edges(&self) -> &[Edge<()>] {
+        self.graph.raw_edges()
+    }
+
+    /// Monotonic mutation counter, bumped by every `add_node` / `add_edge`
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Number of incoming edges of a node
+    pub fn in_degree(&self, idx: NodeIndex) -> u32 {
+        self.in_degree[idx.index()]
+    }
+
+    /// Number of outgoing edges of a node
+    pub fn out_degree(&self, idx: NodeIndex) -> u32 {
+        self.out_degree[idx.index()]
+    }
+
+    /// Count of nodes whose in-degree differs from their out-degree, O(1)
+    pub fn degree_imbalance(&self) -> usize {
+        self.imbalanced
+    }
+
+    /// Weakly connected components among nodes with at least one edge, O(1)
+    ///
+    /// When `degree_imbalance() == 0` every weak component is also
+    /// strongly connected, so this doubles as the SCC count the
+    /// Eulerian check needs.
+    pub fn edge_components(&self) -> usize {
+        self.edge_components
+    }
+
+    fn degree(&self, slot: usize) -> u32 {
+        self.in_degree[slot] + self.out_degree[slot]
+    }
+
+    fn is_balanced(&self, slot: usize) -> bool {
+        self.in_degree[slot] == self.out_degree[slot]
+    }
+
+    /// Factor turning version distance into a lower bound on edge hops
+    ///
+    /// Every edge spans at most `max_edge_span` of version distance and
+    /// the distance obeys the triangle inequality, so
+    /// `distance * scale <= hops` and the heuristic stays admissible
+    /// (and consistent) under unit edge costs. Edges touching unversioned
+    /// nodes break that bound, so the scale drops to 0 (plain Dijkstra).
+    pub fn heuristic_scale(&self) -> f64 {
+        if self.unversioned_edges > 0 || self.max_edge_span == 0 {
+            0.0
+        } else {
+            1.0 / self.max_edge_span as f64
+        }
+    }
+}
+
+impl DependencyGraph {
+    /// Immutable CSR snapshot for read-heavy resolution
+    ///
+    /// O(V + E). The writer keeps mutating `self`; readers share the
+    /// snapshot through the `Arc` (see `frozen::SnapshotSlot`).
+    pub fn freeze(&self) -> Arc<FrozenGraph> {
+        Arc::new(FrozenGraph::from_graph(self))
+    }
+}
+
+impl GraphView for DependencyGraph {
+    type Successors<'a> = Neighbors<'a, ()>;
+    type Predecessors<'a> = Neighbors<'a, ()>;
+
+    fn node_count(&self) -> usize {
+        self.graph.node_count()
+    }
+
+    fn symbols(&self) -> &Interner {
+        &self.symbols
+    }
+
+    fn version(&self, idx: NodeIndex) -> Option<&SemVerX> {
+        DependencyGraph::version(self, idx)
+    }
+
+    fn successors(&self, idx: NodeIndex) -> Self::Successors<'_> {
+        self.graph.neighbors(idx)
+    }
+
+    fn predecessors(&self, idx: NodeIndex) -> Self::Predecessors<'_> {
+        self.graph.neighbors_directed(idx, Direction::Incoming)
+    }
+
+    fn heuristic_scale(&self) -> f64 {
+        DependencyGraph::heuristic_scale(self)
+    }
+
+    fn degree_imbalance(&self) -> usize {
+        self.imbalanced
+    }
+
+    fn edge_components(&self) -> usize {
+        self.edge_components
+    }
+
+    fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    fn edge_log(&self) -> &[(u64, NodeIndex)] {
+        &self.edge_log
+    }
+}
+
+/// Union-find with path halving and union by size
+#[derive(Debug, Clone, Default)]
+struct DisjointSet {
+    parent: Vec<u32>,
+    size: Vec<u32>,
+}
+
+impl DisjointSet {
+    fn push(&mut self) {
+        self.parent.push(self.parent.len() as u32);
+        self.size.push(1);
+    }
+
+    fn find(&mut self, mut x: usize) -> usize {
+        while self.parent[x] as usize != x {
+            let grandparent = self.parent[self.parent[x] as usize];
+            self.parent[x] = grandparent;
+            x = grandparent as usize;
+        }
+        x
+    }
+
+    /// Merge the sets of `a` and `b`; returns false if already merged
+    fn union(&mut self, a: usize, b: usize) -> bool {
+        let (mut ra, mut rb) = (self.find(a), self.find(b));
+        if ra == rb {
+            return false;
+        }
+        if self.size[ra] < self.size[rb] {
+            std::mem::swap(&mut ra, &mut rb);
+        }
+        self.parent[rb] = ra as u32;
+        self.size[ra] += self.size[rb];
+        true
+    }
+}
+
+/// Extract the SemVerX tuple from `name@x.y.z(channel)` or `x.y.z(channel)`
+fn parse_node_version(id: &str) -> Option<SemVerX> {
+    let version = id.rsplit('@').next().unwrap_or(id);
+    SemVerX::parse(version)
+}
+
+/// Weighted version distance
+///
+/// d = |major_diff| * 100 + |minor_diff| * 10 + |patch_diff|
+///
+/// A weighted L1 metric, computed branch-free with `abs_diff`.
+pub fn version_distance(a: &SemVerX, b: &SemVerX) -> u64 {
+    a.major.abs_diff(b.major) as u64 * 100
+        + a.minor.abs_diff(b.minor) as u64 * 10
+        + a.patch.abs_diff(b.patch) as u64
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::Channel;
+
+    #[test]
+    fn test_versions_parsed_at_insertion() {
+        let mut graph = DependencyGraph::new();
+
+        let a = graph.add_node("core@1.2.3(experimental)".to_string());
+        let b = graph.add_node("2.0.0".to_string());
+        let c = graph.add_node("A".to_string());
+
+        let va = graph.version(graph.find_node(&a).unwrap()).unwrap();
+        assert_eq!((va.major, va.minor, va.patch), (1, 2, 3));
+        assert_eq!(va.channel, Channel::Experimental);
+
+        let vb = graph.version(graph.find_node(&b).unwrap()).unwrap();
+        assert_eq!(vb.channel, Channel::Stable);
+
+        assert!(graph.version(graph.find_node(&c).unwrap()).is_none());
+    }
+
+    #[test]
+    fn test_select_by_range() {
+        let mut graph = DependencyGraph::new();
+        let ids: Vec<NodeId> = ["core@1.2.3", "X", "core@1.9.0(lts)", "core@2.0.0", "cli@1.4.0"]
+            .iter()
+            .map(|s| graph.add_node(s.to_string()))
+            .collect();
+
+        let names = |req: &str| -> Vec<&str> {
+            let req = VersionReq::parse(req).unwrap();
+            graph.select(&req).into_iter().map(|idx| graph.node_id(idx)).collect()
+        };
+        assert_eq!(names("^1.2"), vec![&ids[0][..], &ids[2][..], &ids[4][..]]);
+        assert_eq!(names("^1(lts)"), vec![&ids[2][..]]);
+        assert_eq!(names("*").len(), 4);
+    }
+
+    #[test]
+    fn test_heuristic_scale_tracks_edge_span() {
+        let mut graph = DependencyGraph::new();
+
+        let a = graph.add_node("1.0.0".to_string());
+        let b = graph.add_node("1.1.0".to_string());
+        let c = graph.add_node("2.1.0".to_string());
+
+        assert!(graph.add_edge(&a, &b));
+        assert_eq!(graph.heuristic_scale(), 1.0 / 10.0);
+
+        graph.add_edge(&b, &c);
+        assert_eq!(graph.heuristic_scale(), 1.0 / 100.0);
+
+        // Unversioned endpoint disables the bound
+        let x = graph.add_node("X".to_string());
+        graph.add_edge(&c, &x);
+        assert_eq!(graph.heuristic_scale(), 0.0);
+
+        assert!(!graph.add_edge(&a, "missing"));
+    }
+
+    #[test]
+    fn test_degree_and_component_caches() {
+        let mut graph = DependencyGraph::new();
+
+        let ids: Vec<NodeId> = ["a", "b", "c", "d", "e"]
+            .iter()
+            .map(|s| graph.add_node(s.to_string()))
+            .collect();
+        assert_eq!((graph.degree_imbalance(), graph.edge_components()), (0, 0));
+
+        graph.add_edge(&ids[0], &ids[1]);
+        assert_eq!((graph.degree_imbalance(), graph.edge_components()), (2, 1));
+
+        graph.add_edge(&ids[1], &ids[0]);
+        assert_eq!((graph.degree_imbalance(), graph.edge_components()), (0, 1));
+
+        // Separate self-loop component
+        graph.add_edge(&ids[2], &ids[2]);
+        assert_eq!((graph.degree_imbalance(), graph.edge_components()), (0, 2));
+
+        // Bridge the two components with a 2-cycle through d
+        graph.add_edge(&ids[1], &ids[3]);
+        graph.add_edge(&ids[3], &ids[2]);
+        graph.add_edge(&ids[2], &ids[1]);
+        assert_eq!((graph.degree_imbalance(), graph.edge_components()), (0, 1));
+
+        let b = graph.find_node(&ids[1]).unwrap();
+        assert_eq!((graph.in_degree(b), graph.out_degree(b)), (2, 2));
+    }
+}
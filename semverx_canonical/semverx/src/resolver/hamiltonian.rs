@@ -0,0 +1,530 @@
+// src/resolver/hamiltonian.rs
+// Hamiltonian path engine
+// Bitset backtracking for large components, Held-Karp DP for small ones
+
+use petgraph::graph::NodeIndex;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::thread;
+use std::time::Instant;
+
+use super::bitset::BitSet;
+use super::graph::GraphView;
+
+/// Largest component solved by Held-Karp bitmask DP
+///
+/// The DP table is `2^n` u32 words: 4 MiB at n = 20.
+pub const HELD_KARP_MAX_NODES: usize = 20;
+
+/// Search steps between two deadline checks
+const DEADLINE_CHECK_INTERVAL: u32 = 1024;
+
+/// Sentinel for "not in component" in the global -> local map
+const NOT_IN_COMPONENT: u32 = u32::MAX;
+
+/// Induced subgraph with dense local indices `0..nodes.len()`
+#[derive(Debug, Clone)]
+pub struct Component {
+    /// Local index -> graph index
+    pub nodes: Vec<NodeIndex>,
+    /// Local adjacency lists (targets are local indices)
+    adj: Vec<Vec<u32>>,
+}
+
+impl Component {
+    /// The whole graph as one component
+    pub fn whole<G: GraphView>(graph: &G) -> Self {
+        let nodes: Vec<NodeIndex> = (0..graph.node_count()).map(NodeIndex::new).collect();
+        Self::induced(graph, nodes)
+    }
+
+    /// Strongly connected component containing `root`
+    ///
+    /// Forward reachability intersected with backward reachability,
+    /// O(V + E) over the part of the graph reachable from `root`.
+    pub fn strongly_connected<G: GraphView>(graph: &G, root: NodeIndex) -> Self {
+        let mut forward = BitSet::new(graph.node_count());
+        let mut stack = vec![root];
+        forward.insert(root.index() as u32);
+
+        while let Some(node) = stack.pop() {
+            for neighbor in graph.successors(node) {
+                if !forward.contains(neighbor.index() as u32) {
+                    forward.insert(neighbor.index() as u32);
+                    stack.push(neighbor);
+                }
+            }
+        }
+
+        let mut backward = BitSet::new(graph.node_count());
+        let mut nodes = vec![root];
+        stack.push(root);
+        backward.insert(root.index() as u32);
+
+        while let Some(node) = stack.pop() {
+            for neighbor in graph.predecessors(node) {
+                let bit = neighbor.index() as u32;
+                if forward.contains(bit) && !backward.contains(bit) {
+                    backward.insert(bit);
+                    nodes.push(neighbor);
+                    stack.push(neighbor);
+                }
+            }
+        }
+
+        Self::induced(graph, nodes)
+    }
+
+    fn induced<G: GraphView>(graph: &G, nodes: Vec<NodeIndex>) -> Self {
+        let mut local = vec![NOT_IN_COMPONENT; graph.node_count()];
+        for (i, node) in nodes.iter().enumerate() {
+            local[node.index()] = i as u32;
+        }
+
+        let adj = nodes
+            .iter()
+            .map(|&node| {
+                graph
+                    .successors(node)
+                    .map(|n| local[n.index()])
+                    .filter(|&l| l != NOT_IN_COMPONENT)
+                    .collect()
+            })
+            .collect();
+
+        Self { nodes, adj }
+    }
+
+    /// Number of nodes in the component
+    pub fn len(&self) -> usize {
+        self.nodes.len()
+    }
+
+    /// True for a component without nodes
+    pub fn is_empty(&self) -> bool {
+        self.nodes.is_empty()
+    }
+
+    /// Local index of a graph node, if it belongs to this component
+    pub fn local(&self, node: NodeIndex) -> Option<u32> {
+        self.nodes.iter().position(|&n| n == node).map(|i| i as u32)
+    }
+
+    /// Map a local path back to graph indices
+    pub fn to_graph_path(&self, path: &[u32]) -> Vec<NodeIndex> {
+        path.iter().map(|&l| self.nodes[l as usize]).collect()
+    }
+}
+
+/// Outcome of a bounded search
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum Search {
+    /// Hamiltonian path as local indices
+    Found(Vec<u32>),
+    /// No Hamiltonian path exists
+    Exhausted,
+    /// Deadline passed before the search finished
+    TimedOut,
+}
+
+/// Find a Hamiltonian path of `comp`, optionally pinned at either end
+///
+/// Dispatches to Held-Karp for components of at most
+/// `HELD_KARP_MAX_NODES` nodes, bitset backtracking otherwise.
+pub fn search(comp: &Component, start: Option<u32>, goal: Option<u32>, deadline: Instant) -> Search {
+    let n = comp.len();
+    if n == 0 {
+        return Search::Found(vec![]);
+    }
+    if n == 1 {
+        return Search::Found(vec![0]);
+    }
+
+    let starts = match candidate_starts(comp, start, goal) {
+        Some(starts) => starts,
+        None => return Search::Exhausted,
+    };
+
+    if n <= HELD_KARP_MAX_NODES {
+        held_karp(comp, &starts, goal, deadline)
+    } else {
+        let never = AtomicBool::new(false);
+        let mut steps = 0;
+        for &s in &starts {
+            match backtrack(comp, &[s], goal, deadline, &never, &mut steps) {
+                Search::Exhausted => continue,
+                outcome => return outcome,
+            }
+        }
+        Search::Exhausted
+    }
+}
+
+/// Parallel variant of `search` over `threads` workers
+///
+/// Work items are two-node prefixes `(start, first hop)`, so both the
+/// start nodes and the first level of each DFS tree are spread across
+/// threads. Workers claim items through an atomic cursor; the first one
+/// to find a path raises a shared flag that cancels the rest at their
+/// next amortized deadline check. Small components still go to the
+/// (single-threaded, already fast) Held-Karp DP.
+pub fn search_parallel(
+    comp: &Component,
+    start: Option<u32>,
+    goal: Option<u32>,
+    deadline: Instant,
+    threads: usize,
+) -> Search {
+    let n = comp.len();
+    if n <= HELD_KARP_MAX_NODES || threads <= 1 {
+        return search(comp, start, goal, deadline);
+    }
+
+    let starts = match candidate_starts(comp, start, goal) {
+        Some(starts) => starts,
+        None => return Search::Exhausted,
+    };
+
+    let prefixes: Vec<[u32; 2]> = starts
+        .iter()
+        .flat_map(|&s| comp.adj[s as usize].iter().map(move |&w| [s, w]))
+        .filter(|&[s, w]| s != w && goal != Some(w))
+        .collect();
+
+    let next = AtomicUsize::new(0);
+    let cancel = AtomicBool::new(false);
+    let timed_out = AtomicBool::new(false);
+    let found: Mutex<Option<Vec<u32>>> = Mutex::new(None);
+
+    thread::scope(|scope| {
+        for _ in 0..threads.min(prefixes.len()) {
+            scope.spawn(|| {
+                let mut steps = 0;
+                while !cancel.load(Ordering::Relaxed) {
+                    let i = next.fetch_add(1, Ordering::Relaxed);
+                    let prefix = match prefixes.get(i) {
+                        Some(prefix) => prefix,
+                        None => break,
+                    };
+
+                    match backtrack(comp, prefix, goal, deadline, &cancel, &mut steps) {
+                        Search::Found(path) => {
+                            cancel.store(true, Ordering::Relaxed);
+                            found.lock().unwrap().get_or_insert(path);
+                        }
+                        Search::TimedOut => {
+                            timed_out.store(true, Ordering::Relaxed);
+                            cancel.store(true, Ordering::Relaxed);
+                        }
+                        Search::Exhausted => {}
+                    }
+                }
+            });
+        }
+    });
+
+    match found.into_inner().unwrap() {
+        Some(path) => Search::Found(path),
+        None if timed_out.into_inner() => Search::TimedOut,
+        None => Search::Exhausted,
+    }
+}
+
+/// Start nodes worth trying, or None if no Hamiltonian path can exist
+///
+/// A Hamiltonian path has at most one source (in-degree 0) and one sink
+/// (out-degree 0), and a source can only be its first node.
+pub fn candidate_starts(comp: &Component, start: Option<u32>, goal: Option<u32>) -> Option<Vec<u32>> {
+    let n = comp.len();
+    let mut in_degree = vec![0u32; n];
+    for targets in &comp.adj {
+        for &t in targets {
+            in_degree[t as usize] += 1;
+        }
+    }
+
+    let mut sources = (0..n as u32).filter(|&v| in_degree[v as usize] == 0);
+    let source = sources.next();
+    if sources.next().is_some() {
+        return None;
+    }
+
+    let sinks = comp.adj.iter().filter(|targets| targets.is_empty()).count();
+    if sinks > 1 {
+        return None;
+    }
+
+    match (source, start) {
+        (Some(src), Some(s)) if src != s => None,
+        (Some(src), _) => Some(vec![src]),
+        (None, Some(s)) => Some(vec![s]),
+        (None, None) => Some((0..n as u32).filter(|&v| Some(v) != goal).collect()),
+    }
+}
+
+/// Held-Karp bitmask DP
+///
+/// `ends[mask]` holds the set of nodes `v` such that some path visits
+/// exactly `mask` and ends at `v`. Every start is seeded at once, so no
+/// per-start restart. O(2^n * n) words of work, O(2^n) memory.
+fn held_karp(comp: &Component, starts: &[u32], goal: Option<u32>, deadline: Instant) -> Search {
+    let n = comp.len();
+    let full = (1u32 << n) - 1;
+    let out: Vec<u32> = comp
+        .adj
+        .iter()
+        .map(|targets| targets.iter().fold(0u32, |m, &t| m | 1 << t))
+        .collect();
+    let mut inc = vec![0u32; n];
+    for (u, &targets) in out.iter().enumerate() {
+        let mut rest = targets;
+        while rest != 0 {
+            inc[rest.trailing_zeros() as usize] |= 1 << u;
+            rest &= rest - 1;
+        }
+    }
+    let goal_bit = goal.map_or(0, |g| 1u32 << g);
+    let goal_mask = goal.map_or(full, |g| 1u32 << g);
+
+    let mut ends = vec![0u32; 1 << n];
+    for &s in starts {
+        ends[1 << s] |= 1 << s;
+    }
+
+    for mask in 1..=full {
+        if mask % DEADLINE_CHECK_INTERVAL == 0 && Instant::now() > deadline {
+            return Search::TimedOut;
+        }
+
+        let mut tails = ends[mask as usize];
+        // The goal may only close the path
+        if mask != full {
+            tails &= !goal_bit;
+        }
+        while tails != 0 {
+            let v = tails.trailing_zeros();
+            tails &= tails - 1;
+
+            let mut next = out[v as usize] & !mask;
+            while next != 0 {
+                let w = next.trailing_zeros();
+                next &= next - 1;
+                ends[(mask | 1 << w) as usize] |= 1 << w;
+            }
+        }
+    }
+
+    let finals = ends[full as usize] & goal_mask;
+    if finals == 0 {
+        return Search::Exhausted;
+    }
+
+    // Walk the table backwards from any valid end
+    let mut path = Vec::with_capacity(n);
+    let mut mask = full;
+    let mut v = finals.trailing_zeros();
+    path.push(v);
+    while mask.count_ones() > 1 {
+        mask &= !(1 << v);
+        v = (ends[mask as usize] & inc[v as usize] & !goal_bit).trailing_zeros();
+        path.push(v);
+    }
+    path.reverse();
+
+    Search::Found(path)
+}
+
+/// Iterative bitset backtracking below a fixed prefix
+///
+/// Explicit cursor stack instead of recursion, so deep components cannot
+/// overflow the thread stack. The deadline and the `cancel` flag are
+/// checked every `DEADLINE_CHECK_INTERVAL` steps; `steps` carries across
+/// calls. The search never backtracks into `prefix` itself.
+fn backtrack(
+    comp: &Component,
+    prefix: &[u32],
+    goal: Option<u32>,
+    deadline: Instant,
+    cancel: &AtomicBool,
+    steps: &mut u32,
+) -> Search {
+    let n = comp.len();
+    let mut visited = BitSet::new(n);
+    let mut path = Vec::with_capacity(n);
+    let mut cursors: Vec<usize> = Vec::with_capacity(n);
+
+    for &v in prefix {
+        visited.insert(v);
+        path.push(v);
+        cursors.push(0);
+    }
+
+    while path.len() >= prefix.len() {
+        let v = *path.last().unwrap();
+        *steps = steps.wrapping_add(1);
+        if steps.is_multiple_of(DEADLINE_CHECK_INTERVAL) {
+            if Instant::now() > deadline {
+                return Search::TimedOut;
+            }
+            if cancel.load(Ordering::Relaxed) {
+                return Search::Exhausted;
+            }
+        }
+
+        if path.len() == n {
+            if goal.is_none_or(|g| g == v) {
+                return Search::Found(path);
+            }
+        } else {
+            let top = cursors.len() - 1;
+            let targets = &comp.adj[v as usize];
+            let mut advanced = false;
+
+            while cursors[top] < targets.len() {
+                let w = targets[cursors[top]];
+                cursors[top] += 1;
+
+                // The goal may only close the path
+                let goal_too_early = goal == Some(w) && path.len() + 1 < n;
+                if !visited.contains(w) && !goal_too_early {
+                    visited.insert(w);
+                    path.push(w);
+                    cursors.push(0);
+                    advanced = true;
+                    break;
+                }
+            }
+
+            if advanced {
+                continue;
+            }
+        }
+
+        // Backtrack
+        visited.remove(v);
+        path.pop();
+        cursors.pop();
+    }
+
+    Search::Exhausted
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::graph::DependencyGraph;
+    use std::time::Duration;
+
+    fn chain_with_back_edges(graph: &mut DependencyGraph, len: usize) -> Vec<String> {
+        let ids: Vec<String> = (0..len)
+            .map(|i| graph.add_node(format!("0.{}.0", i)))
+            .collect();
+        for i in 0..len - 1 {
+            graph.add_edge(&ids[i], &ids[i + 1]);
+            // Decoy edges force backtracking
+            if i >= 2 {
+                graph.add_edge(&ids[i], &ids[i - 2]);
+            }
+        }
+        ids
+    }
+
+    fn assert_hamiltonian(comp: &Component, path: &[u32]) {
+        assert_eq!(path.len(), comp.len());
+        let mut seen = BitSet::new(comp.len());
+        for pair in path.windows(2) {
+            assert!(comp.adj[pair[0] as usize].contains(&pair[1]), "missing edge");
+        }
+        for &v in path {
+            assert!(!seen.contains(v), "node visited twice");
+            seen.insert(v);
+        }
+    }
+
+    #[test]
+    fn test_held_karp_and_backtrack_agree() {
+        let deadline = Instant::now() + Duration::from_secs(5);
+
+        for len in [6, HELD_KARP_MAX_NODES + 6] {
+            let mut graph = DependencyGraph::new();
+            chain_with_back_edges(&mut graph, len);
+            let comp = Component::whole(&graph);
+
+            match search(&comp, None, None, deadline) {
+                Search::Found(path) => assert_hamiltonian(&comp, &path),
+                other => panic!("expected path for len {}, got {:?}", len, other),
+            }
+        }
+    }
+
+    #[test]
+    fn test_parallel_search_matches_serial() {
+        let deadline = Instant::now() + Duration::from_secs(5);
+
+        let mut graph = DependencyGraph::new();
+        let ids = chain_with_back_edges(&mut graph, HELD_KARP_MAX_NODES + 12);
+        // Close the ring so every node is a candidate start
+        graph.add_edge(ids.last().unwrap(), &ids[0]);
+        let comp = Component::whole(&graph);
+
+        match search_parallel(&comp, None, None, deadline, 4) {
+            Search::Found(path) => assert_hamiltonian(&comp, &path),
+            other => panic!("expected path, got {:?}", other),
+        }
+
+        let last = comp.len() as u32 - 1;
+        match search_parallel(&comp, Some(0), Some(last), deadline, 4) {
+            Search::Found(path) => {
+                assert_hamiltonian(&comp, &path);
+                assert_eq!((path[0], path[last as usize]), (0, last));
+            }
+            other => panic!("expected path, got {:?}", other),
+        }
+    }
+
+    #[test]
+    fn test_degree_prune_rejects_two_sources() {
+        let mut graph = DependencyGraph::new();
+        let a = graph.add_node("A".to_string());
+        let b = graph.add_node("B".to_string());
+        let c = graph.add_node("C".to_string());
+        graph.add_edge(&a, &c);
+        graph.add_edge(&b, &c);
+
+        let comp = Component::whole(&graph);
+        assert!(candidate_starts(&comp, None, None).is_none());
+        assert_eq!(search(&comp, None, None, Instant::now()), Search::Exhausted);
+    }
+
+    #[test]
+    fn test_strongly_connected_component_pins_endpoints() {
+        let mut graph = DependencyGraph::new();
+
+        // Ring a -> b -> c -> d -> a plus a tail d -> e outside the SCC
+        let ids: Vec<String> = ["a", "b", "c", "d", "e"]
+            .iter()
+            .map(|s| graph.add_node(s.to_string()))
+            .collect();
+        for i in 0..4 {
+            graph.add_edge(&ids[i], &ids[(i + 1) % 4]);
+        }
+        graph.add_edge(&ids[3], &ids[4]);
+
+        let root = graph.find_node(&ids[1]).unwrap();
+        let comp = Component::strongly_connected(&graph, root);
+        assert_eq!(comp.len(), 4);
+        assert!(comp.local(graph.find_node(&ids[4]).unwrap()).is_none());
+
+        let start = comp.local(root).unwrap();
+        let goal = comp.local(graph.find_node(&ids[0]).unwrap()).unwrap();
+        let deadline = Instant::now() + Duration::from_secs(1);
+
+        match search(&comp, Some(start), Some(goal), deadline) {
+            Search::Found(path) => {
+                assert_hamiltonian(&comp, &path);
+                assert_eq!((path[0], path[3]), (start, goal));
+            }
+            other => panic!("expected path, got {:?}", other),
+        }
+    }
+}
@@ -0,0 +1,371 @@
+// src/resolver/incremental.rs
+// Lifelong Planning A* (LPA*) resolver that survives graph growth
+// Search state is kept between runs; new edges only repair affected g-values
+
+use petgraph::graph::NodeIndex;
+use std::cmp::Ordering;
+use std::collections::BinaryHeap;
+
+use super::errors::ResolverError;
+use super::graph::GraphView;
+use super::intern::Symbol;
+use super::strategies::{heuristic, materialize};
+use super::types::{NodeId, Path, ResolutionStrategy, SymbolPath};
+
+/// LPA* priority `[min(g, rhs) + h; min(g, rhs)]`, compared lexicographically
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Key(f64, f64);
+
+impl Key {
+    fn less(self, other: Key) -> bool {
+        self.0 < other.0 || (self.0 == other.0 && self.1 < other.1)
+    }
+}
+
+/// Open-list entry; superseded entries are skipped when popped
+#[derive(Debug, Clone, Copy)]
+struct QueueEntry {
+    key: Key,
+    index: NodeIndex,
+}
+
+impl PartialEq for QueueEntry {
+    fn eq(&self, other: &Self) -> bool {
+        self.key == other.key
+    }
+}
+
+impl Eq for QueueEntry {}
+
+impl PartialOrd for QueueEntry {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for QueueEntry {
+    fn cmp(&self, other: &Self) -> Ordering {
+        // Reverse ordering for min-heap
+        other.key.0.partial_cmp(&self.key.0)
+            .unwrap_or(Ordering::Equal)
+            .then_with(|| other.key.1.partial_cmp(&self.key.1).unwrap_or(Ordering::Equal))
+    }
+}
+
+/// Incremental start -> goal resolver
+///
+/// Keeps LPA* state (`g`, one-step lookahead `rhs`, open list) for one
+/// endpoint pair across calls to `resolve`. Each call first catches up
+/// with the graph: nodes added since the last call get fresh entries,
+/// and for every edge in `GraphView::edges_since` the successors of its
+/// source are re-evaluated. Only vertices whose distance actually changed
+/// are expanded again, so a publish costs roughly O(change) instead of a
+/// full search.
+///
+/// The heuristic is the same scaled version distance A* uses. Its scale
+/// can only shrink as edges are added; `g` and `rhs` do not depend on it,
+/// so a shrink only re-keys the open list in one O(V) scan without
+/// expanding anything. Asking about an older snapshot than the last one
+/// seen restarts the search from scratch.
+///
+/// Returns the same cost as `astar_resolve`.
+#[derive(Debug, Clone)]
+pub struct IncrementalResolver {
+    start: NodeIndex,
+    goal: NodeIndex,
+    g: Vec<f64>,
+    rhs: Vec<f64>,
+    open: BinaryHeap<QueueEntry>,
+    scale: f64,
+    generation: u64,
+    primed: bool,
+    expanded: usize,
+}
+
+impl IncrementalResolver {
+    /// Resolver between two interned nodes of the graph it will be run on
+    pub fn new(start: Symbol, goal: Symbol) -> Self {
+        Self {
+            start: start.into(),
+            goal: goal.into(),
+            g: Vec::new(),
+            rhs: Vec::new(),
+            open: BinaryHeap::new(),
+            scale: 0.0,
+            generation: 0,
+            primed: false,
+            expanded: 0,
+        }
+    }
+
+    /// Resolver between two node ids of `graph`
+    pub fn between<G: GraphView>(
+        graph: &G,
+        start: &NodeId,
+        goal: &NodeId,
+    ) -> Result<Self, ResolverError> {
+        let symbols = graph.symbols();
+        let start_sym = symbols.get(start).ok_or_else(|| ResolverError::NodeNotFound(start.clone()))?;
+        let goal_sym = symbols.get(goal).ok_or_else(|| ResolverError::NodeNotFound(goal.clone()))?;
+        Ok(Self::new(start_sym, goal_sym))
+    }
+
+    /// Vertices expanded by the last `resolve`
+    pub fn expanded(&self) -> usize {
+        self.expanded
+    }
+
+    /// Bring the search up to date with `graph` and return the shortest path
+    ///
+    /// None if the goal is unreachable (or an endpoint is not a node of
+    /// `graph` yet).
+    pub fn resolve<G: GraphView>(&mut self, graph: &G) -> Option<SymbolPath> {
+        self.expanded = 0;
+        let node_count = graph.node_count();
+        if self.start.index() >= node_count || self.goal.index() >= node_count {
+            return None;
+        }
+
+        if !self.primed || graph.generation() < self.generation {
+            self.reset(graph);
+        } else if graph.generation() > self.generation {
+            self.catch_up(graph);
+            if graph.heuristic_scale() != self.scale {
+                self.rekey(graph);
+            }
+        }
+        self.generation = graph.generation();
+
+        self.compute_shortest_path(graph);
+        self.extract_path(graph)
+    }
+
+    /// `resolve` across the string API
+    pub fn resolve_path<G: GraphView>(&mut self, graph: &G) -> Result<Path, ResolverError> {
+        let node_count = graph.node_count();
+        match self.resolve(graph) {
+            Some(path) => Ok(materialize(graph, &path)),
+            None if self.start.index() >= node_count || self.goal.index() >= node_count => {
+                Err(ResolverError::ResolutionFailed {
+                    strategy: ResolutionStrategy::AStar,
+                    reason: "Endpoint not in this snapshot".to_string(),
+                })
+            }
+            None => Err(ResolverError::NoPathFound {
+                start: graph.node_id(self.start).to_owned(),
+                goal: graph.node_id(self.goal).to_owned(),
+            }),
+        }
+    }
+
+    fn reset<G: GraphView>(&mut self, graph: &G) {
+        let node_count = graph.node_count();
+        self.g = vec![f64::INFINITY; node_count];
+        self.rhs = vec![f64::INFINITY; node_count];
+        self.open.clear();
+        self.scale = graph.heuristic_scale();
+        self.primed = true;
+
+        self.rhs[self.start.index()] = 0.0;
+        let key = self.key(graph, self.start);
+        self.open.push(QueueEntry { key, index: self.start });
+    }
+
+    /// Replay the nodes and edges added since the last call
+    fn catch_up<G: GraphView>(&mut self, graph: &G) {
+        let node_count = graph.node_count();
+        self.g.resize(node_count, f64::INFINITY);
+        self.rhs.resize(node_count, f64::INFINITY);
+
+        let mut sources: Vec<NodeIndex> = graph
+            .edges_since(self.generation)
+            .iter()
+            .map(|&(_, source)| source)
+            .collect();
+        sources.sort_unstable();
+        sources.dedup();
+
+        // Edges only ever get added, so a new edge can only lower the
+        // lookahead of its target; an unreached source lowers nothing
+        for source in sources {
+            if self.g[source.index()].is_finite() {
+                for target in graph.successors(source) {
+                    self.lower_vertex(graph, target, source);
+                }
+            }
+        }
+    }
+
+    /// Rebuild the open list under the graph's current heuristic scale
+    fn rekey<G: GraphView>(&mut self, graph: &G) {
+        self.scale = graph.heuristic_scale();
+        self.open.clear();
+        for slot in 0..self.g.len() {
+            self.enqueue_if_inconsistent(graph, NodeIndex::new(slot));
+        }
+    }
+
+    fn key<G: GraphView>(&self, graph: &G, idx: NodeIndex) -> Key {
+        let best = self.g[idx.index()].min(self.rhs[idx.index()]);
+        Key(best + heuristic(graph, idx, graph.version(self.goal), self.scale), best)
+    }
+
+    /// Full LPA* UpdateVertex: recompute `rhs` from all predecessors
+    fn update_vertex<G: GraphView>(&mut self, graph: &G, idx: NodeIndex) {
+        let slot = idx.index();
+        if idx != self.start {
+            self.rhs[slot] = graph
+                .predecessors(idx)
+                .map(|pred| self.g[pred.index()] + 1.0)
+                .fold(f64::INFINITY, f64::min);
+        }
+        self.enqueue_if_inconsistent(graph, idx);
+    }
+
+    /// UpdateVertex specialised to `via` having become cheaper, O(1)
+    fn lower_vertex<G: GraphView>(&mut self, graph: &G, idx: NodeIndex, via: NodeIndex) {
+        let candidate = self.g[via.index()] + 1.0;
+        if idx != self.start && candidate < self.rhs[idx.index()] {
+            self.rhs[idx.index()] = candidate;
+            self.enqueue_if_inconsistent(graph, idx);
+        }
+    }
+
+    fn enqueue_if_inconsistent<G: GraphView>(&mut self, graph: &G, idx: NodeIndex) {
+        if self.g[idx.index()] != self.rhs[idx.index()] {
+            let key = self.key(graph, idx);
+            self.open.push(QueueEntry { key, index: idx });
+        }
+    }
+
+    /// Live head of the open list, dropping superseded entries on the way
+    fn top<G: GraphView>(&mut self, graph: &G) -> Option<QueueEntry> {
+        while let Some(&entry) = self.open.peek() {
+            let slot = entry.index.index();
+            if self.g[slot] != self.rhs[slot] && entry.key == self.key(graph, entry.index) {
+                return Some(entry);
+            }
+            self.open.pop();
+        }
+        None
+    }
+
+    fn compute_shortest_path<G: GraphView>(&mut self, graph: &G) {
+        let goal_slot = self.goal.index();
+        while let Some(entry) = self.top(graph) {
+            let goal_settled = self.g[goal_slot] == self.rhs[goal_slot];
+            if goal_settled && !entry.key.less(self.key(graph, self.goal)) {
+                break;
+            }
+            self.open.pop();
+            self.expanded += 1;
+
+            let (current, slot) = (entry.index, entry.index.index());
+            if self.g[slot] > self.rhs[slot] {
+                // Overconsistent: settle and push the improvement downstream
+                self.g[slot] = self.rhs[slot];
+                for succ in graph.successors(current) {
+                    self.lower_vertex(graph, succ, current);
+                }
+            } else {
+                // Underconsistent: forget g and re-derive everything it fed
+                self.g[slot] = f64::INFINITY;
+                self.update_vertex(graph, current);
+                for succ in graph.successors(current) {
+                    self.update_vertex(graph, succ);
+                }
+            }
+        }
+    }
+
+    /// Walk back from goal along predecessors one hop cheaper
+    fn extract_path<G: GraphView>(&self, graph: &G) -> Option<SymbolPath> {
+        let cost = self.g[self.goal.index()];
+        if !cost.is_finite() {
+            return None;
+        }
+
+        let mut path = vec![Symbol::from(self.goal)];
+        let mut current = self.goal;
+        while current != self.start && path.len() <= self.g.len() {
+            let target = self.g[current.index()] - 1.0;
+            current = graph.predecessors(current).find(|pred| self.g[pred.index()] == target)?;
+            path.push(Symbol::from(current));
+        }
+
+        path.reverse();
+        Some(SymbolPath { nodes: path, cost })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::graph::DependencyGraph;
+    use crate::resolver::strategies::astar_resolve;
+
+    fn chain(graph: &mut DependencyGraph, n: usize) -> Vec<NodeId> {
+        let ids: Vec<NodeId> = (0..n).map(|i| graph.add_node(format!("1.{}.0", i))).collect();
+        for pair in ids.windows(2) {
+            graph.add_edge(&pair[0], &pair[1]);
+        }
+        ids
+    }
+
+    #[test]
+    fn test_repairs_match_full_search() {
+        let mut graph = DependencyGraph::new();
+        let ids = chain(&mut graph, 40);
+        let (start, goal) = (ids[0].clone(), ids[39].clone());
+        let mut resolver = IncrementalResolver::between(&graph, &start, &goal).unwrap();
+
+        // Deterministic shortcut stream, re-resolving after every publish
+        let mut seed = 7usize;
+        for _ in 0..30 {
+            seed = seed.wrapping_mul(1103515245).wrapping_add(12345);
+            let from = (seed >> 4) % 39;
+            let to = from + 1 + (seed >> 12) % (39 - from);
+            graph.add_edge(&ids[from], &ids[to]);
+
+            let incremental = resolver.resolve_path(&graph).unwrap();
+            let full = astar_resolve(&graph, start.clone(), goal.clone()).unwrap();
+            assert_eq!(incremental.cost, full.cost);
+            assert_eq!(incremental.nodes.first(), Some(&start));
+            assert_eq!(incremental.nodes.last(), Some(&goal));
+        }
+    }
+
+    #[test]
+    fn test_publish_expands_only_affected_vertices() {
+        let mut graph = DependencyGraph::new();
+        let ids = chain(&mut graph, 200);
+        let mut resolver = IncrementalResolver::between(&graph, &ids[0], &ids[199]).unwrap();
+
+        assert_eq!(resolver.resolve(&graph).unwrap().cost, 199.0);
+        assert!(resolver.expanded() >= 199);
+
+        // Shortcut near the goal: only the tail is re-settled
+        graph.add_edge(&ids[180], &ids[198]);
+        assert_eq!(resolver.resolve(&graph).unwrap().cost, 182.0);
+        assert!(resolver.expanded() <= 3, "expanded {}", resolver.expanded());
+
+        // No new edges: nothing to do
+        resolver.resolve(&graph);
+        assert_eq!(resolver.expanded(), 0);
+    }
+
+    #[test]
+    fn test_new_version_makes_goal_reachable() {
+        let mut graph = DependencyGraph::new();
+        let a = graph.add_node("1.0.0".to_string());
+        let c = graph.add_node("1.2.0".to_string());
+        let mut resolver = IncrementalResolver::between(&graph, &a, &c).unwrap();
+        assert!(matches!(resolver.resolve_path(&graph), Err(ResolverError::NoPathFound { .. })));
+
+        let b = graph.add_node("1.1.0".to_string());
+        graph.add_edge(&a, &b);
+        graph.add_edge(&b, &c);
+        let path = resolver.resolve_path(&graph).unwrap();
+        assert_eq!(path.nodes, vec![a, b, c]);
+    }
+}
@@ -0,0 +1,111 @@
+// src/resolver/intern.rs
+// Per-graph arena of interned package@version identifiers
+// Resolution passes `Copy` u32 handles; strings only appear at the API edge
+
+use petgraph::graph::NodeIndex;
+use std::collections::HashMap;
+use std::sync::Arc;
+
+/// Interned node identifier
+///
+/// A handle into the `Interner` of the graph that issued it. Each
+/// `DependencyGraph` interns its node ids in insertion order, so a
+/// symbol's value is also the node's dense index in that graph and in
+/// every snapshot frozen from it.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct Symbol(u32);
+
+impl Symbol {
+    /// Dense index of the symbol in its arena
+    pub fn index(self) -> usize {
+        self.0 as usize
+    }
+}
+
+impl From<NodeIndex> for Symbol {
+    fn from(idx: NodeIndex) -> Self {
+        Symbol(idx.index() as u32)
+    }
+}
+
+impl From<Symbol> for NodeIndex {
+    fn from(sym: Symbol) -> Self {
+        NodeIndex::new(sym.index())
+    }
+}
+
+/// Append-only string arena
+///
+/// Every distinct id is stored exactly once as an `Arc<str>` shared by
+/// the lookup map and the handle table, so cloning an interner (as
+/// `freeze` does) bumps reference counts instead of copying strings.
+///
+/// Complexity: O(1) average `intern` / `get`, O(1) `resolve`
+#[derive(Debug, Clone, Default)]
+pub struct Interner {
+    strings: Vec<Arc<str>>,
+    map: HashMap<Arc<str>, Symbol>,
+}
+
+impl Interner {
+    /// Empty arena
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Handle for `id`, allocating one on first sight
+    pub fn intern(&mut self, id: &str) -> Symbol {
+        if let Some(&sym) = self.map.get(id) {
+            return sym;
+        }
+        let sym = Symbol(self.strings.len() as u32);
+        let shared: Arc<str> = Arc::from(id);
+        self.strings.push(Arc::clone(&shared));
+        self.map.insert(shared, sym);
+        sym
+    }
+
+    /// Handle for `id` if it has been interned
+    pub fn get(&self, id: &str) -> Option<Symbol> {
+        self.map.get(id).copied()
+    }
+
+    /// The string behind a handle
+    ///
+    /// Panics if `sym` was issued by a different arena that is larger
+    /// than this one.
+    pub fn resolve(&self, sym: Symbol) -> &str {
+        &self.strings[sym.index()]
+    }
+
+    /// Number of interned ids
+    pub fn len(&self) -> usize {
+        self.strings.len()
+    }
+
+    /// True if nothing has been interned
+    pub fn is_empty(&self) -> bool {
+        self.strings.is_empty()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_intern_is_idempotent_and_dense() {
+        let mut arena = Interner::new();
+
+        let a = arena.intern("core@1.0.0");
+        let b = arena.intern("core@2.0.0");
+        assert_eq!(arena.intern("core@1.0.0"), a);
+        assert_eq!((a.index(), b.index()), (0, 1));
+        assert_eq!(arena.resolve(b), "core@2.0.0");
+        assert_eq!(arena.get("missing"), None);
+
+        // Clones share the same string allocations
+        let copy = arena.clone();
+        assert!(std::ptr::eq(copy.resolve(a), arena.resolve(a)));
+    }
+}
@@ -0,0 +1,42 @@
+//! DAG Resolution Engine
+//! 
+//! Dependency graph plus Euler/Hamilton/A* strategies
+
+/// Dense bitset over node indices
+pub mod bitset;
+/// Sharded LRU cache of resolution results
+pub mod cache;
+/// Mutable dependency graph and the `GraphView` interface
+pub mod graph;
+/// Node ids, paths, strategy tags and tuning
+pub mod types;
+/// Resolver error taxonomy
+pub mod errors;
+/// Immutable CSR snapshots
+pub mod frozen;
+/// Interned node ids
+pub mod intern;
+/// Hamiltonian path engine
+pub mod hamiltonian;
+/// LPA* resolver that survives graph growth
+pub mod incremental;
+/// Statistics-driven planner behind `resolve_hybrid`
+pub mod planner;
+/// A*, bidirectional, Eulerian, Hamiltonian and hybrid strategies
+pub mod strategies;
+
+pub use cache::{CacheStats, ResolutionCache};
+pub use frozen::{FrozenGraph, SnapshotSlot};
+pub use graph::{DependencyGraph, GraphView};
+pub use incremental::IncrementalResolver;
+pub use intern::{Interner, Symbol};
+pub use planner::{GraphStats, Outcomes, Plan, Planner, Prune, Shortest};
+pub use types::{HybridConfig, NodeId, Path, ResolutionStrategy, SymbolPath, Unresolved};
+pub use errors::ResolverError;
+pub use strategies::{
+    astar_resolve, astar_resolve_symbols, bidirectional_resolve, bidirectional_resolve_symbols,
+    find_hamiltonian_path, find_hamiltonian_path_between,
+    find_hamiltonian_path_between_parallel, find_hamiltonian_path_between_symbols,
+    find_hamiltonian_path_parallel, is_eulerian, materialize, resolve_batch, resolve_batch_symbols,
+    resolve_hybrid, resolve_hybrid_symbols, resolve_hybrid_with,
+};
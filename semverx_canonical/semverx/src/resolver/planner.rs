@@ -0,0 +1,527 @@
+// src/resolver/planner.rs
+// Adaptive strategy planner for hybrid resolution
+// Cached graph statistics prune, pick and budget strategies per request
+
+use petgraph::graph::NodeIndex;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+
+use arc_swap::ArcSwapOption;
+
+use crate::audit::plpprofiler::{self, Probe};
+use super::bitset::BitSet;
+use super::graph::GraphView;
+use super::intern::Symbol;
+use super::strategies::{astar_within, bidirectional_resolve_symbols, OverBudget};
+use super::types::{HybridConfig, SymbolPath, Unresolved};
+
+/// Sentinel component id while the second Kosaraju pass runs
+const UNASSIGNED: u32 = u32::MAX;
+
+/// Structural statistics of one graph generation
+///
+/// Built in O(V + E) and reused until the graph's generation moves.
+/// SCCs are numbered in topological order of the condensation, so an
+/// edge between two components always goes from the lower id to the
+/// higher one; weak components include isolated nodes.
+#[derive(Debug, Clone)]
+pub struct GraphStats {
+    /// Graph generation the statistics describe
+    pub generation: u64,
+    /// Node count
+    pub nodes: usize,
+    /// Edge count
+    pub edges: usize,
+    /// Nodes whose in-degree differs from their out-degree
+    pub degree_imbalance: usize,
+    scc: Vec<u32>,
+    scc_sizes: Vec<u32>,
+    /// Nodes in the SCCs before each id, plus the total
+    scc_offsets: Vec<u32>,
+    weak: Vec<u32>,
+    weak_count: usize,
+}
+
+impl GraphStats {
+    /// Statistics of `graph`, O(V + E) with two iterative Kosaraju passes
+    pub fn compute<G: GraphView>(graph: &G) -> Self {
+        let n = graph.node_count();
+        let mut edges = 0;
+
+        // Pass 1: finish order of a forward DFS
+        let mut seen = BitSet::new(n);
+        let mut order = Vec::with_capacity(n);
+        let mut stack = Vec::new();
+        for root in (0..n).map(NodeIndex::new) {
+            if seen.contains(root.index() as u32) {
+                continue;
+            }
+            seen.insert(root.index() as u32);
+            stack.push((root, graph.successors(root)));
+            while let Some((node, successors)) = stack.last_mut() {
+                match successors.next() {
+                    Some(next) => {
+                        edges += 1;
+                        if !seen.contains(next.index() as u32) {
+                            seen.insert(next.index() as u32);
+                            stack.push((next, graph.successors(next)));
+                        }
+                    }
+                    None => {
+                        order.push(*node);
+                        stack.pop();
+                    }
+                }
+            }
+        }
+
+        // Pass 2: backward DFS in reverse finish order; components come
+        // out as sources first, i.e. in topological order
+        let mut scc = vec![UNASSIGNED; n];
+        let mut scc_sizes = Vec::new();
+        let mut work = Vec::new();
+        for &root in order.iter().rev() {
+            if scc[root.index()] != UNASSIGNED {
+                continue;
+            }
+            let id = scc_sizes.len() as u32;
+            let mut size = 0;
+            scc[root.index()] = id;
+            work.push(root);
+            while let Some(node) = work.pop() {
+                size += 1;
+                for prev in graph.predecessors(node) {
+                    if scc[prev.index()] == UNASSIGNED {
+                        scc[prev.index()] = id;
+                        work.push(prev);
+                    }
+                }
+            }
+            scc_sizes.push(size);
+        }
+
+        // Weak components over both edge directions
+        let mut weak = vec![UNASSIGNED; n];
+        let mut weak_count = 0;
+        for root in 0..n {
+            if weak[root] != UNASSIGNED {
+                continue;
+            }
+            weak[root] = weak_count;
+            work.push(NodeIndex::new(root));
+            while let Some(node) = work.pop() {
+                for next in graph.successors(node).chain(graph.predecessors(node)) {
+                    if weak[next.index()] == UNASSIGNED {
+                        weak[next.index()] = weak_count;
+                        work.push(next);
+                    }
+                }
+            }
+            weak_count += 1;
+        }
+
+        let mut scc_offsets = Vec::with_capacity(scc_sizes.len() + 1);
+        scc_offsets.push(0);
+        for &size in &scc_sizes {
+            scc_offsets.push(scc_offsets[scc_offsets.len() - 1] + size);
+        }
+
+        Self {
+            generation: graph.generation(),
+            nodes: n,
+            edges,
+            degree_imbalance: graph.degree_imbalance(),
+            scc,
+            scc_sizes,
+            scc_offsets,
+            weak,
+            weak_count: weak_count as usize,
+        }
+    }
+
+    /// Number of strongly connected components
+    pub fn scc_count(&self) -> usize {
+        self.scc_sizes.len()
+    }
+
+    /// Size of the largest SCC (0 for an empty graph)
+    pub fn largest_scc(&self) -> usize {
+        self.scc_sizes.iter().copied().max().unwrap_or(0) as usize
+    }
+
+    /// Size of the SCC containing `node`
+    pub fn scc_size(&self, node: NodeIndex) -> usize {
+        self.scc_sizes[self.scc[node.index()] as usize] as usize
+    }
+
+    /// True if `a` and `b` lie in one SCC (each reaches the other)
+    pub fn same_scc(&self, a: NodeIndex, b: NodeIndex) -> bool {
+        self.scc[a.index()] == self.scc[b.index()]
+    }
+
+    /// Nodes whose SCC lies between `from`'s and `to`'s in topological
+    /// order, both included; every `from -> to` path stays among them
+    ///
+    /// 0 if `to`'s SCC precedes `from`'s.
+    pub fn between(&self, from: NodeIndex, to: NodeIndex) -> usize {
+        let (first, last) = (self.scc[from.index()] as usize, self.scc[to.index()] as usize);
+        self.scc_offsets[last + 1].saturating_sub(self.scc_offsets[first]) as usize
+    }
+
+    /// Number of weakly connected components, isolated nodes included
+    pub fn weak_components(&self) -> usize {
+        self.weak_count
+    }
+
+    /// False only if no path `from -> to` can exist, O(1)
+    ///
+    /// Paths stay inside one weak component and never descend in the
+    /// topological order of SCCs.
+    pub fn may_reach(&self, from: NodeIndex, to: NodeIndex) -> bool {
+        self.weak[from.index()] == self.weak[to.index()] && self.scc[from.index()] <= self.scc[to.index()]
+    }
+}
+
+/// Why a request was answered without searching
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Prune {
+    /// An endpoint is not a node of the graph
+    UnknownEndpoint,
+    /// Start has no outgoing or goal no incoming edge
+    DeadEnd,
+    /// Endpoints lie in different weak components
+    OtherComponent,
+    /// Goal's SCC precedes start's in topological order
+    Upstream,
+}
+
+/// Shortest-path engine chosen for a request
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Shortest {
+    /// Bidirectional BFS
+    Bidirectional,
+    /// A* with the version heuristic, handing over to bidirectional BFS
+    /// once it has expanded `budget` nodes without settling the goal
+    AStar {
+        /// Node expansions before the handover
+        budget: u64,
+    },
+}
+
+/// What the planner decided for one request
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Plan {
+    /// Provably unreachable; nothing runs
+    Pruned(Prune),
+    /// Run one complete shortest-path search and nothing after it
+    Search(Shortest),
+}
+
+/// Runs, successes and time of one engine
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct EngineOutcome {
+    /// Searches run
+    pub runs: u64,
+    /// Searches that found a path
+    pub found: u64,
+    /// Wall time over all runs
+    pub elapsed: Duration,
+}
+
+/// Planner decisions and their results so far, for tuning thresholds
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Outcomes {
+    /// Requests pruned, by `Prune` discriminant
+    pub pruned: [u64; 4],
+    /// Bidirectional searches
+    pub bidirectional: EngineOutcome,
+    /// A* searches, including those handed over
+    pub astar: EngineOutcome,
+    /// A* searches that ran out of budget and finished bidirectionally
+    pub handovers: u64,
+    /// Times the statistics were rebuilt for a new generation
+    pub rebuilds: u64,
+}
+
+#[derive(Debug, Default)]
+struct EngineCounters {
+    runs: AtomicU64,
+    found: AtomicU64,
+    nanos: AtomicU64,
+}
+
+impl EngineCounters {
+    fn record(&self, found: bool, elapsed: Duration) {
+        self.runs.fetch_add(1, Ordering::Relaxed);
+        self.found.fetch_add(found as u64, Ordering::Relaxed);
+        self.nanos.fetch_add(elapsed.as_nanos() as u64, Ordering::Relaxed);
+    }
+
+    fn read(&self) -> EngineOutcome {
+        EngineOutcome {
+            runs: self.runs.load(Ordering::Relaxed),
+            found: self.found.load(Ordering::Relaxed),
+            elapsed: Duration::from_nanos(self.nanos.load(Ordering::Relaxed)),
+        }
+    }
+}
+
+/// Adaptive strategy planner behind `resolve_hybrid`
+///
+/// One planner serves one graph (or its frozen snapshots) from any
+/// number of threads. Per request it prunes provably unreachable pairs
+/// in O(1) from cached `GraphStats`, then picks and budgets a single
+/// shortest-path search from the same statistics (see `plan`).
+/// Statistics are read lock-free; when the graph generation moves, one
+/// thread rebuilds them while the others wait and then share its copy.
+///
+/// Both engines are complete, so a failed search proves the goal
+/// unreachable, and no Hamiltonian path (itself a start-goal path) can
+/// exist either; nothing is planned after a failed search and failures
+/// are always `Unresolved::Unreachable`.
+#[derive(Debug)]
+pub struct Planner {
+    config: HybridConfig,
+    stats: ArcSwapOption<GraphStats>,
+    rebuild: Mutex<()>,
+    pruned: [AtomicU64; 4],
+    bidirectional: EngineCounters,
+    astar: EngineCounters,
+    handovers: AtomicU64,
+    rebuilds: AtomicU64,
+}
+
+impl Planner {
+    /// Planner applying `config` to every request
+    pub fn new(config: HybridConfig) -> Self {
+        Self {
+            config,
+            stats: ArcSwapOption::empty(),
+            rebuild: Mutex::new(()),
+            pruned: Default::default(),
+            bidirectional: EngineCounters::default(),
+            astar: EngineCounters::default(),
+            handovers: AtomicU64::new(0),
+            rebuilds: AtomicU64::new(0),
+        }
+    }
+
+    /// Statistics of `graph`'s current generation, rebuilt on change
+    ///
+    /// Concurrent callers that find them stale queue on the rebuild
+    /// lock; the first rebuilds and the rest reuse its result.
+    pub fn stats<G: GraphView>(&self, graph: &G) -> Arc<GraphStats> {
+        if let Some(stats) = self.current(graph) {
+            return stats;
+        }
+        let _rebuilding = self.rebuild.lock().unwrap();
+        if let Some(stats) = self.current(graph) {
+            return stats;
+        }
+        let stats = Arc::new(GraphStats::compute(graph));
+        self.rebuilds.fetch_add(1, Ordering::Relaxed);
+        self.stats.store(Some(Arc::clone(&stats)));
+        stats
+    }
+
+    /// Cached statistics, if they describe `graph`'s current generation
+    fn current<G: GraphView>(&self, graph: &G) -> Option<Arc<GraphStats>> {
+        self.stats
+            .load_full()
+            .filter(|stats| stats.generation == graph.generation() && stats.nodes == graph.node_count())
+    }
+
+    /// Decide how to resolve `start -> goal`, O(1) given the statistics
+    ///
+    /// A* is planned where the version heuristic can steer it: both
+    /// endpoints versioned, a nonzero heuristic scale, and endpoints in
+    /// different SCCs (inside one SCC every node can lie on the path and
+    /// the version order says little). Its budget is `stats.between`:
+    /// an A* that expanded more nodes than could lie on any start-goal
+    /// path is wandering through the goal's siblings and descendants, so
+    /// it hands over to bidirectional BFS. Elsewhere `config.bidirectional`
+    /// picks the engine.
+    pub fn plan<G: GraphView>(&self, graph: &G, stats: &GraphStats, start: Symbol, goal: Symbol) -> Plan {
+        let n = graph.node_count();
+        if start.index() >= n || goal.index() >= n {
+            return Plan::Pruned(Prune::UnknownEndpoint);
+        }
+        let (from, to) = (NodeIndex::from(start), NodeIndex::from(goal));
+        if from == to {
+            return Plan::Search(Shortest::Bidirectional);
+        }
+        if graph.successors(from).next().is_none() || graph.predecessors(to).next().is_none() {
+            return Plan::Pruned(Prune::DeadEnd);
+        }
+        if stats.weak[from.index()] != stats.weak[to.index()] {
+            return Plan::Pruned(Prune::OtherComponent);
+        }
+        if !stats.may_reach(from, to) {
+            return Plan::Pruned(Prune::Upstream);
+        }
+        let steered = graph.heuristic_scale() > 0.0
+            && graph.version(from).is_some()
+            && graph.version(to).is_some()
+            && !stats.same_scc(from, to);
+        if steered || !self.config.bidirectional {
+            Plan::Search(Shortest::AStar { budget: stats.between(from, to) as u64 })
+        } else {
+            Plan::Search(Shortest::Bidirectional)
+        }
+    }
+
+    /// Plan and run one request, recording the outcome
+    pub fn resolve<G: GraphView>(&self, graph: &G, start: Symbol, goal: Symbol) -> Result<SymbolPath, Unresolved> {
+        let mut span = plpprofiler::span(Probe::HybridExhausted);
+        let stats = self.stats(graph);
+        let path = match self.plan(graph, &stats, start, goal) {
+            Plan::Pruned(reason) => {
+                self.pruned[reason as usize].fetch_add(1, Ordering::Relaxed);
+                span.label(Probe::HybridPruned);
+                return Err(Unresolved::Unreachable);
+            }
+            Plan::Search(Shortest::Bidirectional) => self.bidirectional(graph, start, goal),
+            Plan::Search(Shortest::AStar { budget }) => {
+                let began = Instant::now();
+                let result = astar_within(graph, start, goal, budget);
+                self.astar.record(matches!(result, Ok(Some(_))), began.elapsed());
+                match result {
+                    Ok(path) => path,
+                    Err(OverBudget) => {
+                        self.handovers.fetch_add(1, Ordering::Relaxed);
+                        self.bidirectional(graph, start, goal)
+                    }
+                }
+            }
+        };
+        match path {
+            Some(path) => {
+                span.label(Probe::HybridShortest);
+                Ok(path)
+            }
+            None => Err(Unresolved::Unreachable),
+        }
+    }
+
+    fn bidirectional<G: GraphView>(&self, graph: &G, start: Symbol, goal: Symbol) -> Option<SymbolPath> {
+        let began = Instant::now();
+        let path = bidirectional_resolve_symbols(graph, start, goal);
+        self.bidirectional.record(path.is_some(), began.elapsed());
+        path
+    }
+
+    /// Decisions and results so far
+    pub fn outcomes(&self) -> Outcomes {
+        Outcomes {
+            pruned: std::array::from_fn(|i| self.pruned[i].load(Ordering::Relaxed)),
+            bidirectional: self.bidirectional.read(),
+            astar: self.astar.read(),
+            handovers: self.handovers.load(Ordering::Relaxed),
+            rebuilds: self.rebuilds.load(Ordering::Relaxed),
+        }
+    }
+}
+
+impl Default for Planner {
+    fn default() -> Self {
+        Self::new(HybridConfig::default())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::graph::DependencyGraph;
+    use crate::resolver::strategies::resolve_hybrid_symbols;
+    use crate::resolver::types::NodeId;
+
+    /// Two chains with a cycle in the first, plus an isolated node
+    fn fixture() -> (DependencyGraph, Vec<NodeId>) {
+        let mut graph = DependencyGraph::new();
+        let ids: Vec<NodeId> = (0..10).map(|i| graph.add_node(format!("{}.{}.0", i / 5, i % 5))).collect();
+        for (a, b) in [(0, 1), (1, 2), (2, 3), (3, 1), (3, 4), (5, 6), (6, 7), (7, 8)] {
+            graph.add_edge(&ids[a], &ids[b]);
+        }
+        (graph, ids)
+    }
+
+    #[test]
+    fn test_stats_order_sccs_topologically() {
+        let (graph, _) = fixture();
+        let stats = GraphStats::compute(&graph);
+        assert_eq!((stats.nodes, stats.edges), (10, 8));
+        assert_eq!(stats.scc_count(), 8);
+        assert_eq!(stats.largest_scc(), 3);
+        assert_eq!(stats.weak_components(), 3);
+        let idx = NodeIndex::new;
+        assert!(stats.same_scc(idx(1), idx(3)));
+        assert!(stats.may_reach(idx(0), idx(4)));
+        assert!(!stats.may_reach(idx(4), idx(0)));
+        assert!(!stats.may_reach(idx(0), idx(6)));
+    }
+
+    #[test]
+    fn test_planner_matches_hybrid_and_prunes() {
+        let (mut graph, ids) = fixture();
+        let planner = Planner::default();
+        for a in 0..ids.len() {
+            for b in 0..ids.len() {
+                let (start, goal) = (graph.symbol(&ids[a]).unwrap(), graph.symbol(&ids[b]).unwrap());
+                let planned = planner.resolve(&graph, start, goal);
+                let hybrid = resolve_hybrid_symbols(&graph, start, goal, &HybridConfig::default());
+                assert_eq!(planned.as_ref().ok().map(|p| p.cost), hybrid.as_ref().ok().map(|p| p.cost), "{} -> {}", a, b);
+            }
+        }
+        let outcomes = planner.outcomes();
+        assert_eq!(outcomes.rebuilds, 1);
+        assert_eq!(outcomes.pruned[Prune::UnknownEndpoint as usize], 0);
+        assert!(outcomes.pruned[Prune::DeadEnd as usize] > 0);
+        assert!(outcomes.pruned[Prune::OtherComponent as usize] > 0);
+        assert!(outcomes.pruned[Prune::Upstream as usize] > 0);
+        // Every search that ran found its path: hopeless pairs were pruned
+        assert_eq!(outcomes.bidirectional.found, outcomes.bidirectional.runs);
+        assert_eq!(outcomes.astar.found + outcomes.handovers, outcomes.astar.runs);
+        assert!(outcomes.astar.runs > 0);
+
+        let stats = planner.stats(&graph);
+        let unknown = Symbol::from(NodeIndex::new(99));
+        let sym = |i: usize| graph.symbol(&ids[i]).unwrap();
+        assert_eq!(planner.plan(&graph, &stats, unknown, unknown), Plan::Pruned(Prune::UnknownEndpoint));
+        // Versioned chain: A* budgeted to the SCCs between the endpoints
+        let budget = stats.between(NodeIndex::new(0), NodeIndex::new(4)) as u64;
+        assert!(budget >= 5);
+        assert_eq!(planner.plan(&graph, &stats, sym(0), sym(4)), Plan::Search(Shortest::AStar { budget }));
+        // Inside one SCC the version order does not steer
+        assert_eq!(planner.plan(&graph, &stats, sym(3), sym(2)), Plan::Search(Shortest::Bidirectional));
+
+        graph.add_edge(&ids[4], &ids[5]);
+        let (start, goal) = (graph.symbol(&ids[0]).unwrap(), graph.symbol(&ids[7]).unwrap());
+        assert_eq!(planner.resolve(&graph, start, goal).unwrap().cost, 7.0);
+        assert_eq!(planner.outcomes().rebuilds, 2);
+
+        let astar = Planner::new(HybridConfig { bidirectional: false });
+        let stats = astar.stats(&graph);
+        let (inner, back) = (graph.symbol(&ids[3]).unwrap(), graph.symbol(&ids[2]).unwrap());
+        let budget = stats.scc_size(NodeIndex::new(3)) as u64;
+        assert_eq!(astar.plan(&graph, &stats, inner, back), Plan::Search(Shortest::AStar { budget }));
+        assert_eq!(astar.resolve(&graph, inner, back).unwrap().cost, 2.0);
+        assert_eq!(astar.outcomes().astar.runs, 1);
+    }
+
+    #[test]
+    fn test_stats_rebuilt_once_under_contention() {
+        let (graph, _) = fixture();
+        let planner = Planner::default();
+        let barrier = std::sync::Barrier::new(8);
+        std::thread::scope(|scope| {
+            for _ in 0..8 {
+                scope.spawn(|| {
+                    barrier.wait();
+                    assert_eq!(planner.stats(&graph).nodes, 10);
+                });
+            }
+        });
+        assert_eq!(planner.outcomes().rebuilds, 1);
+    }
+}
@@ -0,0 +1,1018 @@
+// src/resolver/strategies.rs
+// Complete Hamilton/Euler/A* DAG Resolution Implementation
+// Ensures O(log n) index complexity for polyglot interface
+
+use petgraph::graph::NodeIndex;
+use std::collections::{BinaryHeap, VecDeque};
+use std::cmp::Ordering;
+use std::time::{Duration, Instant};
+
+use crate::audit::plpprofiler::{self, Probe};
+use crate::SemVerX;
+use super::bitset::BitSet;
+use super::graph::{version_distance, GraphView};
+use super::hamiltonian::{self, Component, Search};
+use super::intern::Symbol;
+use super::planner::Planner;
+use super::types::{HybridConfig, NodeId, Path, ResolutionStrategy, SymbolPath, Unresolved};
+use super::errors::ResolverError;
+
+/// A* Node for priority queue
+///
+/// Carries only the graph index and scores; the path is rebuilt from
+/// the parent links once the goal is popped.
+#[derive(Debug, Clone, Copy)]
+struct AStarNode {
+    index: NodeIndex,
+    g_score: f64,  // Cost from start
+    f_score: f64,  // g_score + heuristic
+}
+
+impl PartialEq for AStarNode {
+    fn eq(&self, other: &Self) -> bool {
+        self.f_score == other.f_score && self.g_score == other.g_score
+    }
+}
+
+impl Eq for AStarNode {}
+
+impl PartialOrd for AStarNode {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for AStarNode {
+    fn cmp(&self, other: &Self) -> Ordering {
+        // Reverse ordering for min-heap; on equal f prefer the deeper node
+        other.f_score.partial_cmp(&self.f_score)
+            .unwrap_or(Ordering::Equal)
+            .then_with(|| self.g_score.partial_cmp(&other.g_score).unwrap_or(Ordering::Equal))
+    }
+}
+
+/// Sentinel parent link for nodes not reached (or the start node)
+const NO_PARENT: usize = usize::MAX;
+
+/// Eulerian Cycle Detection
+/// 
+/// Complexity: O(1) - answered from caches `DependencyGraph` maintains
+/// incrementally on every `add_edge` (and snapshots copy at freeze time)
+/// 
+/// A graph has an Eulerian cycle if:
+/// 1. All vertices with nonzero degree are connected
+/// 2. All vertices have even degree (for undirected)
+/// 3. In-degree equals out-degree for all vertices (for directed)
+/// 
+/// With (3) in place, every weakly connected component is strongly
+/// connected, so (1) reduces to a single weak component among the
+/// vertices that carry edges.
+pub fn is_eulerian<G: GraphView>(graph: &G) -> bool {
+    graph.degree_imbalance() == 0 && graph.edge_components() <= 1
+}
+
+/// Hamiltonian Path Search (NP-Complete)
+/// 
+/// Held-Karp bitmask DP for graphs of up to `HELD_KARP_MAX_NODES` nodes,
+/// bitset backtracking with amortized deadline checks beyond that
+/// Complexity: O(2^n * n) / O(n!) worst case, bounded by timeout
+/// 
+/// Returns Some(path) if found within timeout, None otherwise
+pub fn find_hamiltonian_path<G: GraphView>(
+    graph: &G,
+    timeout: Duration,
+) -> Option<Vec<NodeId>> {
+    hamiltonian_whole(graph, timeout, 1)
+}
+
+/// Parallel Hamiltonian Path Search
+/// 
+/// Same contract as `find_hamiltonian_path`, with start nodes and
+/// first-level DFS subtrees spread over all available cores. The first
+/// worker to find a path cancels the others.
+pub fn find_hamiltonian_path_parallel<G: GraphView>(
+    graph: &G,
+    timeout: Duration,
+) -> Option<Vec<NodeId>> {
+    hamiltonian_whole(graph, timeout, available_threads())
+}
+
+/// Hamiltonian Path Search between two pinned endpoints
+/// 
+/// A simple start..goal path that covers a strongly connected component
+/// must stay inside the component of `start`, so only that SCC is
+/// searched; if `goal` lies outside it this returns None in O(V + E).
+/// 
+/// The returned path visits every node of the SCC exactly once.
+pub fn find_hamiltonian_path_between<G: GraphView>(
+    graph: &G,
+    start: &str,
+    goal: &str,
+    timeout: Duration,
+) -> Option<Vec<NodeId>> {
+    let path = hamiltonian_between(graph, graph.find_node(start)?, graph.find_node(goal)?, timeout, 1)?;
+    Some(to_node_ids(graph, &path))
+}
+
+/// Parallel variant of `find_hamiltonian_path_between`
+pub fn find_hamiltonian_path_between_parallel<G: GraphView>(
+    graph: &G,
+    start: &str,
+    goal: &str,
+    timeout: Duration,
+) -> Option<Vec<NodeId>> {
+    let (start_idx, goal_idx) = (graph.find_node(start)?, graph.find_node(goal)?);
+    let path = hamiltonian_between(graph, start_idx, goal_idx, timeout, available_threads())?;
+    Some(to_node_ids(graph, &path))
+}
+
+/// Hamiltonian Path Search between interned handles
+/// 
+/// Serial engine of `find_hamiltonian_path_between`, returning the
+/// path as `Symbol`s.
+pub fn find_hamiltonian_path_between_symbols<G: GraphView>(
+    graph: &G,
+    start: Symbol,
+    goal: Symbol,
+    timeout: Duration,
+) -> Option<SymbolPath> {
+    if !in_graph(graph, start) || !in_graph(graph, goal) {
+        return None;
+    }
+    let path = hamiltonian_between(graph, start.into(), goal.into(), timeout, 1)?;
+    let cost = (path.len() - 1) as f64;
+    Some(symbol_path(&path, cost))
+}
+
+fn hamiltonian_whole<G: GraphView>(
+    graph: &G,
+    timeout: Duration,
+    threads: usize,
+) -> Option<Vec<NodeId>> {
+    let deadline = Instant::now() + timeout;
+    let comp = Component::whole(graph);
+    
+    match hamiltonian::search_parallel(&comp, None, None, deadline, threads) {
+        Search::Found(local) => Some(to_node_ids(graph, &comp.to_graph_path(&local))),
+        Search::Exhausted => None,
+        Search::TimedOut => {
+            plpprofiler::count(Probe::HamiltonianTimeouts, 1);
+            None
+        }
+    }
+}
+
+fn hamiltonian_between<G: GraphView>(
+    graph: &G,
+    start_idx: NodeIndex,
+    goal_idx: NodeIndex,
+    timeout: Duration,
+    threads: usize,
+) -> Option<Vec<NodeIndex>> {
+    let _span = plpprofiler::span(Probe::HamiltonianSearch);
+    let deadline = Instant::now() + timeout;
+    
+    let comp = Component::strongly_connected(graph, start_idx);
+    let goal_local = comp.local(goal_idx)?;
+    let start_local = comp.local(start_idx)?;
+    
+    match hamiltonian::search_parallel(&comp, Some(start_local), Some(goal_local), deadline, threads) {
+        Search::Found(local) => Some(comp.to_graph_path(&local)),
+        Search::Exhausted => None,
+        Search::TimedOut => {
+            plpprofiler::count(Probe::HamiltonianTimeouts, 1);
+            None
+        }
+    }
+}
+
+/// Worker count for parallel strategies
+fn available_threads() -> usize {
+    std::thread::available_parallelism().map_or(1, |n| n.get())
+}
+
+/// Map an index path to owned NodeIds (once, at the API edge)
+fn to_node_ids<G: GraphView>(graph: &G, path: &[NodeIndex]) -> Vec<NodeId> {
+    path.iter().map(|&idx| graph.node_id(idx).to_owned()).collect()
+}
+
+/// Turn a handle-level result into a string `Path`
+///
+/// The only place resolution output allocates strings; callers that
+/// stay on `Symbol`s never pay for it.
+pub fn materialize<G: GraphView>(graph: &G, path: &SymbolPath) -> Path {
+    Path {
+        nodes: path.nodes.iter().map(|&sym| graph.symbols().resolve(sym).to_owned()).collect(),
+        cost: path.cost,
+    }
+}
+
+fn symbol_path(path: &[NodeIndex], cost: f64) -> SymbolPath {
+    SymbolPath {
+        nodes: path.iter().copied().map(Symbol::from).collect(),
+        cost,
+    }
+}
+
+/// Look up both endpoints, reporting the first unknown one
+fn endpoints<G: GraphView>(
+    graph: &G,
+    start: &NodeId,
+    goal: &NodeId,
+) -> Result<(Symbol, Symbol), ResolverError> {
+    let start_sym = graph.symbols().get(start).ok_or_else(|| ResolverError::NodeNotFound(start.clone()))?;
+    let goal_sym = graph.symbols().get(goal).ok_or_else(|| ResolverError::NodeNotFound(goal.clone()))?;
+    Ok((start_sym, goal_sym))
+}
+
+/// True if `sym` names a node of `graph`
+fn in_graph<G: GraphView>(graph: &G, sym: Symbol) -> bool {
+    sym.index() < graph.node_count()
+}
+
+/// A* Optimal Path Resolution
+/// 
+/// Complexity: O(E log V) with admissible heuristic
+/// Memory: O(V) - dense g-score and parent vectors, no per-entry paths
+/// Uses SemVerX version distance as heuristic
+/// 
+/// Heuristic formula (admissible):
+/// h(current, goal) = (abs(major_diff) * 100 + abs(minor_diff) * 10 + abs(patch_diff))
+///                    / max version span of any single edge
+pub fn astar_resolve<G: GraphView>(
+    graph: &G,
+    start: NodeId,
+    goal: NodeId,
+) -> Result<Path, ResolverError> {
+    let (start_sym, goal_sym) = endpoints(graph, &start, &goal)?;
+    
+    match astar_resolve_symbols(graph, start_sym, goal_sym) {
+        Some(path) => Ok(materialize(graph, &path)),
+        None => Err(ResolverError::NoPathFound { start, goal }),
+    }
+}
+
+/// A* on interned handles
+/// 
+/// Same search as `astar_resolve` without any string hashing or
+/// allocation. Returns None if `goal` is unreachable (or either handle
+/// is not a node of `graph`).
+pub fn astar_resolve_symbols<G: GraphView>(
+    graph: &G,
+    start: Symbol,
+    goal: Symbol,
+) -> Option<SymbolPath> {
+    astar_within(graph, start, goal, u64::MAX).unwrap_or(None)
+}
+
+/// A* gave up after expanding its node budget
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(super) struct OverBudget;
+
+/// A* on interned handles that stops after expanding `budget` nodes
+///
+/// `Ok(None)` proves `goal` unreachable (or either handle is not a node
+/// of `graph`); `Err(OverBudget)` says nothing either way.
+pub(super) fn astar_within<G: GraphView>(
+    graph: &G,
+    start: Symbol,
+    goal: Symbol,
+    budget: u64,
+) -> Result<Option<SymbolPath>, OverBudget> {
+    if !in_graph(graph, start) || !in_graph(graph, goal) {
+        return Ok(None);
+    }
+    let found = astar_indexed(graph, start.into(), goal.into(), budget)?;
+    Ok(found.map(|(indices, cost)| symbol_path(&indices, cost)))
+}
+
+/// Index-only A* engine
+/// 
+/// Works purely on `NodeIndex`: g-scores and parent links live in
+/// dense vectors indexed by `NodeIndex::index()`, and the index path is
+/// reconstructed once when the goal is popped.
+/// 
+/// Returns the start..=goal index path and its cost, or `OverBudget`
+/// once `budget` nodes were expanded without settling the goal.
+fn astar_indexed<G: GraphView>(
+    graph: &G,
+    start_idx: NodeIndex,
+    goal_idx: NodeIndex,
+    budget: u64,
+) -> Result<Option<(Vec<NodeIndex>, f64)>, OverBudget> {
+    let goal = graph.version(goal_idx);
+    let scale = graph.heuristic_scale();
+    let node_count = graph.node_count();
+    
+    // Best g_score and parent link for each node
+    let mut g_scores = vec![f64::INFINITY; node_count];
+    let mut parents = vec![NO_PARENT; node_count];
+    
+    // Priority queue (min-heap by f_score)
+    let mut open_set = BinaryHeap::new();
+    let mut stats = SearchStats::default();
+    
+    // Initialize start node
+    g_scores[start_idx.index()] = 0.0;
+    open_set.push(AStarNode {
+        index: start_idx,
+        g_score: 0.0,
+        f_score: heuristic(graph, start_idx, goal, scale),
+    });
+    
+    // A* main loop
+    while let Some(current) = open_set.pop() {
+        // Skip stale entries superseded by a cheaper push
+        if current.g_score > g_scores[current.index.index()] {
+            continue;
+        }
+        if stats.expanded == budget {
+            stats.report();
+            return Err(OverBudget);
+        }
+        stats.expanded += 1;
+        
+        // Goal reached
+        if current.index == goal_idx {
+            stats.report();
+            return Ok(Some((reconstruct_path(&parents, goal_idx), current.g_score)));
+        }
+        
+        // Explore neighbors
+        for neighbor_idx in graph.successors(current.index) {
+            let edge_cost = 1.0; // Uniform cost; could be version distance
+            let tentative_g = current.g_score + edge_cost;
+            
+            // Check if this path is better
+            let slot = neighbor_idx.index();
+            if tentative_g < g_scores[slot] {
+                g_scores[slot] = tentative_g;
+                parents[slot] = current.index.index();
+                
+                stats.pushes += 1;
+                open_set.push(AStarNode {
+                    index: neighbor_idx,
+                    g_score: tentative_g,
+                    f_score: tentative_g + heuristic(graph, neighbor_idx, goal, scale),
+                });
+            }
+        }
+    }
+    
+    stats.report();
+    Ok(None)
+}
+
+/// Expansion counts of one search, reported to the profiler once
+///
+/// Kept in locals so the inner loops stay free of thread-local access.
+#[derive(Default)]
+struct SearchStats {
+    expanded: u64,
+    pushes: u64,
+}
+
+impl SearchStats {
+    fn report(&self) {
+        plpprofiler::count(Probe::NodesExpanded, self.expanded);
+        if self.pushes > 0 {
+            plpprofiler::count(Probe::HeapPushes, self.pushes);
+        }
+    }
+}
+
+/// Walk parent links back from `goal` and return the start..=goal path
+fn reconstruct_path(parents: &[usize], goal: NodeIndex) -> Vec<NodeIndex> {
+    let mut path = vec![goal];
+    let mut slot = parents[goal.index()];
+    
+    while slot != NO_PARENT {
+        path.push(NodeIndex::new(slot));
+        slot = parents[slot];
+    }
+    
+    path.reverse();
+    path
+}
+
+/// Bidirectional Breadth-First Resolution
+/// 
+/// Complexity: O(b^(d/2)) expanded nodes for branching factor b and
+/// depth d, against O(b^d) for a one-sided search; O(V) memory
+/// 
+/// Grows a forward frontier from start over outgoing edges and a
+/// backward frontier from goal over incoming edges, always expanding one
+/// whole level of the smaller frontier. Edge costs are uniform, so the
+/// cheapest meeting found while finishing the first level that meets is
+/// optimal (meet-in-the-middle rule: stop once mu <= radius_f + radius_b).
+/// 
+/// Returns the same cost as `astar_resolve`; among equally short paths
+/// the one chosen may differ.
+pub fn bidirectional_resolve<G: GraphView>(
+    graph: &G,
+    start: NodeId,
+    goal: NodeId,
+) -> Result<Path, ResolverError> {
+    let (start_sym, goal_sym) = endpoints(graph, &start, &goal)?;
+    
+    match bidirectional_resolve_symbols(graph, start_sym, goal_sym) {
+        Some(path) => Ok(materialize(graph, &path)),
+        None => Err(ResolverError::NoPathFound { start, goal }),
+    }
+}
+
+/// Bidirectional search on interned handles
+/// 
+/// Returns None if `goal` is unreachable (or either handle is not a
+/// node of `graph`).
+pub fn bidirectional_resolve_symbols<G: GraphView>(
+    graph: &G,
+    start: Symbol,
+    goal: Symbol,
+) -> Option<SymbolPath> {
+    if !in_graph(graph, start) || !in_graph(graph, goal) {
+        return None;
+    }
+    let (indices, cost) = bidirectional_indexed(graph, start.into(), goal.into())?;
+    Some(symbol_path(&indices, cost))
+}
+
+/// Index-only bidirectional BFS engine
+/// 
+/// `dist_f` / `dist_b` double as the visited sets; `parents` links the
+/// forward tree toward start and `next_hop` the backward tree toward goal.
+fn bidirectional_indexed<G: GraphView>(
+    graph: &G,
+    start: NodeIndex,
+    goal: NodeIndex,
+) -> Option<(Vec<NodeIndex>, f64)> {
+    if start == goal {
+        return Some((vec![start], 0.0));
+    }
+    
+    let node_count = graph.node_count();
+    let mut dist_f = vec![u32::MAX; node_count];
+    let mut dist_b = vec![u32::MAX; node_count];
+    let mut parents = vec![NO_PARENT; node_count];
+    let mut next_hop = vec![NO_PARENT; node_count];
+    
+    dist_f[start.index()] = 0;
+    dist_b[goal.index()] = 0;
+    let mut frontier_f = vec![start];
+    let mut frontier_b = vec![goal];
+    let mut next_level = Vec::new();
+    
+    // Best (total cost, meeting node) seen so far
+    let mut best: Option<(u32, usize)> = None;
+    let mut stats = SearchStats::default();
+    
+    while best.is_none() && !frontier_f.is_empty() && !frontier_b.is_empty() {
+        let forward = frontier_f.len() <= frontier_b.len();
+        let (frontier, dist, other, links) = if forward {
+            (&mut frontier_f, &mut dist_f, &dist_b, &mut parents)
+        } else {
+            (&mut frontier_b, &mut dist_b, &dist_f, &mut next_hop)
+        };
+        
+        stats.expanded += frontier.len() as u64;
+        for &current in frontier.iter() {
+            let depth = dist[current.index()] + 1;
+            let mut visit = |neighbor: NodeIndex| {
+                let slot = neighbor.index();
+                if dist[slot] != u32::MAX {
+                    return;
+                }
+                dist[slot] = depth;
+                links[slot] = current.index();
+                next_level.push(neighbor);
+                
+                // Meeting: labeled by both searches
+                if other[slot] != u32::MAX {
+                    let total = depth + other[slot];
+                    if best.is_none_or(|(cost, _)| total < cost) {
+                        best = Some((total, slot));
+                    }
+                }
+            };
+            if forward {
+                graph.successors(current).for_each(&mut visit);
+            } else {
+                graph.predecessors(current).for_each(&mut visit);
+            }
+        }
+        
+        std::mem::swap(frontier, &mut next_level);
+        next_level.clear();
+    }
+    
+    stats.report();
+    let (cost, meet) = best?;
+    
+    // start ..= meet along forward parents, then meet .. goal along next hops
+    let mut path = reconstruct_path(&parents, NodeIndex::new(meet));
+    let mut slot = meet;
+    while slot != goal.index() {
+        slot = next_hop[slot];
+        path.push(NodeIndex::new(slot));
+    }
+    
+    Some((path, cost as f64))
+}
+
+/// Batch Many-to-One Resolution
+/// 
+/// Complexity: O(V + E) for all starts together, plus output size
+/// 
+/// Runs one reverse search from `goal` over incoming edges and reads
+/// every start's path off the shared successor tree. With uniform edge
+/// costs reverse Dijkstra degenerates to BFS; the search stops as soon
+/// as every known start has been settled.
+/// 
+/// Results are returned in the order of `starts`; each is the same
+/// shortest-path cost `astar_resolve` would report.
+pub fn resolve_batch<G: GraphView>(
+    graph: &G,
+    starts: &[NodeId],
+    goal: NodeId,
+) -> Result<Vec<Result<Path, ResolverError>>, ResolverError> {
+    let goal_sym = match graph.symbols().get(&goal) {
+        Some(sym) => sym,
+        None => return Err(ResolverError::NodeNotFound(goal)),
+    };
+    
+    let start_syms: Vec<Option<Symbol>> = starts.iter().map(|s| graph.symbols().get(s)).collect();
+    let known: Vec<Symbol> = start_syms.iter().flatten().copied().collect();
+    let mut paths = resolve_batch_symbols(graph, &known, goal_sym).into_iter();
+    
+    let results = starts
+        .iter()
+        .zip(&start_syms)
+        .map(|(start, sym)| match sym.map(|_| paths.next().flatten()) {
+            None => Err(ResolverError::NodeNotFound(start.clone())),
+            Some(None) => Err(ResolverError::NoPathFound {
+                start: start.clone(),
+                goal: goal.clone(),
+            }),
+            Some(Some(path)) => Ok(materialize(graph, &path)),
+        })
+        .collect();
+    
+    Ok(results)
+}
+
+/// Batch Many-to-One Resolution on interned handles
+/// 
+/// Engine behind `resolve_batch`; one entry per start, None where the
+/// goal is unreachable (or the handle is not a node of `graph`).
+pub fn resolve_batch_symbols<G: GraphView>(
+    graph: &G,
+    starts: &[Symbol],
+    goal: Symbol,
+) -> Vec<Option<SymbolPath>> {
+    if !in_graph(graph, goal) {
+        return vec![None; starts.len()];
+    }
+    
+    let node_count = graph.node_count();
+    let goal_slot = goal.index();
+    
+    // Starts still waiting to be reached by the reverse frontier
+    let mut pending = BitSet::new(node_count);
+    let mut remaining = 0usize;
+    for sym in starts.iter().filter(|&&sym| in_graph(graph, sym)) {
+        if !pending.contains(sym.index() as u32) {
+            pending.insert(sym.index() as u32);
+            remaining += 1;
+        }
+    }
+    
+    // Hop count to goal and next hop toward goal for each settled node
+    let mut dist = vec![u32::MAX; node_count];
+    let mut next_hop = vec![NO_PARENT; node_count];
+    let mut queue = VecDeque::new();
+    
+    dist[goal_slot] = 0;
+    queue.push_back(NodeIndex::from(goal));
+    
+    while let Some(current) = queue.pop_front() {
+        if pending.contains(current.index() as u32) {
+            pending.remove(current.index() as u32);
+            remaining -= 1;
+            if remaining == 0 {
+                break;
+            }
+        }
+        
+        for pred in graph.predecessors(current) {
+            let slot = pred.index();
+            if dist[slot] == u32::MAX {
+                dist[slot] = dist[current.index()] + 1;
+                next_hop[slot] = current.index();
+                queue.push_back(pred);
+            }
+        }
+    }
+    
+    starts
+        .iter()
+        .map(|&sym| {
+            let mut slot = sym.index();
+            if !in_graph(graph, sym) || dist[slot] == u32::MAX {
+                return None;
+            }
+            let mut nodes = Vec::with_capacity(dist[slot] as usize + 1);
+            let cost = dist[slot] as f64;
+            nodes.push(sym);
+            while slot != goal_slot {
+                slot = next_hop[slot];
+                nodes.push(Symbol::from(NodeIndex::new(slot)));
+            }
+            Some(SymbolPath { nodes, cost })
+        })
+        .collect()
+}
+
+/// Admissible heuristic for SemVerX versions
+/// 
+/// Returns minimum possible cost to reach goal
+/// Guarantees A* optimality
+/// 
+/// Versions are pre-parsed at insertion time, so this is a handful of
+/// integer ops: the weighted version distance scaled by the graph's
+/// per-edge span bound (0 when either node is unversioned).
+pub(super) fn heuristic<G: GraphView>(
+    graph: &G,
+    current: NodeIndex,
+    goal: Option<&SemVerX>,
+    scale: f64,
+) -> f64 {
+    match (graph.version(current), goal) {
+        (Some(a), Some(b)) => version_distance(a, b) as f64 * scale,
+        _ => 0.0,
+    }
+}
+
+/// Hybrid Strategy Resolver
+/// 
+/// Plans each request from the graph's structure (see `Planner`):
+/// 1. Provably unreachable pairs are answered in O(1), without a search
+/// 2. A* where the version heuristic can steer it, handing over to
+///    bidirectional BFS once it exceeds a node budget
+/// 3. Bidirectional BFS (optimal, O(b^(d/2))) otherwise
+/// 
+/// Both searches are complete, so nothing runs after one fails.
+pub fn resolve_hybrid<G: GraphView>(
+    graph: &G,
+    start: NodeId,
+    goal: NodeId,
+) -> Result<Path, ResolverError> {
+    resolve_hybrid_with(graph, start, goal, &HybridConfig::default())
+}
+
+/// Hybrid Strategy Resolver with explicit tuning
+/// 
+/// `config.bidirectional` picks the search where the graph statistics
+/// do not favour A*.
+pub fn resolve_hybrid_with<G: GraphView>(
+    graph: &G,
+    start: NodeId,
+    goal: NodeId,
+    config: &HybridConfig,
+) -> Result<Path, ResolverError> {
+    let (start_sym, goal_sym) = endpoints(graph, &start, &goal)?;
+    
+    match resolve_hybrid_symbols(graph, start_sym, goal_sym, config) {
+        Ok(path) => Ok(materialize(graph, &path)),
+        Err(Unresolved::Unreachable) => Err(ResolverError::NoPathFound { start, goal }),
+        Err(Unresolved::Failed(reason)) => Err(ResolverError::ResolutionFailed {
+            strategy: ResolutionStrategy::Hybrid,
+            reason: reason.to_string(),
+        }),
+    }
+}
+
+/// Hybrid Strategy Resolver on interned handles
+/// 
+/// Engine behind `resolve_hybrid_with`. A one-off `Planner` builds the
+/// O(V + E) graph statistics for this request; callers resolving many
+/// pairs should keep a `Planner` so they are built once per generation.
+/// Failures are always `Unresolved::Unreachable`.
+pub fn resolve_hybrid_symbols<G: GraphView>(
+    graph: &G,
+    start: Symbol,
+    goal: Symbol,
+    config: &HybridConfig,
+) -> Result<SymbolPath, Unresolved> {
+    Planner::new(config.clone()).resolve(graph, start, goal)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::resolver::graph::DependencyGraph;
+    
+    #[test]
+    fn test_eulerian_detection() {
+        let mut graph = DependencyGraph::new();
+        
+        // Create simple cycle: A -> B -> C -> A
+        let a = graph.add_node("A".to_string());
+        let b = graph.add_node("B".to_string());
+        let c = graph.add_node("C".to_string());
+        
+        graph.add_edge(&a, &b);
+        graph.add_edge(&b, &c);
+        graph.add_edge(&c, &a);
+        
+        assert!(is_eulerian(&graph), "Simple cycle should be Eulerian");
+        
+        // Isolated vertices do not matter, a second cycle does
+        let d = graph.add_node("D".to_string());
+        assert!(is_eulerian(&graph), "Isolated vertex keeps cycle Eulerian");
+        
+        let e = graph.add_node("E".to_string());
+        graph.add_edge(&d, &e);
+        assert!(!is_eulerian(&graph), "Dangling edge is imbalanced");
+        
+        graph.add_edge(&e, &d);
+        assert!(!is_eulerian(&graph), "Two disjoint cycles are not Eulerian");
+        
+        graph.add_edge(&a, &d);
+        graph.add_edge(&d, &a);
+        assert!(is_eulerian(&graph), "Joined cycles are Eulerian");
+    }
+    
+    #[test]
+    fn test_hamiltonian_small_graph() {
+        let mut graph = DependencyGraph::new();
+        
+        // Create path: A -> B -> C
+        let a = graph.add_node("A".to_string());
+        let b = graph.add_node("B".to_string());
+        let c = graph.add_node("C".to_string());
+        
+        graph.add_edge(&a, &b);
+        graph.add_edge(&b, &c);
+        
+        let timeout = Duration::from_secs(1);
+        let path = find_hamiltonian_path(&graph, timeout);
+        
+        assert!(path.is_some(), "Should find Hamiltonian path");
+        assert_eq!(path.unwrap().len(), 3, "Path should include all 3 nodes");
+    }
+    
+    #[test]
+    fn test_astar_optimal_path() {
+        let mut graph = DependencyGraph::new();
+        
+        // Create diamond graph to test optimality
+        let a = graph.add_node("1.0.0".to_string());
+        let b = graph.add_node("1.1.0".to_string());
+        let c = graph.add_node("1.2.0".to_string());
+        let d = graph.add_node("2.0.0".to_string());
+        
+        graph.add_edge(&a, &b);
+        graph.add_edge(&a, &c);
+        graph.add_edge(&b, &d);
+        graph.add_edge(&c, &d);
+        
+        let result = astar_resolve(&graph, a.clone(), d.clone());
+        assert!(result.is_ok(), "Should find path from A to D");
+        
+        let path = result.unwrap();
+        assert!(path.nodes.len() >= 2, "Path should have at least start and goal");
+        assert_eq!(path.cost, 2.0, "Diamond shortest path is two hops");
+    }
+    
+    #[test]
+    fn test_astar_reconstructs_chain_in_order() {
+        let mut graph = DependencyGraph::new();
+        
+        // Chain with a shortcut: v0 -> v1 -> v2 -> v3, v0 -> v2
+        let nodes: Vec<NodeId> = (0..4)
+            .map(|i| graph.add_node(format!("{}.0.0", i)))
+            .collect();
+        for pair in nodes.windows(2) {
+            graph.add_edge(&pair[0], &pair[1]);
+        }
+        graph.add_edge(&nodes[0], &nodes[2]);
+        
+        let path = astar_resolve(&graph, nodes[0].clone(), nodes[3].clone()).unwrap();
+        assert_eq!(path.nodes, vec![nodes[0].clone(), nodes[2].clone(), nodes[3].clone()]);
+        assert_eq!(path.cost, 2.0);
+    }
+    
+    #[test]
+    fn test_astar_optimal_with_version_heuristic() {
+        let mut graph = DependencyGraph::new();
+        
+        // 1.9.0 looks closest to the goal but needs three more hops
+        let start = graph.add_node("1.0.0".to_string());
+        let near = graph.add_node("1.9.0".to_string());
+        let near_a = graph.add_node("1.9.5".to_string());
+        let near_b = graph.add_node("1.9.9".to_string());
+        let far = graph.add_node("1.1.0".to_string());
+        let goal = graph.add_node("2.0.0".to_string());
+        
+        graph.add_edge(&start, &near);
+        graph.add_edge(&near, &near_a);
+        graph.add_edge(&near_a, &near_b);
+        graph.add_edge(&near_b, &goal);
+        graph.add_edge(&start, &far);
+        graph.add_edge(&far, &goal);
+        
+        let path = astar_resolve(&graph, start.clone(), goal.clone()).unwrap();
+        assert_eq!(path.nodes, vec![start, far, goal]);
+        assert_eq!(path.cost, 2.0);
+    }
+    
+    #[test]
+    fn test_batch_matches_astar() {
+        let mut graph = DependencyGraph::new();
+        
+        // Fan-in: several dependents at different depths upgrade to core 2.0.0
+        let goal = graph.add_node("core@2.0.0".to_string());
+        let mid = graph.add_node("core@1.9.0".to_string());
+        let direct = graph.add_node("app@1.0.0".to_string());
+        let deep = graph.add_node("cli@0.1.0".to_string());
+        let island = graph.add_node("solo@1.0.0".to_string());
+        
+        graph.add_edge(&mid, &goal);
+        graph.add_edge(&direct, &goal);
+        graph.add_edge(&deep, &mid);
+        graph.add_edge(&deep, &direct);
+        
+        let starts = vec![deep.clone(), direct.clone(), island.clone(), "ghost@0.0.1".to_string()];
+        let results = resolve_batch(&graph, &starts, goal.clone()).unwrap();
+        
+        for (start, result) in starts.iter().zip(&results).take(2) {
+            let expected = astar_resolve(&graph, start.clone(), goal.clone()).unwrap();
+            let path = result.as_ref().unwrap();
+            assert_eq!(path.cost, expected.cost);
+            assert_eq!(path.nodes.first(), Some(start));
+            assert_eq!(path.nodes.last(), Some(&goal));
+        }
+        assert!(matches!(results[2], Err(ResolverError::NoPathFound { .. })));
+        assert!(matches!(results[3], Err(ResolverError::NodeNotFound(_))));
+        
+        assert!(resolve_batch(&graph, &starts, "ghost@9.9.9".to_string()).is_err());
+    }
+    
+    #[test]
+    fn test_astar_unknown_and_unreachable() {
+        let mut graph = DependencyGraph::new();
+        
+        let a = graph.add_node("1.0.0".to_string());
+        let b = graph.add_node("2.0.0".to_string());
+        
+        assert!(matches!(
+            astar_resolve(&graph, a.clone(), "9.9.9".to_string()),
+            Err(ResolverError::NodeNotFound(_))
+        ));
+        assert!(matches!(
+            astar_resolve(&graph, a, b),
+            Err(ResolverError::NoPathFound { .. })
+        ));
+    }
+    
+    #[test]
+    fn test_hybrid_strategy() {
+        let mut graph = DependencyGraph::new();
+        
+        let a = graph.add_node("1.0.0".to_string());
+        let b = graph.add_node("1.1.0".to_string());
+        graph.add_edge(&a, &b);
+        
+        let result = resolve_hybrid(&graph, a.clone(), b.clone());
+        assert!(result.is_ok(), "Hybrid should resolve simple path");
+        
+        let config = HybridConfig {
+            bidirectional: false,
+        };
+        let result = resolve_hybrid_with(&graph, b.clone(), a.clone(), &config);
+        assert!(result.is_err(), "Reverse direction is unreachable");
+    }
+    
+    #[cfg(feature = "profiling")]
+    #[test]
+    fn test_hybrid_records_strategy_and_expansions() {
+        use crate::audit::plpprofiler::hintl;
+        
+        let mut graph = DependencyGraph::new();
+        let nodes: Vec<NodeId> = (0..4).map(|i| graph.add_node(format!("1.{}.0", i))).collect();
+        for pair in nodes.windows(2) {
+            graph.add_edge(&pair[0], &pair[1]);
+        }
+        
+        let calls = |probe: Probe| hintl::local()[probe as usize].calls;
+        let sums = |probe: Probe| hintl::local()[probe as usize].sum;
+        let (shortest, pruned, expanded) =
+            (calls(Probe::HybridShortest), calls(Probe::HybridPruned), sums(Probe::NodesExpanded));
+        
+        assert!(resolve_hybrid(&graph, nodes[0].clone(), nodes[3].clone()).is_ok());
+        assert!(resolve_hybrid(&graph, nodes[3].clone(), nodes[0].clone()).is_err());
+        assert_eq!(calls(Probe::HybridShortest), shortest + 1);
+        assert_eq!(calls(Probe::HybridPruned), pruned + 1);
+        assert!(sums(Probe::NodesExpanded) > expanded);
+    }
+    
+    #[test]
+    fn test_hamiltonian_parallel_matches_serial() {
+        let mut graph = DependencyGraph::new();
+        
+        // Ring of 32 nodes: too large for Held-Karp, one path per start
+        let nodes: Vec<NodeId> = (0..32)
+            .map(|i| graph.add_node(format!("1.{}.0", i)))
+            .collect();
+        for i in 0..nodes.len() {
+            graph.add_edge(&nodes[i], &nodes[(i + 1) % nodes.len()]);
+        }
+        
+        let timeout = Duration::from_secs(1);
+        let serial = find_hamiltonian_path(&graph, timeout).unwrap();
+        let parallel = find_hamiltonian_path_parallel(&graph, timeout).unwrap();
+        assert_eq!(serial.len(), 32);
+        assert_eq!(parallel.len(), 32);
+        
+        let between = find_hamiltonian_path_between_parallel(&graph, &nodes[3], &nodes[2], timeout)
+            .unwrap();
+        assert_eq!(between.first(), Some(&nodes[3]));
+        assert_eq!(between.last(), Some(&nodes[2]));
+    }
+    
+    #[test]
+    fn test_symbol_api_matches_string_api() {
+        let mut graph = DependencyGraph::new();
+        
+        let a = graph.add_symbol("app@1.0.0");
+        let b = graph.add_symbol("core@1.5.0");
+        let c = graph.add_symbol("core@2.0.0");
+        assert!(graph.add_edge_symbols(a, b));
+        assert!(graph.add_edge_symbols(b, c));
+        
+        let sym_path = astar_resolve_symbols(&graph, a, c).unwrap();
+        assert_eq!(sym_path.nodes, vec![a, b, c]);
+        
+        let path = astar_resolve(&graph, "app@1.0.0".to_string(), "core@2.0.0".to_string()).unwrap();
+        assert_eq!(materialize(&graph, &sym_path), path);
+        
+        let batch = resolve_batch_symbols(&graph, &[b, c, a], a);
+        assert_eq!(batch, vec![None, None, Some(SymbolPath { nodes: vec![a], cost: 0.0 })]);
+        assert_eq!(
+            resolve_hybrid_symbols(&graph, c, a, &HybridConfig::default()),
+            Err(Unresolved::Unreachable)
+        );
+    }
+    
+    #[test]
+    fn test_astar_budget_counts_expansions() {
+        let mut graph = DependencyGraph::new();
+        let nodes: Vec<Symbol> = (0..4).map(|i| graph.add_symbol(&format!("1.{}.0", i))).collect();
+        for pair in nodes.windows(2) {
+            graph.add_edge_symbols(pair[0], pair[1]);
+        }
+        
+        assert_eq!(astar_within(&graph, nodes[0], nodes[3], 3), Err(OverBudget));
+        assert_eq!(astar_within(&graph, nodes[0], nodes[3], 4).unwrap().unwrap().cost, 3.0);
+        assert_eq!(astar_within(&graph, nodes[3], nodes[0], 1), Ok(None));
+    }
+    
+    #[test]
+    fn test_bidirectional_matches_astar_costs() {
+        let mut graph = DependencyGraph::new();
+        
+        // Layered graph with skip edges and a back edge, every pair compared
+        let nodes: Vec<NodeId> = (0..12)
+            .map(|i| graph.add_node(format!("{}.{}.0", i / 3, i % 3)))
+            .collect();
+        for i in 0..nodes.len() {
+            for step in [1, 3, 5] {
+                if i + step < nodes.len() {
+                    graph.add_edge(&nodes[i], &nodes[i + step]);
+                }
+            }
+        }
+        graph.add_edge(&nodes[9], &nodes[2]);
+        
+        for a in &nodes {
+            for b in &nodes {
+                let one_sided = astar_resolve(&graph, a.clone(), b.clone());
+                let two_sided = bidirectional_resolve(&graph, a.clone(), b.clone());
+                match (one_sided, two_sided) {
+                    (Ok(x), Ok(y)) => {
+                        assert_eq!(x.cost, y.cost, "{} -> {}", a, b);
+                        assert_eq!(y.nodes.len() as f64, y.cost + 1.0);
+                        assert_eq!((y.nodes.first(), y.nodes.last()), (Some(a), Some(b)));
+                        for hop in y.nodes.windows(2) {
+                            let u = graph.find_node(&hop[0]).unwrap();
+                            let v = graph.find_node(&hop[1]).unwrap();
+                            assert!(graph.successors(u).any(|w| w == v));
+                        }
+                    }
+                    (Err(_), Err(_)) => {}
+                    (x, y) => panic!("{} -> {}: {:?} vs {:?}", a, b, x, y),
+                }
+            }
+        }
+    }
+}
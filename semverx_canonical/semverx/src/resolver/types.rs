@@ -0,0 +1,68 @@
+// src/resolver/types.rs
+// Shared resolver types: node identifiers, paths, strategy tags and tuning
+
+use super::intern::Symbol;
+
+/// Package node identifier, e.g. `"lodash@4.17.21(stable)"` or `"1.2.0"`
+pub type NodeId = String;
+
+/// Resolved dependency path from start to goal
+#[derive(Debug, Clone, PartialEq)]
+pub struct Path {
+    /// Node ids from start to goal, both included
+    pub nodes: Vec<NodeId>,
+    /// Path cost; edges cost 1, so this is `nodes.len() - 1`
+    pub cost: f64,
+}
+
+/// Resolved path as interned handles
+///
+/// What the strategies produce internally and what handle-level callers
+/// get back; `strategies::materialize` turns it into a `Path`.
+#[derive(Debug, Clone, PartialEq)]
+pub struct SymbolPath {
+    /// Handles from start to goal, both included
+    pub nodes: Vec<Symbol>,
+    /// Path cost, as in `Path::cost`
+    pub cost: f64,
+}
+
+/// Why a handle-level resolution produced no path
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Unresolved {
+    /// Goal is not reachable from start (`ResolverError::NoPathFound`)
+    Unreachable,
+    /// Strategy gave up (`ResolverError::ResolutionFailed`)
+    Failed(&'static str),
+}
+
+/// Resolution strategy tag used in diagnostics
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum ResolutionStrategy {
+    /// Shortest path, only on graphs with an Eulerian cycle
+    Eulerian,
+    /// Start-goal path through every node of the start's SCC
+    Hamiltonian,
+    /// A* with the version heuristic
+    AStar,
+    /// Bidirectional BFS
+    Bidirectional,
+    /// Planned per request, see `Planner`
+    Hybrid,
+}
+
+/// Tuning knobs for `resolve_hybrid_with` and `Planner`
+#[derive(Debug, Clone, PartialEq)]
+pub struct HybridConfig {
+    /// Where the graph statistics do not favour A*, search with
+    /// bidirectional BFS (default) instead of one-sided A*
+    pub bidirectional: bool,
+}
+
+impl Default for HybridConfig {
+    fn default() -> Self {
+        Self {
+            bidirectional: true,
+        }
+    }
+}